@@ -0,0 +1,374 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "XMLTree.h"
+#include "XMLBinary.h"
+#include "XMLFlat.h"
+#include "XMLExtract.h"
+#include "XMLInput.h"
+
+// Benchmark:
+//   1. Thời gian khởi động: phân tích lại file XML văn bản so với mmap file nhị phân.
+//   2. Duyệt cây: cây con trỏ (TreeNode) so với cây phẳng (FlatXMLTree).
+//   3. Kiểm tra lại sau khi sửa: kiểm tra toàn bộ cây so với kiểm tra tăng dần chỉ các cây con bị sửa.
+//   4. Thuộc tính: chi phí tra cứu/sửa một thuộc tính trên phần tử có 4, 64, 512 thuộc tính.
+//   5. Trích xuất bản ghi: trích xuất theo luồng (CSV, cột nhị phân) so với dựng toàn bộ cây.
+//   6. Đầu vào cho kiểm tra hợp lệ: đọc cả file vào heap, mmap tại chỗ, đọc theo khối từ pipe.
+// Cách dùng: ./xml_bench [số bản ghi] [số lần lặp]
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static long file_size(const char* filename) {
+    struct stat st;
+    return stat(filename, &st) == 0 ? (long)st.st_size : -1;
+}
+
+// Sinh file cấu hình giả lập gồm nhiều bản ghi có thuộc tính và nội dung
+static int generate_config(const char* filename, int records) {
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) return 0;
+    fprintf(file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<config version=\"2\">\n");
+    for (int i = 0; i < records; i++) {
+        fprintf(file, "    <entry id=\"e%d\" group=\"g%d\" enabled=\"%s\">\n", i, i % 16, i % 3 ? "true" : "false");
+        fprintf(file, "        <name>option_%d</name>\n", i);
+        fprintf(file, "        <value type=\"int\">%d</value>\n", i * 7);
+        fprintf(file, "        <description>Mô tả cho tuỳ chọn số %d</description>\n", i);
+        fprintf(file, "    </entry>\n");
+    }
+    fprintf(file, "</config>\n");
+    return fclose(file) == 0;
+}
+
+// Duyệt toàn bộ cây con trỏ, đọc mọi thuộc tính và text
+static size_t touch_tree(TreeNode* node) {
+    size_t sum = 0;
+    for (; node != NULL; node = node->next_sibling) {
+        sum += node->tag_name[0];
+        if (node->text) sum += node->text[0];
+        for (size_t i = 0; i < attribute_count(node); i++) sum += attribute_at(node, i)->value[0];
+        sum += touch_tree(node->first_child);
+    }
+    return sum;
+}
+
+// Duyệt toàn bộ mảng node nhị phân, đọc mọi thuộc tính và text
+static size_t touch_binary(const XMLBinaryDocument* doc) {
+    size_t sum = 0;
+    for (uint32_t i = 0; i < doc->header->node_count; i++) {
+        const XMLBNode* node = &doc->nodes[i];
+        sum += xmlb_string(doc, node->tag_name)[0];
+        if (node->text != XMLB_NONE) sum += xmlb_string(doc, node->text)[0];
+        for (uint32_t a = 0; a < node->attribute_count; a++) {
+            sum += xmlb_string(doc, doc->attributes[node->first_attribute + a].value)[0];
+        }
+    }
+    return sum;
+}
+
+// Tìm thẻ theo chiều sâu trên cây con trỏ (giống search_and_print_tag nhưng không in)
+static TreeNode* tree_find_tag(TreeNode* node, const char* tag_name) {
+    for (; node != NULL; node = node->next_sibling) {
+        if (strcmp(node->tag_name, tag_name) == 0) return node;
+        TreeNode* found = tree_find_tag(node->first_child, tag_name);
+        if (found != NULL) return found;
+    }
+    return NULL;
+}
+
+static size_t tree_count_tag(TreeNode* node, const char* tag_name) {
+    size_t count = 0;
+    for (; node != NULL; node = node->next_sibling) {
+        if (strcmp(node->tag_name, tag_name) == 0) count++;
+        count += tree_count_tag(node->first_child, tag_name);
+    }
+    return count;
+}
+
+static const char* tree_get_attribute(TreeNode* node, const char* attr_name) {
+    Attribute* attr = find_attribute(node, attr_name);
+    return attr ? attr->value : NULL;
+}
+
+// Lọc các bản ghi theo thuộc tính rồi đếm hậu duệ trong cây con của bản ghi khớp
+static size_t tree_filter_records(TreeNode* root) {
+    size_t count = 0;
+    for (TreeNode* entry = root->first_child; entry != NULL; entry = entry->next_sibling) {
+        const char* group = tree_get_attribute(entry, "group");
+        if (group != NULL && strcmp(group, "g3") == 0) count += tree_count_tag(entry->first_child, "value");
+    }
+    return count;
+}
+
+static size_t flat_filter_records(const FlatXMLTree* tree) {
+    size_t count = 0;
+    for (uint32_t entry = flat_first_child(tree, 0); entry != FLAT_NONE; entry = flat_next_sibling(tree, entry)) {
+        const char* group = flat_get_attribute(tree, entry, "group");
+        if (group != NULL && strcmp(group, "g3") == 0) count += flat_count_tag(tree, entry, "value");
+    }
+    return count;
+}
+
+static void bench_startup(const char* text_file, const char* binary_file, int iterations) {
+    size_t checksum = 0;
+    double parse_ms = 0, parse_touch_ms = 0, open_ms = 0, open_touch_ms = 0;
+    for (int i = 0; i < iterations; i++) {
+        double start = now_ms();
+        TreeNode* root = parse_xml_file(text_file);
+        double parsed = now_ms();
+        checksum += touch_tree(root);
+        double touched = now_ms();
+        delete_tag(root);
+        parse_ms += parsed - start;
+        parse_touch_ms += touched - start;
+
+        start = now_ms();
+        XMLBinaryDocument* doc = open_xml_binary(binary_file);
+        double opened = now_ms();
+        checksum += touch_binary(doc);
+        touched = now_ms();
+        close_xml_binary(doc);
+        open_ms += opened - start;
+        open_touch_ms += touched - start;
+    }
+
+    printf("%-28s %12s %20s\n", "Cách nạp", "Khởi động (ms)", "Khởi động+duyệt (ms)");
+    printf("%-28s %12.3f %20.3f\n", "parse_xml_file (văn bản)", parse_ms / iterations, parse_touch_ms / iterations);
+    printf("%-28s %12.3f %20.3f\n", "open_xml_binary (mmap)", open_ms / iterations, open_touch_ms / iterations);
+    printf("checksum: %zu\n\n", checksum);
+}
+
+static void bench_traversal(TreeNode* root, int iterations) {
+    FlatXMLTree* flat = flatten_xml_tree(root);
+    if (flat == NULL) return;
+
+    size_t checksum = 0;
+    double tree_scan = 0, flat_scan = 0, tree_filter = 0, flat_filter = 0;
+    for (int i = 0; i < iterations; i++) {
+        // Tìm một thẻ không tồn tại: buộc phải duyệt toàn bộ cây
+        double start = now_ms();
+        checksum += tree_find_tag(root, "missing") != NULL;
+        double mid = now_ms();
+        checksum += flat_find_tag(flat, 0, "missing") != FLAT_NONE;
+        double end = now_ms();
+        tree_scan += mid - start;
+        flat_scan += end - mid;
+
+        // Lọc bản ghi theo thuộc tính, chỉ đi vào cây con của bản ghi khớp
+        start = now_ms();
+        checksum += tree_filter_records(root);
+        mid = now_ms();
+        checksum += flat_filter_records(flat);
+        end = now_ms();
+        tree_filter += mid - start;
+        flat_filter += end - mid;
+    }
+
+    printf("%-28s %16s %20s\n", "Cấu trúc cây", "Duyệt toàn bộ (ms)", "Lọc + bỏ cây con (ms)");
+    printf("%-28s %16.3f %20.3f\n", "TreeNode (con trỏ)", tree_scan / iterations, tree_filter / iterations);
+    printf("%-28s %16.3f %20.3f\n", "FlatXMLTree (mảng phẳng)", flat_scan / iterations, flat_filter / iterations);
+    printf("checksum: %zu\n\n", checksum);
+    free_flat_xml_tree(flat);
+}
+
+static void bench_revalidation(TreeNode* root, int iterations) {
+    size_t entry_count = 0;
+    for (TreeNode* entry = root->first_child; entry != NULL; entry = entry->next_sibling) entry_count++;
+    TreeNode** entries = (TreeNode**)malloc(entry_count * sizeof(TreeNode*));
+    if (entries == NULL) return;
+    size_t k = 0;
+    for (TreeNode* entry = root->first_child; entry != NULL; entry = entry->next_sibling) entries[k++] = entry;
+
+    // Lần đầu mọi node đều bị đánh dấu nên phải kiểm tra toàn bộ cây
+    double start = now_ms();
+    int valid = revalidate_xml_tree(root);
+    double full_ms = now_ms() - start;
+
+    // Mỗi lần sửa một thuộc tính ở bản ghi ngẫu nhiên rồi kiểm tra lại
+    int edits = iterations * 1000;
+    unsigned int seed = 12345;
+    start = now_ms();
+    for (int i = 0; i < edits; i++) {
+        seed = seed * 1103515245u + 12345u;
+        TreeNode* entry = entries[(seed >> 8) % entry_count];
+        change_attribute(entry, "enabled", (i & 1) ? "true" : "false");
+        valid &= revalidate_xml_tree(root);
+    }
+    double incremental_ms = (now_ms() - start) / edits;
+
+    printf("%-28s %16s\n", "Kiểm tra sau khi sửa", "Mỗi lần (ms)");
+    printf("%-28s %16.4f\n", "Toàn bộ cây", full_ms);
+    printf("%-28s %16.4f\n", "Tăng dần (cây con bị sửa)", incremental_ms);
+    printf("hợp lệ: %d, số lần sửa: %d\n\n", valid, edits);
+    free(entries);
+}
+
+// Phần tử có nhiều thuộc tính: đo chi phí tra cứu và sửa một thuộc tính theo số thuộc tính của phần tử
+static void bench_wide_attributes(int iterations) {
+    static const int widths[] = {4, 64, 512};
+    char name[32], value[32];
+    printf("%-28s %16s %20s\n", "Số thuộc tính", "Tra cứu (ns/lần)", "Sửa (ns/lần)");
+    for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+        TreeNode* node = create_node("item");
+        if (node == NULL) return;
+        for (int i = 0; i < widths[w]; i++) {
+            snprintf(name, sizeof(name), "attr%d", i);
+            snprintf(value, sizeof(value), "v%d", i);
+            add_attribute(node, name, value);
+        }
+
+        int ops = iterations * 100000;
+        size_t checksum = 0;
+        unsigned int seed = 12345;
+        double start = now_ms();
+        for (int i = 0; i < ops; i++) {
+            seed = seed * 1103515245u + 12345u;
+            snprintf(name, sizeof(name), "attr%u", (seed >> 8) % widths[w]);
+            Attribute* attr = find_attribute(node, name);
+            checksum += attr ? attr->value[0] : 0;
+        }
+        double lookup_ns = (now_ms() - start) * 1e6 / ops;
+
+        start = now_ms();
+        for (int i = 0; i < ops; i++) {
+            seed = seed * 1103515245u + 12345u;
+            snprintf(name, sizeof(name), "attr%u", (seed >> 8) % widths[w]);
+            change_attribute(node, name, (i & 1) ? "x" : "y");
+        }
+        double update_ns = (now_ms() - start) * 1e6 / ops;
+
+        printf("%-28d %16.1f %20.1f\n", widths[w], lookup_ns, update_ns);
+        if (checksum == 0) printf("checksum: 0\n");
+        delete_tag(node);
+    }
+    printf("\n");
+}
+
+static void bench_extraction(const char* text_file, int iterations) {
+    const char* fields[] = {"@id", "@group", "name", "value", "value/@type"};
+    char output_file[64];
+    snprintf(output_file, sizeof(output_file), "/tmp/xml_bench_%d.out", (int)getpid());
+
+    XMLExtractStats csv = {0, 0, 0, 0}, columnar = {0, 0, 0, 0};
+    double csv_ms = 0, columnar_ms = 0, parse_ms = 0;
+    int ok = 1;
+    for (int i = 0; ok && i < iterations; i++) {
+        ok = extract_xml_records(text_file, "config/entry", fields, 5, XML_EXTRACT_CSV, output_file, &csv);
+        csv_ms += csv.elapsed_ms;
+        ok = ok && extract_xml_records(text_file, "config/entry", fields, 5, XML_EXTRACT_COLUMNAR, output_file, &columnar);
+        columnar_ms += columnar.elapsed_ms;
+
+        double start = now_ms();
+        TreeNode* root = parse_xml_file(text_file);
+        parse_ms += now_ms() - start;
+        delete_tag(root);
+    }
+    remove(output_file);
+    if (!ok) return;
+
+    double mb = csv.bytes_read / 1e6;
+    printf("%-28s %12s %12s %16s\n", "Trích xuất", "Mỗi lần (ms)", "MB/s", "Buffer (bytes)");
+    printf("%-28s %12.3f %12.1f %16zu\n", "Luồng -> CSV", csv_ms / iterations, mb * 1e3 * iterations / csv_ms, csv.peak_buffer);
+    printf("%-28s %12.3f %12.1f %16zu\n", "Luồng -> cột nhị phân", columnar_ms / iterations,
+           mb * 1e3 * iterations / columnar_ms, columnar.peak_buffer);
+    printf("%-28s %12.3f %12.1f %16s\n", "parse_xml_file (cả cây)", parse_ms / iterations, mb * 1e3 * iterations / parse_ms, "cả file");
+    printf("bản ghi: %zu\n\n", csv.records);
+}
+
+// Kiểm tra hợp lệ qua XMLInput; pipe được tạo bằng popen và mở qua /dev/fd để đi theo nhánh đọc theo khối
+static int validate_input(const char* filename, int use_pipe, size_t* buffer_bytes) {
+    FILE* pipe = NULL;
+    char path[256];
+    if (use_pipe) {
+        snprintf(path, sizeof(path), "cat %s", filename);
+        pipe = popen(path, "r");
+        if (pipe == NULL) return 0;
+        snprintf(path, sizeof(path), "/dev/fd/%d", fileno(pipe));
+        filename = path;
+    }
+    XMLInput* input = open_xml_input(filename);
+    int valid = input != NULL && is_valid_xml_input(input);
+    if (input != NULL) *buffer_bytes = input->mapped ? 0 : input->capacity;
+    close_xml_input(input);
+    if (pipe != NULL) pclose(pipe);
+    return valid;
+}
+
+static void bench_input(const char* text_file, int iterations) {
+    double copy_ms = 0, mmap_ms = 0, pipe_ms = 0;
+    size_t mmap_buffer = 0, pipe_buffer = 0;
+    int valid = 1;
+    for (int i = 0; i < iterations; i++) {
+        double start = now_ms();
+        size_t length = 0;
+        char* buffer = read_xml_file(text_file, &length);
+        valid &= buffer != NULL && is_valid_xml_buffer(buffer, length);
+        free(buffer);
+        copy_ms += now_ms() - start;
+
+        start = now_ms();
+        valid &= validate_input(text_file, 0, &mmap_buffer);
+        mmap_ms += now_ms() - start;
+
+        start = now_ms();
+        valid &= validate_input(text_file, 1, &pipe_buffer);
+        pipe_ms += now_ms() - start;
+    }
+
+    long size = file_size(text_file);
+    printf("%-28s %12s %16s\n", "Đầu vào kiểm tra hợp lệ", "Mỗi lần (ms)", "Buffer (bytes)");
+    printf("%-28s %12.3f %16ld\n", "read_xml_file (sao chép)", copy_ms / iterations, size);
+    printf("%-28s %12.3f %16zu\n", "XMLInput mmap", mmap_ms / iterations, mmap_buffer);
+    printf("%-28s %12.3f %16zu\n", "XMLInput pipe (theo khối)", pipe_ms / iterations, pipe_buffer);
+    printf("hợp lệ: %d\n\n", valid);
+}
+
+int main(int argc, char** argv) {
+    int records = argc > 1 ? atoi(argv[1]) : 50000;
+    int iterations = argc > 2 ? atoi(argv[2]) : 10;
+    if (records <= 0 || iterations <= 0) {
+        printf("Cách dùng: %s [số bản ghi] [số lần lặp]\n", argv[0]);
+        return 1;
+    }
+
+    char text_file[64], binary_file[64];
+    snprintf(text_file, sizeof(text_file), "/tmp/xml_bench_%d.xml", (int)getpid());
+    snprintf(binary_file, sizeof(binary_file), "/tmp/xml_bench_%d.xmlb", (int)getpid());
+
+    if (!generate_config(text_file, records)) {
+        printf("[xml_bench] Không thể tạo file thử nghiệm.\n");
+        return 1;
+    }
+    TreeNode* root = parse_xml_file(text_file);
+    if (root == NULL || !write_xml_binary(binary_file, root)) {
+        printf("[xml_bench] Không thể tạo file nhị phân.\n");
+        delete_tag(root);
+        return 1;
+    }
+    delete_tag(root);
+
+    printf("Bản ghi: %d | XML: %ld bytes | XMLB: %ld bytes | Lặp: %d\n\n",
+           records, file_size(text_file), file_size(binary_file), iterations);
+
+    bench_startup(text_file, binary_file, iterations);
+
+    root = parse_xml_file(text_file);
+    if (root != NULL) {
+        bench_traversal(root, iterations);
+        bench_revalidation(root, iterations);
+        delete_tag(root);
+    }
+    bench_wide_attributes(iterations);
+    bench_extraction(text_file, iterations);
+    bench_input(text_file, iterations);
+
+    remove(text_file);
+    remove(binary_file);
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <malloc.h>
+#include "XMLTree.h"
+
+// Benchmark theo hình dạng tài liệu XML giả lập:
+//   deep  - nhiều chuỗi thẻ lồng nhau sâu
+//   wide  - một thẻ gốc có rất nhiều con
+//   attrs - mỗi thẻ có nhiều thuộc tính
+//   text  - thẻ chứa đoạn text dài
+// Với mỗi hình dạng đo thông lượng kiểm tra hợp lệ, dựng cây, tìm kiếm, ghi file và bộ nhớ cây chiếm dùng.
+// Cách dùng: ./xml_shapes [kích thước mỗi tài liệu (MB)] [số lần lặp]
+
+#define DEEP_LEVELS 256
+#define ATTRS_PER_TAG 32
+#define TEXT_LENGTH 4096
+
+typedef struct Buffer {
+    char* data;
+    size_t length;
+    size_t capacity;
+} Buffer;
+
+static void buffer_append(Buffer* buffer, const char* s, size_t n) {
+    if (buffer->length + n + 1 > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : 1 << 20;
+        while (capacity < buffer->length + n + 1) capacity *= 2;
+        char* data = (char*)realloc(buffer->data, capacity);
+        if (data == NULL) {
+            printf("[xml_shapes] Lỗi cấp phát bộ nhớ.\n");
+            exit(1);
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->length, s, n);
+    buffer->length += n;
+    buffer->data[buffer->length] = '\0';
+}
+
+static void buffer_printf(Buffer* buffer, const char* format, int value) {
+    char line[256];
+    int n = snprintf(line, sizeof(line), format, value);
+    buffer_append(buffer, line, (size_t)n);
+}
+
+static void generate_deep(Buffer* out, size_t target) {
+    buffer_append(out, "<root>\n", 7);
+    for (int chain = 0; out->length < target; chain++) {
+        for (int i = 0; i < DEEP_LEVELS; i++) buffer_printf(out, "<level%d>", i);
+        buffer_printf(out, "leaf %d", chain);
+        for (int i = DEEP_LEVELS - 1; i >= 0; i--) buffer_printf(out, "</level%d>", i);
+        buffer_append(out, "\n", 1);
+    }
+    buffer_append(out, "</root>\n", 8);
+}
+
+static void generate_wide(Buffer* out, size_t target) {
+    buffer_append(out, "<root>\n", 7);
+    for (int i = 0; out->length < target; i++) buffer_printf(out, "  <item>value %d</item>\n", i);
+    buffer_append(out, "</root>\n", 8);
+}
+
+static void generate_attrs(Buffer* out, size_t target) {
+    buffer_append(out, "<root>\n", 7);
+    for (int i = 0; out->length < target; i++) {
+        buffer_append(out, "  <item", 7);
+        for (int a = 0; a < ATTRS_PER_TAG; a++) buffer_printf(out, " attr%d=\"value\"", a);
+        buffer_printf(out, " id=\"%d\"/>\n", i);
+    }
+    buffer_append(out, "</root>\n", 8);
+}
+
+static void generate_text(Buffer* out, size_t target) {
+    char text[TEXT_LENGTH + 1];
+    for (int i = 0; i < TEXT_LENGTH; i++) text[i] = (i % 7 == 6) ? ' ' : (char)('a' + i % 26);
+    text[TEXT_LENGTH] = '\0';
+    buffer_append(out, "<root>\n", 7);
+    while (out->length < target) {
+        buffer_append(out, "  <para>", 8);
+        buffer_append(out, text, TEXT_LENGTH);
+        buffer_append(out, "</para>\n", 8);
+    }
+    buffer_append(out, "</root>\n", 8);
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Số byte heap đang được cấp phát (glibc)
+static size_t heap_in_use(void) {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+// Tìm thẻ không tồn tại: buộc phải duyệt toàn bộ cây
+static size_t search_missing(TreeNode* root) {
+    size_t visited = 0;
+    int depth = 0;
+    for (TreeNode* node = root; node != NULL; node = next_preorder_node(node, root, &depth)) {
+        visited++;
+        if (strcmp(node->tag_name, "missing") == 0) break;
+    }
+    return visited;
+}
+
+static void bench_shape(const char* name, void (*generate)(Buffer*, size_t), size_t target, int iterations,
+                        const char* output_file) {
+    Buffer input = {NULL, 0, 0};
+    generate(&input, target);
+    double mb = input.length / 1e6;
+
+    double validate_ms = 0, parse_ms = 0, search_ms = 0, write_ms = 0;
+    size_t dom_bytes = 0, nodes = 0;
+    long written = 0;
+    int valid = 1;
+    for (int i = 0; i < iterations; i++) {
+        double start = now_ms();
+        valid &= is_valid_xml_buffer(input.data, input.length);
+        validate_ms += now_ms() - start;
+
+        size_t heap_before = heap_in_use();
+        start = now_ms();
+        TreeNode* root = parse_xml_buffer(input.data, input.length);
+        parse_ms += now_ms() - start;
+        if (root == NULL) {
+            valid = 0;
+            break;
+        }
+        dom_bytes = heap_in_use() - heap_before;
+
+        start = now_ms();
+        nodes = search_missing(root);
+        search_ms += now_ms() - start;
+
+        FILE* file = fopen(output_file, "w");
+        if (file != NULL) {
+            start = now_ms();
+            write_tag(file, root, 0);
+            written = ftell(file);
+            fclose(file);
+            write_ms += now_ms() - start;
+        }
+        delete_tag(root);
+    }
+
+    printf("%-6s %8.1f %10zu %12.1f %12.1f %12.3f %12.1f %10.1f %6.2f %s\n", name, mb, nodes,
+           mb * 1e3 * iterations / validate_ms, mb * 1e3 * iterations / parse_ms, search_ms / iterations,
+           written / 1e3 * iterations / write_ms, dom_bytes / 1e6, dom_bytes / (double)input.length,
+           valid ? "" : "(lỗi)");
+    free(input.data);
+}
+
+int main(int argc, char** argv) {
+    double size_mb = argc > 1 ? atof(argv[1]) : 8;
+    int iterations = argc > 2 ? atoi(argv[2]) : 3;
+    if (size_mb <= 0 || iterations <= 0) {
+        printf("Cách dùng: %s [kích thước mỗi tài liệu (MB)] [số lần lặp]\n", argv[0]);
+        return 1;
+    }
+    size_t target = (size_t)(size_mb * 1e6);
+
+    char output_file[64];
+    snprintf(output_file, sizeof(output_file), "/tmp/xml_shapes_%d.xml", (int)getpid());
+
+    printf("%-6s %8s %10s %12s %12s %12s %12s %10s %6s\n", "Dạng", "MB", "Node", "Kiểm tra MB/s",
+           "Dựng cây MB/s", "Tìm (ms)", "Ghi MB/s", "Cây (MB)", "x đầu vào");
+    bench_shape("deep", generate_deep, target, iterations, output_file);
+    bench_shape("wide", generate_wide, target, iterations, output_file);
+    bench_shape("attrs", generate_attrs, target, iterations, output_file);
+    bench_shape("text", generate_text, target, iterations, output_file);
+
+    remove(output_file);
+    return 0;
+}
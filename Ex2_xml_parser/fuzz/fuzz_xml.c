@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "XMLTree.h"
+#include "XMLFlat.h"
+
+// Điểm vào cho libFuzzer: chạy bộ kiểm tra hợp lệ và bộ phân tích trên dữ liệu ngẫu nhiên rồi kiểm tra các bất biến:
+//   - kiểm tra tuần tự và kiểm tra song song cho cùng kết quả (phần nhỏ nhất chỉ vài chục byte để đầu vào ngắn
+//     cũng bị chia tại find_safe_boundary và đi qua bước gộp),
+//   - cây phẳng có cùng số node với cây con trỏ,
+//   - cây hợp lệ ghi ra văn bản rồi phân tích lại vẫn có cùng số node.
+// Khi biên dịch với -DXML_FUZZ_REPLAY, chương trình chạy lại các file đầu vào (ví dụ fuzz/corpus/*) không cần libFuzzer.
+
+// Phần nhỏ nhất của một luồng khi fuzz, đủ nhỏ để dữ liệu fuzz (thường vài trăm byte) được chia thành nhiều phần
+#define FUZZ_MIN_CHUNK 32
+
+static size_t count_nodes(TreeNode* root) {
+    size_t count = 0;
+    int depth = 0;
+    for (TreeNode* node = root; node != NULL; node = next_preorder_node(node, root, &depth)) count++;
+    return count;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    // Bộ phân tích làm việc trên buffer có kết thúc '\0' như khi đọc file
+    char* buffer = (char*)malloc(size + 1);
+    if (buffer == NULL) return 0;
+    memcpy(buffer, data, size);
+    buffer[size] = '\0';
+
+    int valid = is_valid_xml_buffer(buffer, size);
+    if (is_valid_xml_buffer_parallel_ex(buffer, size, 4, FUZZ_MIN_CHUNK) != valid) abort();
+    if (is_valid_xml_buffer_parallel_ex(buffer, size, 16, 1) != valid) abort();
+
+    TreeNode* root = parse_xml_buffer(buffer, size);
+    if (root != NULL) {
+        size_t nodes = count_nodes(root);
+        FlatXMLTree* flat = flatten_xml_tree(root);
+        if (flat != NULL && flat->node_count != nodes) abort();
+        free_flat_xml_tree(flat);
+
+        if (revalidate_xml_tree(root)) {
+            char* text = NULL;
+            size_t text_length = 0;
+            FILE* stream = open_memstream(&text, &text_length);
+            if (stream != NULL) {
+                write_tag(stream, root, 0);
+                fclose(stream);
+                TreeNode* reparsed = parse_xml_buffer(text, text_length);
+                if (reparsed == NULL || count_nodes(reparsed) != nodes) abort();
+                delete_tag(reparsed);
+            }
+            free(text);
+        }
+        delete_tag(root);
+    }
+    free(buffer);
+    return 0;
+}
+
+#ifdef XML_FUZZ_REPLAY
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        size_t length = 0;
+        char* content = read_xml_file(argv[i], &length);
+        if (content == NULL) continue;
+        LLVMFuzzerTestOneInput((const uint8_t*)content, length);
+        free(content);
+        printf("[fuzz_xml] Đã chạy: %s\n", argv[i]);
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,68 @@
+#ifndef XML_BINARY_H
+#define XML_BINARY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "XMLTree.h"
+
+// Định dạng nhị phân gọn cho cây XML, có thể mmap và đọc trực tiếp không cần giải tuần tự:
+//   [XMLBHeader][XMLBNode x node_count][XMLBAttribute x attribute_count][string pool]
+// Node được xếp theo thứ tự duyệt trước (pre-order) nên node gốc có chỉ số 0.
+// Mọi tên thẻ, text, tên/giá trị thuộc tính là offset vào string pool (chuỗi kết thúc '\0', đã loại trùng).
+
+#define XMLB_MAGIC 0x424C4D58u      // "XMLB"
+#define XMLB_VERSION 1u
+#define XMLB_BYTE_ORDER 0x01020304u // Phát hiện file ghi trên máy khác thứ tự byte
+#define XMLB_NONE 0xFFFFFFFFu       // Không có node/chuỗi
+
+typedef struct XMLBHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t node_count;
+    uint32_t attribute_count;
+    uint32_t string_pool_size;
+    uint32_t reserved[2];
+} XMLBHeader;
+
+typedef struct XMLBNode {
+    uint32_t tag_name;
+    uint32_t text;            // XMLB_NONE nếu không có nội dung
+    uint32_t parent;          // Chỉ số node cha, XMLB_NONE với node gốc
+    uint32_t first_child;
+    uint32_t next_sibling;
+    uint32_t first_attribute; // Chỉ số thuộc tính đầu tiên trong bảng thuộc tính
+    uint32_t attribute_count;
+} XMLBNode;
+
+typedef struct XMLBAttribute {
+    uint32_t name;
+    uint32_t value;
+} XMLBAttribute;
+
+// Tài liệu nhị phân đã mở (chỉ đọc)
+typedef struct XMLBinaryDocument {
+    const void* base;         // Vùng nhớ được mmap
+    size_t size;
+    const XMLBHeader* header;
+    const XMLBNode* nodes;
+    const XMLBAttribute* attributes;
+    const char* strings;
+} XMLBinaryDocument;
+
+// Ghi cây XML ra file nhị phân. Trả về 1 nếu thành công, 0 nếu lỗi.
+int write_xml_binary(const char* filename, TreeNode* root);
+
+// Mở file nhị phân bằng mmap chỉ đọc, chỉ kiểm tra header (O(1)). Trả về NULL nếu lỗi.
+XMLBinaryDocument* open_xml_binary(const char* filename);
+void close_xml_binary(XMLBinaryDocument* doc);
+
+// Truy cập node/chuỗi, có kiểm tra biên. Trả về NULL nếu chỉ số hoặc offset không hợp lệ.
+const XMLBNode* xmlb_node(const XMLBinaryDocument* doc, uint32_t index);
+const char* xmlb_string(const XMLBinaryDocument* doc, uint32_t offset);
+const char* xmlb_attribute(const XMLBinaryDocument* doc, const XMLBNode* node, const char* attr_name);
+
+// Tìm node đầu tiên (theo thứ tự tài liệu) có tên thẻ tag_name. Trả về chỉ số hoặc XMLB_NONE.
+uint32_t xmlb_find_tag(const XMLBinaryDocument* doc, const char* tag_name);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef XML_EXTRACT_H
+#define XML_EXTRACT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Trích xuất bản ghi dạng luồng (streaming) từ file XML mà không dựng cây:
+// đầu vào được đọc qua XMLInput (mmap với file thường, từng khối với pipe/stdin),
+// chỉ giữ ngăn xếp đường dẫn hiện tại và giá trị các trường của bản ghi đang đọc.
+//
+// Đường dẫn bản ghi là đường dẫn tuyệt đối từ thẻ gốc, ví dụ "bookstore/book".
+// Đường dẫn trường tính từ thẻ bản ghi:
+//   "title"         nội dung thẻ con <title>
+//   "info/isbn"     nội dung thẻ cháu <isbn> nằm trong <info>
+//   "@id"           thuộc tính id của chính thẻ bản ghi
+//   "title/@lang"   thuộc tính lang của thẻ con <title>
+// Mỗi trường chỉ lấy lần xuất hiện đầu tiên trong bản ghi; trường không có được ghi là chuỗi rỗng.
+//
+// Định dạng cột nhị phân (XML_EXTRACT_COLUMNAR), mọi số nguyên là uint32_t theo thứ tự byte của máy:
+//   [magic "XMLC"][version][field_count][độ dài + tên từng trường]
+//   rồi lặp các khối: [row_count][với từng trường: offsets x (row_count + 1)][dữ liệu của trường]
+// Mỗi khối chứa tối đa XML_EXTRACT_BLOCK_ROWS bản ghi nên bộ nhớ dùng để gom cột có giới hạn.
+
+#define XML_EXTRACT_BLOCK_ROWS 1024        // Số bản ghi tối đa trong một khối cột
+#define XML_EXTRACT_MAGIC 0x434C4D58u      // "XMLC"
+#define XML_EXTRACT_VERSION 1u
+
+typedef enum XMLExtractFormat {
+    XML_EXTRACT_CSV,      // Dòng đầu là tên trường, mỗi bản ghi một dòng
+    XML_EXTRACT_COLUMNAR  // Khối cột nhị phân
+} XMLExtractFormat;
+
+// Thống kê sau khi trích xuất
+typedef struct XMLExtractStats {
+    size_t bytes_read;
+    size_t records;
+    size_t peak_buffer;   // Kích thước buffer đọc (0 khi file được mmap, lớn hơn khối đọc khi có thẻ rất dài)
+    double elapsed_ms;
+} XMLExtractStats;
+
+// Trích xuất các bản ghi từ input_filename ("-" là stdin) ra output_filename.
+// Trả về 1 nếu thành công, 0 nếu lỗi (đường dẫn sai, file lỗi hoặc XML sai cấu trúc). stats có thể là NULL.
+int extract_xml_records(const char* input_filename, const char* record_path,
+                        const char* const* field_paths, size_t field_count,
+                        XMLExtractFormat format, const char* output_filename, XMLExtractStats* stats);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef XML_FLAT_H
+#define XML_FLAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "XMLTree.h"
+
+// Cây XML dạng phẳng: các node nằm liên tiếp trong một mảng theo thứ tự duyệt trước (pre-order),
+// mỗi node lưu chỉ số kết thúc cây con (subtree_end) nên:
+//   - con đầu tiên của i là i + 1 (nếu i + 1 < subtree_end),
+//   - anh em kế tiếp của i là subtree_end của i (nếu còn nằm trong cây con của cha),
+//   - bỏ qua cả cây con chỉ là nhảy tới subtree_end, duyệt hậu duệ là duyệt đoạn (i, subtree_end).
+// Thuộc tính nằm trong mảng song song, mỗi node giữ đoạn [first_attribute, first_attribute + attribute_count).
+// Mọi chuỗi được sao chép vào một vùng nhớ liền khối theo cùng thứ tự duyệt.
+
+#define FLAT_NONE UINT32_MAX
+
+typedef struct FlatNode {
+    const char* tag_name;
+    const char* text;         // NULL nếu không có nội dung
+    uint32_t parent;          // FLAT_NONE với node gốc
+    uint32_t subtree_end;     // Chỉ số ngay sau hậu duệ cuối cùng
+    uint32_t first_attribute;
+    uint32_t attribute_count;
+} FlatNode;
+
+typedef struct FlatAttribute {
+    const char* name;
+    const char* value;
+} FlatAttribute;
+
+typedef struct FlatXMLTree {
+    FlatNode* nodes;
+    uint32_t node_count;
+    FlatAttribute* attributes;
+    uint32_t attribute_count;
+    char* strings;            // Vùng chứa toàn bộ chuỗi
+} FlatXMLTree;
+
+// Chuyển cây con trỏ sang dạng phẳng (chỉ lấy cây con của root, bỏ qua anh em của root)
+FlatXMLTree* flatten_xml_tree(TreeNode* root);
+void free_flat_xml_tree(FlatXMLTree* tree);
+
+// Điều hướng, trả về FLAT_NONE nếu không có
+uint32_t flat_first_child(const FlatXMLTree* tree, uint32_t index);
+uint32_t flat_next_sibling(const FlatXMLTree* tree, uint32_t index);
+
+// Tìm hậu duệ đầu tiên (theo thứ tự tài liệu) của node from có tên thẻ tag_name, tính cả chính from
+uint32_t flat_find_tag(const FlatXMLTree* tree, uint32_t from, const char* tag_name);
+
+// Đếm số hậu duệ của node from có tên thẻ tag_name
+size_t flat_count_tag(const FlatXMLTree* tree, uint32_t from, const char* tag_name);
+
+// Lấy giá trị thuộc tính của node, NULL nếu không có
+const char* flat_get_attribute(const FlatXMLTree* tree, uint32_t index, const char* attr_name);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef XML_INPUT_H
+#define XML_INPUT_H
+
+#include <stddef.h>
+
+// Lớp đọc đầu vào XML dùng chung cho bộ kiểm tra, bộ phân tích và bộ trích xuất.
+//   - File thường: mmap chỉ đọc cả file và madvise(MADV_SEQUENTIAL), dữ liệu được xử lý tại chỗ,
+//     không sao chép và hệ điều hành chỉ nạp trang khi được đọc tới. Cửa sổ dữ liệu là cả file ngay từ đầu.
+//   - Pipe, stdin ("-") hoặc file không mmap được: đọc dần theo từng khối vào buffer.
+// Người dùng xử lý cửa sổ [data, data + length), rồi gọi xml_input_refill với số byte đã xử lý xong
+// để bỏ phần đó và đọc thêm. Phần chưa xử lý (ví dụ một thẻ bị cắt ngang) được giữ lại ở đầu cửa sổ mới.
+
+#define XML_INPUT_CHUNK_SIZE (64 * 1024) // Kích thước khối đọc khi không dùng mmap
+
+typedef struct XMLInput {
+    const char* data;   // Cửa sổ dữ liệu chưa xử lý
+    size_t length;
+    int eof;            // 1 khi cửa sổ đã chứa toàn bộ phần còn lại của đầu vào
+    int error;          // 1 nếu có lỗi đọc
+    size_t total_read;  // Tổng số byte đã đọc
+    int mapped;         // 1 nếu đầu vào được mmap
+
+    // Trạng thái nội bộ
+    int fd;
+    int owns_fd;
+    void* map;
+    size_t map_size;
+    char* buffer;
+    size_t capacity;
+} XMLInput;
+
+// Mở đầu vào, "-" là stdin. Trả về NULL nếu không mở được.
+XMLInput* open_xml_input(const char* filename);
+
+// Bỏ consumed byte đầu cửa sổ và đọc thêm dữ liệu (buffer tự mở rộng khi phần giữ lại chiếm hết buffer).
+// Trả về 1 nếu cửa sổ thay đổi và cần xử lý lại, 0 nếu đã hết đầu vào hoặc có lỗi.
+int xml_input_refill(XMLInput* input, size_t consumed);
+
+// Đọc hết phần còn lại vào cửa sổ (với mmap không tốn thêm gì). Trả về 1 nếu thành công.
+int xml_input_read_all(XMLInput* input);
+
+void close_xml_input(XMLInput* input);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef XML_LEXER_H
+#define XML_LEXER_H
+
+#include <stddef.h>
+
+// Loại thẻ mà bộ tách thẻ (lexer) nhận diện được
+typedef enum XMLTokenType {
+    XML_TOKEN_OPEN,        // Thẻ mở: <tag ...>
+    XML_TOKEN_CLOSE,       // Thẻ đóng: </tag>
+    XML_TOKEN_DECLARATION  // Thẻ khai báo: <? ... ?>
+} XMLTokenType;
+
+// Kết quả trả về của next_xml_token
+#define XML_LEX_OK 1            // Đọc được một thẻ hoàn chỉnh
+#define XML_LEX_END 0           // Không còn dấu '<' nào
+#define XML_LEX_UNTERMINATED -1 // Có dấu '<' nhưng không có dấu '>' đóng thẻ
+
+// Một thẻ trong văn bản XML. Các con trỏ trỏ thẳng vào buffer đầu vào (không sao chép).
+typedef struct XMLToken {
+    XMLTokenType type;
+    const char* start;   // Vị trí dấu '<'
+    const char* end;     // Vị trí ngay sau dấu '>'
+    const char* name;    // Tên thẻ (không kết thúc bằng '\0')
+    size_t name_length;
+    const char* body;    // Phần còn lại của thẻ mở sau tên thẻ (thuộc tính)
+    const char* body_end;// Kết thúc phần thuộc tính (trước "/>" hoặc ">")
+    int self_closing;    // 1 nếu là thẻ tự đóng <tag ... />
+} XMLToken;
+
+// Đọc thẻ tiếp theo bắt đầu từ pos, không vượt quá limit.
+// Tên thẻ mở là phần trước khoảng trắng đầu tiên, tên thẻ đóng là toàn bộ nội dung; cả hai được cắt khoảng trắng hai đầu.
+// Thẻ mở kết thúc bằng "/>" được đánh dấu self_closing và dấu '/' không thuộc tên hay thuộc tính.
+int next_xml_token(const char* pos, const char* limit, XMLToken* token);
+
+// Đếm số ký tự xuống dòng trong [begin, end)
+size_t count_newlines(const char* begin, const char* end);
+
+#endif
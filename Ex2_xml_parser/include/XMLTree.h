@@ -1,38 +1,91 @@
+#ifndef XML_TREE_H
+#define XML_TREE_H
+
 #include <stdio.h>
+#include <stdint.h>
+#include "XMLInput.h"
+
+// Số thuộc tính được lưu ngay trong node, vượt quá thì dùng mảng động và bảng băm
+#define XML_INLINE_ATTRIBUTES 4
 
 // Định nghĩa struct cho thuộc tính của thẻ XML
 typedef struct Attribute {
     char* name; // Tên thuộc tính                  
     char* value; // Giá trị thuộc tính                  
-    struct Attribute* next;
 } Attribute;
 
+// Danh sách thuộc tính của một node, giữ đúng thứ tự thêm vào:
+//   - XML_INLINE_ATTRIBUTES thuộc tính đầu nằm ngay trong node, không cấp phát thêm, tra cứu bằng duyệt ngắn;
+//   - các thuộc tính sau nằm trong mảng động overflow;
+//   - khi số thuộc tính vượt quá XML_INLINE_ATTRIBUTES, bảng băm tên -> vị trí giúp tra cứu/cập nhật O(1).
+typedef struct AttributeList {
+    size_t count;
+    Attribute inline_items[XML_INLINE_ATTRIBUTES];
+    Attribute* overflow;
+    size_t overflow_capacity;
+    size_t* index;          // Bảng băm địa chỉ mở, lưu vị trí + 1 (0 là ô trống)
+    size_t index_capacity;  // Luỹ thừa của 2, 0 khi chưa dựng bảng băm
+} AttributeList;
+
 // Định nghĩa struct cho một node trong cây XML
 typedef struct TreeNode {
     char* tag_name;  // key của thẻ XML            
-    Attribute* attributes; 
+    AttributeList attributes;
     char* text;
     struct TreeNode* first_child;
     struct TreeNode* next_sibling;
     struct TreeNode* parent;
+
+    // Trạng thái kiểm tra tăng dần (incremental validation)
+    int self_dirty;     // Tên thẻ, thuộc tính hoặc text của node đã đổi kể từ lần kiểm tra trước
+    int subtree_dirty;  // Node hoặc một hậu duệ đã đổi, được lan truyền lên theo con trỏ parent
+    int self_valid;     // Kết quả kiểm tra riêng node ở lần gần nhất
+    int subtree_valid;  // self_valid và mọi cây con đều hợp lệ
+    int invalid_children;               // Số con có subtree_valid = 0
+    int in_dirty_list;                  // Node đang nằm trong danh sách dirty_children của cha
+    struct TreeNode* dirty_children;    // Danh sách các con cần kiểm tra lại (không phải duyệt hết các con)
+    struct TreeNode* next_dirty;
 } TreeNode;
 
 // ==== Các hàm kiểm tra file XML đầu vào ===
+const char* tag_name_error(const char* tag_name, size_t length); // Trả về lý do tên thẻ không hợp lệ, NULL nếu hợp lệ
 int is_valid_tag(const char* tag_name); // Kiểm tra tính hợp lệ của các thẻ
-int is_valid_xml_file(const char* filename); // Hàm kiểm tra tính hợp lệ của file XML
+char* read_xml_file(const char* filename, size_t* length); // Đọc toàn bộ file vào buffer (kết thúc bằng '\0')
+int is_valid_xml_buffer(const char* buffer, size_t length); // Kiểm tra tính hợp lệ của nội dung XML trong buffer
+int is_valid_xml_input(XMLInput* input); // Kiểm tra đầu vào theo từng cửa sổ, không cần đọc hết vào bộ nhớ
+int is_valid_xml_file(const char* filename); // Hàm kiểm tra tính hợp lệ của file XML (mmap file thường, "-" là stdin)
+
+// Kiểm tra song song: chia buffer tại các dấu '<' an toàn, mỗi luồng ghép cặp thẻ trong phần của mình,
+// sau đó gộp các stack còn dư theo thứ tự để xác định tính hợp lệ và vị trí lỗi đầu tiên.
+// num_threads <= 0 nghĩa là dùng số lõi CPU hiện có.
+int is_valid_xml_buffer_parallel(const char* buffer, size_t length, int num_threads);
+// Như trên nhưng tự chọn kích thước phần nhỏ nhất của một luồng (mặc định 256 KB); phần nhỏ vài chục byte
+// buộc cả đầu vào ngắn cũng bị chia và gộp, dùng cho fuzz/kiểm thử đường gộp.
+int is_valid_xml_buffer_parallel_ex(const char* buffer, size_t length, int num_threads, size_t min_chunk);
+int is_valid_xml_file_parallel(const char* filename, int num_threads);
 
 // ==== Các hàm thao tác với cây XML === 
 // 1. Tạonode mới
 TreeNode* create_node(const char* tag_name);
 
+// Dựng cây XML từ văn bản. Trả về NULL nếu văn bản không hợp lệ.
+TreeNode* parse_xml_buffer(const char* buffer, size_t length);
+TreeNode* parse_xml_file(const char* filename);
+
 // 2. Thêm và xoá node trong cây XML
 void add_tag(TreeNode* parent, const char* tag_name); // Thêm thẻ
 void delete_tag(TreeNode* node); // Xoá thẻ
 
+// Truy cập thuộc tính theo vị trí (0 <= i < attribute_count) hoặc theo tên (NULL nếu không có)
+size_t attribute_count(const TreeNode* node);
+Attribute* attribute_at(const TreeNode* node, size_t i);
+Attribute* find_attribute(const TreeNode* node, const char* attr_name);
+uint32_t hash_xml_name(const char* name); // Hàm băm FNV-1a dùng chung cho tên thẻ/thuộc tính
+
 // 3. Thay đổi giá trị thuộc tính của node
 void change_attribute(TreeNode* node, const char* attr_name, const char* new_value);
 
-// 4. Thêm thuộc tính vào node
+// 4. Thêm thuộc tính vào node (nếu đã có thuộc tính cùng tên thì cập nhật giá trị)
 void add_attribute(TreeNode* node, const char* attr_name, const char* value);
 
 // 5. Tìm kiếm/in ra giá trị của 1 key (tag_name). Trả về 1 nếu tìm thấy, 0 nếu không tìm thấy.
@@ -41,10 +94,25 @@ int search_and_print_tag(TreeNode* root, const char* tag_name);
 // 6. Tìm kiếm và in ra nội dung của 1 thẻ. Trả về 1 nếu tìm thấy, 0 nếu không tìm thấy.
 int search_and_print(TreeNode* root, const char* tag_name);
 
+// Node kế tiếp theo thứ tự duyệt trước trong cây con của root (không đệ quy), depth được cập nhật theo độ sâu
+TreeNode* next_preorder_node(TreeNode* node, TreeNode* root, int* depth);
+
+// 8. Kiểm tra tăng dần sau khi sửa cây
+// Đánh dấu node đã bị sửa; các hàm sửa cây ở trên tự gọi hàm này, chỉ cần gọi khi sửa trực tiếp các trường của node.
+void mark_dirty(TreeNode* node);
+// Gán nội dung text cho node và đánh dấu node đã bị sửa
+void set_text(TreeNode* node, const char* text);
+// Kiểm tra lại cây, chỉ đi vào các cây con bị đánh dấu. Trả về 1 nếu cả cây hợp lệ.
+// root có thể là một cây con; lần kiểm tra sau từ gốc vẫn tính đúng kết quả của các tổ tiên.
+// Node hợp lệ khi: tên thẻ hợp lệ, tên thuộc tính hợp lệ và không trùng, giá trị thuộc tính và text không chứa '<' (giá trị không chứa '"').
+int revalidate_xml_tree(TreeNode* root);
+
 // 7. Giải phóng bộ nhớ của cây XML, xoá toàn bộ các node
 void delete_child_by_tag_name(TreeNode* parent, const char* tag_name);
 void free_xml_tree(TreeNode* root);
 
 // === Ghi cấu trúc của cây XML ra file ===
 void write_tag(FILE* file, TreeNode* node, int indent);
-void write_xml_file(const char* filename, TreeNode* root);
\ No newline at end of file
+void write_xml_file(const char* filename, TreeNode* root);
+
+#endif
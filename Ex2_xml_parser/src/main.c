@@ -4,6 +4,8 @@
 #include <ctype.h>
 #include "TagStack.h"
 #include "XMLTree.h"
+#include "XMLBinary.h"
+#include "XMLExtract.h"
 
 int main() {
     printf("Starting XML validation...\n");
@@ -15,6 +17,21 @@ int main() {
         printf("File XML không hợp lệ.\n");
     }
 
+    // Kiểm tra song song (file nhỏ sẽ tự động chuyển sang kiểm tra tuần tự)
+    printf("\nKiểm tra song song file XML...\n");
+    is_valid_xml_file_parallel("../input/xml_input.txt", 0);
+
+    // Trích xuất các bản ghi <book> ra CSV theo luồng, không dựng cây
+    printf("\nTrích xuất bản ghi book ra CSV...\n");
+    const char* book_fields[] = {"title", "author", "price"};
+    XMLExtractStats stats;
+    if (extract_xml_records("../input/xml_input.txt", "bookstore/book", book_fields, 3,
+                            XML_EXTRACT_CSV, "../output/books.csv", &stats)) {
+        printf("Đã trích xuất %zu bản ghi (%zu bytes) trong %.3f ms, %.1f MB/s, buffer tối đa %zu bytes\n",
+               stats.records, stats.bytes_read, stats.elapsed_ms,
+               stats.elapsed_ms > 0 ? stats.bytes_read / 1e3 / stats.elapsed_ms : 0.0, stats.peak_buffer);
+    }
+
     // Tạo một cây XML mẫu
     printf("\nTạo cây XML mẫu...\n");
     TreeNode* root = create_node("library");
@@ -33,14 +50,24 @@ int main() {
     add_attribute(root->first_child->next_sibling->first_child, "lang", "vn");
 
     // Thêm nội dung cho các node
-    root->first_child->first_child->text = strdup("C Programming");
-    root->first_child->first_child->next_sibling->text = strdup("Nguyen Van A");
-    root->first_child->next_sibling->first_child->text = strdup("Tech Magazine");
-    root->first_child->next_sibling->first_child->next_sibling->text = strdup("Le Thi B");
+    set_text(root->first_child->first_child, "C Programming");
+    set_text(root->first_child->first_child->next_sibling, "Nguyen Van A");
+    set_text(root->first_child->next_sibling->first_child, "Tech Magazine");
+    set_text(root->first_child->next_sibling->first_child->next_sibling, "Le Thi B");
+
+    // Kiểm tra toàn bộ cây lần đầu
+    printf("\nKiểm tra cây XML: %s\n", revalidate_xml_tree(root) ? "hợp lệ" : "không hợp lệ");
 
     // Thay đổi giá trị thuộc tính
     change_attribute(root->first_child, "id", "b002");
 
+    // Chỉ kiểm tra lại cây con vừa bị sửa
+    TreeNode* magazine_title = root->first_child->next_sibling->first_child;
+    add_attribute(magazine_title, "note", "a<b");
+    printf("Kiểm tra lại sau khi thêm thuộc tính sai: %s\n", revalidate_xml_tree(root) ? "hợp lệ" : "không hợp lệ");
+    change_attribute(magazine_title, "note", "a-b");
+    printf("Kiểm tra lại sau khi sửa thuộc tính: %s\n", revalidate_xml_tree(root) ? "hợp lệ" : "không hợp lệ");
+
     // Tìm kiếm và in giá trị của 1 key (tag_name)
     printf("\nTìm kiếm và in giá trị của thẻ 'author':\n");
     search_and_print_tag(root, "author");
@@ -57,6 +84,17 @@ int main() {
     printf("\nGhi cây XML ra file...\n");
     write_xml_file("../output/output.xml", root);
 
+    // Lưu cây XML dạng nhị phân rồi nạp lại bằng mmap, không cần phân tích lại văn bản
+    printf("\nGhi cây XML dạng nhị phân...\n");
+    if (write_xml_binary("../output/output.xmlb", root)) {
+        XMLBinaryDocument* doc = open_xml_binary("../output/output.xmlb");
+        const XMLBNode* title = xmlb_node(doc, xmlb_find_tag(doc, "title"));
+        if (title != NULL) {
+            printf("[xmlb] Thẻ <title lang=\"%s\">: %s\n", xmlb_attribute(doc, title, "lang"), xmlb_string(doc, title->text));
+        }
+        close_xml_binary(doc);
+    }
+
     // Giải phóng bộ nhớ
     printf("\nGiải phóng bộ nhớ...\n");
     free_xml_tree(root);
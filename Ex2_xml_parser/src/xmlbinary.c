@@ -0,0 +1,255 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "XMLBinary.h"
+
+// ==== Bộ dựng string pool có loại trùng (bảng băm địa chỉ mở) ====
+typedef struct StringPool {
+    char* data;
+    size_t size;
+    size_t capacity;
+    uint32_t* slots;     // Offset của chuỗi trong data, XMLB_NONE nếu ô trống
+    size_t slot_count;   // Luôn là luỹ thừa của 2
+    size_t used_slots;
+} StringPool;
+
+static int pool_grow_slots(StringPool* pool) {
+    size_t slot_count = pool->slot_count ? pool->slot_count * 2 : 256;
+    uint32_t* slots = (uint32_t*)malloc(slot_count * sizeof(uint32_t));
+    if (slots == NULL) return 0;
+    memset(slots, 0xFF, slot_count * sizeof(uint32_t));
+
+    for (size_t i = 0; i < pool->slot_count; i++) {
+        uint32_t offset = pool->slots[i];
+        if (offset == XMLB_NONE) continue;
+        size_t j = hash_xml_name(pool->data + offset) & (slot_count - 1);
+        while (slots[j] != XMLB_NONE) j = (j + 1) & (slot_count - 1);
+        slots[j] = offset;
+    }
+    free(pool->slots);
+    pool->slots = slots;
+    pool->slot_count = slot_count;
+    return 1;
+}
+
+// Thêm chuỗi vào pool (nếu chưa có) và trả về offset, XMLB_NONE nếu s là NULL hoặc lỗi
+static uint32_t pool_intern(StringPool* pool, const char* s) {
+    if (s == NULL) return XMLB_NONE;
+    if ((pool->used_slots + 1) * 2 > pool->slot_count && !pool_grow_slots(pool)) return XMLB_NONE;
+
+    size_t j = hash_xml_name(s) & (pool->slot_count - 1);
+    while (pool->slots[j] != XMLB_NONE) {
+        if (strcmp(pool->data + pool->slots[j], s) == 0) return pool->slots[j];
+        j = (j + 1) & (pool->slot_count - 1);
+    }
+
+    size_t length = strlen(s) + 1;
+    if (pool->size + length >= XMLB_NONE) return XMLB_NONE;
+    if (pool->size + length > pool->capacity) {
+        size_t capacity = pool->capacity ? pool->capacity * 2 : 4096;
+        while (capacity < pool->size + length) capacity *= 2;
+        char* data = (char*)realloc(pool->data, capacity);
+        if (data == NULL) return XMLB_NONE;
+        pool->data = data;
+        pool->capacity = capacity;
+    }
+
+    uint32_t offset = (uint32_t)pool->size;
+    memcpy(pool->data + offset, s, length);
+    pool->size += length;
+    pool->slots[j] = offset;
+    pool->used_slots++;
+    return offset;
+}
+
+int write_xml_binary(const char* filename, TreeNode* root) {
+    if (filename == NULL || root == NULL) {
+        printf("[write_xml_binary] Tên file hoặc cây XML không hợp lệ.\n");
+        return 0;
+    }
+
+    // Lượt 1: đếm node và thuộc tính
+    size_t node_count = 0, attribute_count = 0, max_depth = 0;
+    int depth = 0;
+    for (TreeNode* node = root; node != NULL; node = next_preorder_node(node, root, &depth)) {
+        node_count++;
+        if ((size_t)depth > max_depth) max_depth = depth;
+        attribute_count += node->attributes.count;
+    }
+    if (node_count >= XMLB_NONE || attribute_count >= XMLB_NONE) {
+        printf("[write_xml_binary] Cây XML quá lớn.\n");
+        return 0;
+    }
+
+    XMLBNode* nodes = (XMLBNode*)malloc(node_count * sizeof(XMLBNode));
+    XMLBAttribute* attributes = (XMLBAttribute*)malloc((attribute_count ? attribute_count : 1) * sizeof(XMLBAttribute));
+    uint32_t* last_at_depth = (uint32_t*)malloc((max_depth + 1) * sizeof(uint32_t)); // Node vừa thăm ở mỗi độ sâu
+    StringPool pool = {NULL, 0, 0, NULL, 0, 0};
+    int ok = nodes != NULL && attributes != NULL && last_at_depth != NULL;
+
+    // Lượt 2: đánh chỉ số theo thứ tự duyệt trước và nối các liên kết cha/con/anh em
+    uint32_t index = 0, attr_index = 0;
+    depth = 0;
+    for (TreeNode* node = root; ok && node != NULL; node = next_preorder_node(node, root, &depth), index++) {
+        XMLBNode* out = &nodes[index];
+        out->tag_name = pool_intern(&pool, node->tag_name);
+        out->text = pool_intern(&pool, node->text);
+        out->parent = depth > 0 ? last_at_depth[depth - 1] : XMLB_NONE;
+        out->first_child = XMLB_NONE;
+        out->next_sibling = XMLB_NONE;
+        out->first_attribute = attr_index;
+        out->attribute_count = 0;
+        ok = out->tag_name != XMLB_NONE && (node->text == NULL || out->text != XMLB_NONE);
+
+        if (out->parent != XMLB_NONE && nodes[out->parent].first_child == XMLB_NONE) {
+            nodes[out->parent].first_child = index;
+        } else if (depth > 0 && nodes[last_at_depth[depth]].parent == out->parent) {
+            nodes[last_at_depth[depth]].next_sibling = index;
+        }
+        last_at_depth[depth] = index;
+
+        for (size_t i = 0; ok && i < node->attributes.count; i++) {
+            Attribute* attr = attribute_at(node, i);
+            attributes[attr_index].name = pool_intern(&pool, attr->name);
+            attributes[attr_index].value = pool_intern(&pool, attr->value);
+            ok = attributes[attr_index].name != XMLB_NONE && attributes[attr_index].value != XMLB_NONE;
+            attr_index++;
+            out->attribute_count++;
+        }
+    }
+
+    // Pool luôn kết thúc bằng '\0' để mọi offset hợp lệ đều trỏ tới chuỗi kết thúc
+    if (ok && pool.size == 0) ok = pool_intern(&pool, "") != XMLB_NONE;
+
+    FILE* file = ok ? fopen(filename, "wb") : NULL;
+    if (file != NULL) {
+        XMLBHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = XMLB_MAGIC;
+        header.version = XMLB_VERSION;
+        header.byte_order = XMLB_BYTE_ORDER;
+        header.node_count = (uint32_t)node_count;
+        header.attribute_count = (uint32_t)attribute_count;
+        header.string_pool_size = (uint32_t)pool.size;
+
+        ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(nodes, sizeof(XMLBNode), node_count, file) == node_count &&
+             fwrite(attributes, sizeof(XMLBAttribute), attribute_count, file) == attribute_count &&
+             fwrite(pool.data, 1, pool.size, file) == pool.size;
+        ok = (fclose(file) == 0) && ok;
+    } else {
+        ok = 0;
+    }
+
+    if (!ok) {
+        printf("[write_xml_binary] Lỗi ghi file nhị phân: %s\n", filename);
+    }
+    free(nodes);
+    free(attributes);
+    free(last_at_depth);
+    free(pool.data);
+    free(pool.slots);
+    return ok;
+}
+
+XMLBinaryDocument* open_xml_binary(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        printf("[open_xml_binary] Không thể mở file: %s\n", filename);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(XMLBHeader)) {
+        printf("[open_xml_binary] File không đúng định dạng: %s\n", filename);
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void* base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        printf("[open_xml_binary] Lỗi mmap file: %s\n", filename);
+        return NULL;
+    }
+
+    // Chỉ kiểm tra header và kích thước các vùng, không duyệt dữ liệu
+    const XMLBHeader* header = (const XMLBHeader*)base;
+    uint64_t expected = sizeof(XMLBHeader) + (uint64_t)header->node_count * sizeof(XMLBNode) +
+                        (uint64_t)header->attribute_count * sizeof(XMLBAttribute) + header->string_pool_size;
+    if (header->magic != XMLB_MAGIC || header->version != XMLB_VERSION || header->byte_order != XMLB_BYTE_ORDER ||
+        expected != size || header->string_pool_size == 0) {
+        printf("[open_xml_binary] File không đúng định dạng: %s\n", filename);
+        munmap(base, size);
+        return NULL;
+    }
+
+    XMLBinaryDocument* doc = (XMLBinaryDocument*)malloc(sizeof(XMLBinaryDocument));
+    if (doc == NULL) {
+        munmap(base, size);
+        return NULL;
+    }
+    doc->base = base;
+    doc->size = size;
+    doc->header = header;
+    doc->nodes = (const XMLBNode*)(header + 1);
+    doc->attributes = (const XMLBAttribute*)(doc->nodes + header->node_count);
+    doc->strings = (const char*)(doc->attributes + header->attribute_count);
+
+    if (doc->strings[header->string_pool_size - 1] != '\0') {
+        printf("[open_xml_binary] String pool không kết thúc bằng '\\0': %s\n", filename);
+        close_xml_binary(doc);
+        return NULL;
+    }
+    return doc;
+}
+
+void close_xml_binary(XMLBinaryDocument* doc) {
+    if (doc == NULL) return;
+    munmap((void*)doc->base, doc->size);
+    free(doc);
+}
+
+const XMLBNode* xmlb_node(const XMLBinaryDocument* doc, uint32_t index) {
+    if (doc == NULL || index >= doc->header->node_count) return NULL;
+    return &doc->nodes[index];
+}
+
+const char* xmlb_string(const XMLBinaryDocument* doc, uint32_t offset) {
+    if (doc == NULL || offset >= doc->header->string_pool_size) return NULL;
+    return doc->strings + offset;
+}
+
+const char* xmlb_attribute(const XMLBinaryDocument* doc, const XMLBNode* node, const char* attr_name) {
+    if (doc == NULL || node == NULL || attr_name == NULL) return NULL;
+    uint64_t end = (uint64_t)node->first_attribute + node->attribute_count;
+    if (end > doc->header->attribute_count) return NULL;
+
+    for (uint32_t i = node->first_attribute; i < end; i++) {
+        const char* name = xmlb_string(doc, doc->attributes[i].name);
+        if (name != NULL && strcmp(name, attr_name) == 0) {
+            return xmlb_string(doc, doc->attributes[i].value);
+        }
+    }
+    return NULL;
+}
+
+uint32_t xmlb_find_tag(const XMLBinaryDocument* doc, const char* tag_name) {
+    if (doc == NULL || tag_name == NULL) return XMLB_NONE;
+
+    // Tên thẻ đã loại trùng nên mỗi tên chỉ có một offset: bỏ qua strcmp khi gặp lại offset vừa không khớp
+    uint32_t rejected = XMLB_NONE;
+    for (uint32_t i = 0; i < doc->header->node_count; i++) {
+        uint32_t offset = doc->nodes[i].tag_name;
+        if (offset == rejected) continue;
+        const char* name = xmlb_string(doc, offset);
+        if (name != NULL && strcmp(name, tag_name) == 0) return i;
+        rejected = offset;
+    }
+    return XMLB_NONE;
+}
@@ -0,0 +1,474 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include "XMLExtract.h"
+#include "XMLLexer.h"
+#include "XMLInput.h"
+#include "XMLTree.h"
+
+// Chuỗi động dùng cho đường dẫn hiện tại, giá trị trường và dữ liệu cột
+typedef struct TextBuffer {
+    char* data;
+    size_t length;
+    size_t capacity;
+} TextBuffer;
+
+static int text_append(TextBuffer* text, const char* s, size_t n) {
+    if (text->length + n + 1 > text->capacity) {
+        size_t capacity = text->capacity ? text->capacity * 2 : 64;
+        while (capacity < text->length + n + 1) capacity *= 2;
+        char* data = (char*)realloc(text->data, capacity);
+        if (data == NULL) return 0;
+        text->data = data;
+        text->capacity = capacity;
+    }
+    memcpy(text->data + text->length, s, n);
+    text->length += n;
+    text->data[text->length] = '\0';
+    return 1;
+}
+
+typedef struct ExtractField {
+    const char* path;   // Đường dẫn gốc do người dùng truyền vào
+    char* element;      // Đường dẫn thẻ tính từ bản ghi, "" là chính thẻ bản ghi
+    char* attribute;    // Tên thuộc tính, NULL nếu lấy nội dung thẻ
+    TextBuffer value;
+    int capture_depth;  // Độ sâu của thẻ đang lấy nội dung, 0 nếu không lấy
+    int filled;         // Đã gặp trường này trong bản ghi hiện tại
+} ExtractField;
+
+typedef struct Extractor {
+    ExtractField* fields;
+    size_t field_count;
+    const char* record_path;
+    size_t record_path_length;
+    TextBuffer path;        // Đường dẫn các thẻ đang mở, ví dụ "bookstore/book/title"
+    size_t* path_lengths;   // path_lengths[d] là độ dài path khi có d thẻ đang mở
+    int depth;
+    int depth_capacity;
+    int record_depth;       // Độ sâu của thẻ bản ghi đang mở, 0 nếu ở ngoài bản ghi
+    int capturing;          // Số trường đang lấy nội dung
+    XMLExtractFormat format;
+    FILE* out;
+    TextBuffer row;         // Dòng CSV đang dựng
+    TextBuffer* columns;    // Dữ liệu từng cột của khối hiện tại
+    uint32_t* offsets;      // field_count x (XML_EXTRACT_BLOCK_ROWS + 1)
+    size_t block_rows;
+    size_t records;
+} Extractor;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Tách "a/b/@attr" thành phần thẻ "a/b" và thuộc tính "attr"
+static int parse_field_path(ExtractField* field, const char* path) {
+    memset(field, 0, sizeof(ExtractField));
+    field->path = path;
+    if (path == NULL || *path == '\0') return 0;
+
+    const char* at = strchr(path, '@');
+    if (at == NULL) {
+        field->element = strdup(path);
+        return field->element != NULL;
+    }
+    if (at[1] == '\0' || strchr(at + 1, '/') != NULL) return 0;
+    if (at != path && at[-1] != '/') return 0;
+    size_t element_length = at > path ? (size_t)(at - path - 1) : 0;
+    field->element = strndup(path, element_length);
+    field->attribute = strdup(at + 1);
+    return field->element != NULL && field->attribute != NULL;
+}
+
+// Tìm giá trị thuộc tính name trong phần thân thẻ mở [begin, end)
+static int find_token_attribute(const char* begin, const char* end, const char* name,
+                                const char** value, size_t* value_length) {
+    size_t wanted = strlen(name);
+    const char* p = begin;
+    while (1) {
+        while (p < end && isspace((unsigned char)*p)) p++;
+        if (p == end) return 0;
+
+        const char* attr_name = p;
+        while (p < end && *p != '=' && !isspace((unsigned char)*p)) p++;
+        size_t name_length = p - attr_name;
+        while (p < end && isspace((unsigned char)*p)) p++;
+        if (p == end || *p != '=') return 0;
+        p++;
+        while (p < end && isspace((unsigned char)*p)) p++;
+        if (p == end || (*p != '"' && *p != '\'')) return 0;
+
+        char quote = *p++;
+        const char* attr_value = p;
+        while (p < end && *p != quote) p++;
+        if (p == end) return 0;
+
+        if (name_length == wanted && strncmp(attr_name, name, wanted) == 0) {
+            *value = attr_value;
+            *value_length = p - attr_value;
+            return 1;
+        }
+        p++;
+    }
+}
+
+// Phần giá trị sau khi cắt khoảng trắng hai đầu
+static const char* trimmed_value(const ExtractField* field, size_t* length) {
+    const char* begin = field->value.data ? field->value.data : "";
+    const char* end = begin + field->value.length;
+    while (begin < end && isspace((unsigned char)*begin)) begin++;
+    while (end > begin && isspace((unsigned char)end[-1])) end--;
+    *length = end - begin;
+    return begin;
+}
+
+// Nối một giá trị CSV vào dòng đang dựng, đặt trong dấu nháy kép nếu chứa ký tự đặc biệt
+static int csv_append(TextBuffer* row, const char* value, size_t length) {
+    if (memchr(value, ',', length) == NULL && memchr(value, '"', length) == NULL &&
+        memchr(value, '\n', length) == NULL && memchr(value, '\r', length) == NULL) {
+        return text_append(row, value, length);
+    }
+    int ok = text_append(row, "\"", 1);
+    for (const char* quote; ok && (quote = memchr(value, '"', length)) != NULL; ) {
+        size_t part = quote - value + 1;
+        ok = text_append(row, value, part) && text_append(row, "\"", 1);
+        value += part;
+        length -= part;
+    }
+    return ok && text_append(row, value, length) && text_append(row, "\"", 1);
+}
+
+// Dựng cả dòng trong bộ nhớ rồi ghi một lần
+static int write_csv_row(Extractor* ex, int header) {
+    ex->row.length = 0;
+    int ok = 1;
+    for (size_t f = 0; ok && f < ex->field_count; f++) {
+        size_t length;
+        const char* value = header ? ex->fields[f].path : trimmed_value(&ex->fields[f], &length);
+        if (header) length = strlen(value);
+        ok = (f == 0 || text_append(&ex->row, ",", 1)) && csv_append(&ex->row, value, length);
+    }
+    ok = ok && text_append(&ex->row, "\n", 1);
+    return ok && fwrite(ex->row.data, 1, ex->row.length, ex->out) == ex->row.length;
+}
+
+static int write_u32(FILE* out, uint32_t value) {
+    return fwrite(&value, sizeof(value), 1, out) == 1;
+}
+
+static int write_header(Extractor* ex) {
+    if (ex->format == XML_EXTRACT_CSV) return write_csv_row(ex, 1);
+
+    int ok = write_u32(ex->out, XML_EXTRACT_MAGIC) && write_u32(ex->out, XML_EXTRACT_VERSION) &&
+             write_u32(ex->out, (uint32_t)ex->field_count);
+    for (size_t f = 0; ok && f < ex->field_count; f++) {
+        size_t length = strlen(ex->fields[f].path);
+        ok = write_u32(ex->out, (uint32_t)length) && fwrite(ex->fields[f].path, 1, length, ex->out) == length;
+    }
+    return ok;
+}
+
+// Ghi khối cột hiện tại và làm rỗng các cột
+static int flush_block(Extractor* ex) {
+    if (ex->block_rows == 0) return 1;
+    int ok = write_u32(ex->out, (uint32_t)ex->block_rows);
+    for (size_t f = 0; ok && f < ex->field_count; f++) {
+        uint32_t* offsets = ex->offsets + f * (XML_EXTRACT_BLOCK_ROWS + 1);
+        ok = fwrite(offsets, sizeof(uint32_t), ex->block_rows + 1, ex->out) == ex->block_rows + 1 &&
+             fwrite(ex->columns[f].data, 1, ex->columns[f].length, ex->out) == ex->columns[f].length;
+        ex->columns[f].length = 0;
+    }
+    ex->block_rows = 0;
+    return ok;
+}
+
+static int emit_record(Extractor* ex) {
+    ex->records++;
+    if (ex->format == XML_EXTRACT_CSV) return write_csv_row(ex, 0);
+
+    for (size_t f = 0; f < ex->field_count; f++) {
+        size_t length;
+        const char* value = trimmed_value(&ex->fields[f], &length);
+        uint32_t* offsets = ex->offsets + f * (XML_EXTRACT_BLOCK_ROWS + 1);
+        if (ex->columns[f].length + length > UINT32_MAX || !text_append(&ex->columns[f], value, length)) return 0;
+        offsets[ex->block_rows + 1] = (uint32_t)ex->columns[f].length;
+    }
+    if (++ex->block_rows == XML_EXTRACT_BLOCK_ROWS) return flush_block(ex);
+    return 1;
+}
+
+// Nối đoạn text nằm giữa hai thẻ vào các trường đang lấy nội dung
+static int append_text_segment(Extractor* ex, const char* begin, const char* end) {
+    if (ex->capturing == 0 || begin == end) return 1;
+    for (size_t f = 0; f < ex->field_count; f++) {
+        if (ex->fields[f].capture_depth > 0 && !text_append(&ex->fields[f].value, begin, end - begin)) return 0;
+    }
+    return 1;
+}
+
+// Gặp thẻ khi đang lấy nội dung: ngăn cách text của các thẻ con bằng một dấu cách
+static int separate_text(Extractor* ex) {
+    if (ex->capturing == 0) return 1;
+    for (size_t f = 0; f < ex->field_count; f++) {
+        TextBuffer* value = &ex->fields[f].value;
+        if (ex->fields[f].capture_depth > 0 && value->length > 0 &&
+            !isspace((unsigned char)value->data[value->length - 1]) && !text_append(value, " ", 1)) return 0;
+    }
+    return 1;
+}
+
+static int push_path(Extractor* ex, const char* name, size_t length) {
+    if (ex->depth + 1 >= ex->depth_capacity) {
+        int capacity = ex->depth_capacity ? ex->depth_capacity * 2 : 32;
+        size_t* lengths = (size_t*)realloc(ex->path_lengths, capacity * sizeof(size_t));
+        if (lengths == NULL) return 0;
+        ex->path_lengths = lengths;
+        ex->depth_capacity = capacity;
+    }
+    ex->path_lengths[ex->depth] = ex->path.length;
+    if (ex->depth > 0 && !text_append(&ex->path, "/", 1)) return 0;
+    if (!text_append(&ex->path, name, length)) return 0;
+    ex->depth++;
+    return 1;
+}
+
+static void pop_path(Extractor* ex) {
+    ex->depth--;
+    ex->path.length = ex->path_lengths[ex->depth];
+    ex->path.data[ex->path.length] = '\0';
+}
+
+// Tên thẻ đang mở trên cùng
+static const char* top_name(const Extractor* ex, size_t* length) {
+    size_t begin = ex->path_lengths[ex->depth - 1] + (ex->depth > 1 ? 1 : 0);
+    *length = ex->path.length - begin;
+    return ex->path.data + begin;
+}
+
+// Xử lý thẻ mở sau khi đã đưa tên thẻ vào đường dẫn
+static int handle_open(Extractor* ex, const XMLToken* token) {
+    if (ex->record_depth == 0) {
+        if (ex->path.length != ex->record_path_length || strcmp(ex->path.data, ex->record_path) != 0) return 1;
+        ex->record_depth = ex->depth;
+        for (size_t f = 0; f < ex->field_count; f++) {
+            ex->fields[f].value.length = 0;
+            ex->fields[f].filled = 0;
+            ex->fields[f].capture_depth = 0;
+        }
+        ex->capturing = 0;
+    }
+
+    const char* relative = ex->path.data + ex->record_path_length;
+    if (*relative == '/') relative++;
+    for (size_t f = 0; f < ex->field_count; f++) {
+        ExtractField* field = &ex->fields[f];
+        if (field->filled || field->capture_depth > 0 || strcmp(field->element, relative) != 0) continue;
+
+        if (field->attribute != NULL) {
+            const char* value;
+            size_t length;
+            if (find_token_attribute(token->body, token->body_end, field->attribute, &value, &length) &&
+                !text_append(&field->value, value, length)) return 0;
+            field->filled = 1;
+        } else {
+            field->capture_depth = ex->depth;
+            ex->capturing++;
+        }
+    }
+    return 1;
+}
+
+// Xử lý thẻ đóng trước khi bỏ tên thẻ khỏi đường dẫn
+static int handle_close(Extractor* ex) {
+    if (ex->capturing > 0) {
+        for (size_t f = 0; f < ex->field_count; f++) {
+            if (ex->fields[f].capture_depth == ex->depth) {
+                ex->fields[f].capture_depth = 0;
+                ex->fields[f].filled = 1;
+                ex->capturing--;
+            }
+        }
+    }
+    if (ex->depth == ex->record_depth) {
+        ex->record_depth = 0;
+        return emit_record(ex);
+    }
+    return 1;
+}
+
+static void free_extractor(Extractor* ex) {
+    for (size_t f = 0; f < ex->field_count; f++) {
+        free(ex->fields[f].element);
+        free(ex->fields[f].attribute);
+        free(ex->fields[f].value.data);
+        if (ex->columns != NULL) free(ex->columns[f].data);
+    }
+    free(ex->fields);
+    free(ex->columns);
+    free(ex->offsets);
+    free(ex->path.data);
+    free(ex->path_lengths);
+    free(ex->row.data);
+}
+
+int extract_xml_records(const char* input_filename, const char* record_path,
+                        const char* const* field_paths, size_t field_count,
+                        XMLExtractFormat format, const char* output_filename, XMLExtractStats* stats) {
+    if (input_filename == NULL || output_filename == NULL || record_path == NULL ||
+        field_paths == NULL || field_count == 0) {
+        printf("[extract_xml_records] Tham số không hợp lệ.\n");
+        return 0;
+    }
+    while (*record_path == '/') record_path++;
+    if (*record_path == '\0') {
+        printf("[extract_xml_records] Đường dẫn bản ghi rỗng.\n");
+        return 0;
+    }
+
+    double start_ms = now_ms();
+    Extractor ex;
+    memset(&ex, 0, sizeof(ex));
+    ex.record_path = record_path;
+    ex.record_path_length = strlen(record_path);
+    ex.format = format;
+    ex.field_count = field_count;
+    ex.fields = (ExtractField*)calloc(field_count, sizeof(ExtractField));
+    if (ex.fields == NULL) {
+        printf("[extract_xml_records] Lỗi cấp phát bộ nhớ.\n");
+        return 0;
+    }
+    for (size_t f = 0; f < field_count; f++) {
+        if (!parse_field_path(&ex.fields[f], field_paths[f])) {
+            printf("[extract_xml_records] Đường dẫn trường không hợp lệ: %s\n", field_paths[f] ? field_paths[f] : "(null)");
+            free_extractor(&ex);
+            return 0;
+        }
+    }
+    if (format == XML_EXTRACT_COLUMNAR) {
+        ex.columns = (TextBuffer*)calloc(field_count, sizeof(TextBuffer));
+        ex.offsets = (uint32_t*)calloc(field_count * (XML_EXTRACT_BLOCK_ROWS + 1), sizeof(uint32_t));
+        if (ex.columns == NULL || ex.offsets == NULL) {
+            printf("[extract_xml_records] Lỗi cấp phát bộ nhớ.\n");
+            free_extractor(&ex);
+            return 0;
+        }
+    }
+
+    XMLInput* in = open_xml_input(input_filename);
+    if (in == NULL) {
+        free_extractor(&ex);
+        return 0;
+    }
+    ex.out = fopen(output_filename, format == XML_EXTRACT_CSV ? "w" : "wb");
+    if (ex.out == NULL || !text_append(&ex.path, "", 0)) {
+        printf("[extract_xml_records] Không thể tạo file: %s\n", output_filename);
+        if (ex.out != NULL) fclose(ex.out);
+        close_xml_input(in);
+        free_extractor(&ex);
+        return 0;
+    }
+
+    // File được mmap nằm trọn trong một cửa sổ; pipe/stdin được xử lý dần theo từng khối
+    int ok = write_header(&ex);
+    int line_number = 1;
+    while (ok) {
+        const char* pos = in->data;
+        const char* limit = in->data + in->length;
+        const char* counted = in->data;
+        XMLToken token;
+        int status = XML_LEX_END;
+        while (ok && (status = next_xml_token(pos, limit, &token)) == XML_LEX_OK) {
+            line_number += (int)count_newlines(counted, token.start);
+            counted = token.start;
+            if (!append_text_segment(&ex, pos, token.start)) {
+                ok = 0;
+                break;
+            }
+            pos = token.end;
+            if (token.type == XML_TOKEN_DECLARATION) continue;
+
+            const char* error = tag_name_error(token.name, token.name_length);
+            if (error != NULL) {
+                printf("[extract_xml_records] %s\n", error);
+                printf("[extract_xml_records] Tên thẻ không hợp lệ ở dòng %d: %.*s\n", line_number, (int)token.name_length, token.name);
+                ok = 0;
+                break;
+            }
+            if (!separate_text(&ex)) {
+                ok = 0;
+                break;
+            }
+
+            if (token.type == XML_TOKEN_CLOSE) {
+                size_t open_length;
+                const char* open_name = ex.depth > 0 ? top_name(&ex, &open_length) : NULL;
+                if (open_name == NULL || open_length != token.name_length ||
+                    strncmp(open_name, token.name, open_length) != 0) {
+                    printf("[extract_xml_records] Lỗi: Thẻ đóng </%.*s> không khớp ở dòng %d\n",
+                           (int)token.name_length, token.name, line_number);
+                    ok = 0;
+                    break;
+                }
+                ok = handle_close(&ex);
+                pop_path(&ex);
+                continue;
+            }
+
+            ok = push_path(&ex, token.name, token.name_length) && handle_open(&ex, &token);
+            if (ok && token.self_closing) {
+                ok = handle_close(&ex);
+                pop_path(&ex);
+            }
+        }
+        if (!ok) break;
+
+        // Phần còn lại: text (đã có thể xử lý) hoặc một thẻ chưa đọc hết
+        if (status == XML_LEX_END) {
+            ok = append_text_segment(&ex, pos, limit);
+            pos = limit;
+        } else {
+            ok = append_text_segment(&ex, pos, token.start);
+            pos = token.start;
+        }
+        line_number += (int)count_newlines(counted, pos);
+
+        if (in->eof) {
+            if (pos < limit) {
+                printf("[extract_xml_records] Lỗi: Thẻ không đóng ở dòng %d\n", line_number);
+                ok = 0;
+            }
+            break;
+        }
+        if (!xml_input_refill(in, pos - in->data)) break;
+    }
+
+    if (ok && in->error) {
+        printf("[extract_xml_records] Lỗi đọc file: %s\n", input_filename);
+        ok = 0;
+    }
+    if (ok && ex.depth > 0) {
+        size_t open_length;
+        const char* open_name = top_name(&ex, &open_length);
+        printf("[extract_xml_records] Lỗi: Còn thẻ chưa đóng: <%.*s>\n", (int)open_length, open_name);
+        ok = 0;
+    }
+    if (ok && format == XML_EXTRACT_COLUMNAR) ok = flush_block(&ex);
+    ok = (fclose(ex.out) == 0) && ok;
+    if (!ok) {
+        printf("[extract_xml_records] Trích xuất thất bại: %s\n", input_filename);
+    }
+
+    if (stats != NULL) {
+        stats->bytes_read = in->total_read;
+        stats->records = ex.records;
+        stats->peak_buffer = in->capacity;
+        stats->elapsed_ms = now_ms() - start_ms;
+    }
+    close_xml_input(in);
+    free_extractor(&ex);
+    return ok;
+}
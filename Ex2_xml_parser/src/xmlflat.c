@@ -0,0 +1,137 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "XMLFlat.h"
+
+// Sao chép chuỗi vào vùng chứa chuỗi và dịch con trỏ ghi
+static const char* copy_string(char** cursor, const char* s) {
+    if (s == NULL) return NULL;
+    size_t length = strlen(s) + 1;
+    char* out = *cursor;
+    memcpy(out, s, length);
+    *cursor += length;
+    return out;
+}
+
+FlatXMLTree* flatten_xml_tree(TreeNode* root) {
+    if (root == NULL) {
+        printf("[flatten_xml_tree] Cây XML rỗng.\n");
+        return NULL;
+    }
+
+    // Lượt 1: đếm node, thuộc tính, tổng độ dài chuỗi và độ sâu lớn nhất
+    size_t node_count = 0, attribute_count = 0, string_bytes = 0, max_depth = 0;
+    int depth = 0;
+    for (TreeNode* node = root; node != NULL; node = next_preorder_node(node, root, &depth)) {
+        node_count++;
+        if ((size_t)depth > max_depth) max_depth = depth;
+        string_bytes += strlen(node->tag_name) + 1;
+        if (node->text) string_bytes += strlen(node->text) + 1;
+        for (size_t i = 0; i < node->attributes.count; i++) {
+            Attribute* attr = attribute_at(node, i);
+            attribute_count++;
+            string_bytes += strlen(attr->name) + strlen(attr->value) + 2;
+        }
+    }
+    if (node_count >= FLAT_NONE || attribute_count >= FLAT_NONE) {
+        printf("[flatten_xml_tree] Cây XML quá lớn.\n");
+        return NULL;
+    }
+
+    FlatXMLTree* tree = (FlatXMLTree*)malloc(sizeof(FlatXMLTree));
+    uint32_t* open = (uint32_t*)malloc((max_depth + 1) * sizeof(uint32_t)); // Các node chưa đóng theo độ sâu
+    if (tree != NULL) {
+        tree->nodes = (FlatNode*)malloc(node_count * sizeof(FlatNode));
+        tree->attributes = (FlatAttribute*)malloc((attribute_count ? attribute_count : 1) * sizeof(FlatAttribute));
+        tree->strings = (char*)malloc(string_bytes);
+    }
+    if (tree == NULL || open == NULL || tree->nodes == NULL || tree->attributes == NULL || tree->strings == NULL) {
+        printf("[flatten_xml_tree] Lỗi cấp phát bộ nhớ.\n");
+        free(open);
+        free_flat_xml_tree(tree);
+        return NULL;
+    }
+    tree->node_count = (uint32_t)node_count;
+    tree->attribute_count = (uint32_t)attribute_count;
+
+    // Lượt 2: ghi node theo thứ tự duyệt trước; khi gặp node ở độ sâu d thì mọi node đang mở ở độ sâu >= d đã kết thúc
+    char* cursor = tree->strings;
+    uint32_t index = 0, attr_index = 0, open_count = 0;
+    depth = 0;
+    for (TreeNode* node = root; node != NULL; node = next_preorder_node(node, root, &depth), index++) {
+        while (open_count > (uint32_t)depth) {
+            tree->nodes[open[--open_count]].subtree_end = index;
+        }
+
+        FlatNode* out = &tree->nodes[index];
+        out->tag_name = copy_string(&cursor, node->tag_name);
+        out->text = copy_string(&cursor, node->text);
+        out->parent = depth > 0 ? open[depth - 1] : FLAT_NONE;
+        out->first_attribute = attr_index;
+        out->attribute_count = 0;
+        for (size_t i = 0; i < node->attributes.count; i++) {
+            Attribute* attr = attribute_at(node, i);
+            tree->attributes[attr_index].name = copy_string(&cursor, attr->name);
+            tree->attributes[attr_index].value = copy_string(&cursor, attr->value);
+            attr_index++;
+            out->attribute_count++;
+        }
+        open[open_count++] = index;
+    }
+    while (open_count > 0) {
+        tree->nodes[open[--open_count]].subtree_end = index;
+    }
+
+    free(open);
+    return tree;
+}
+
+void free_flat_xml_tree(FlatXMLTree* tree) {
+    if (tree == NULL) return;
+    free(tree->nodes);
+    free(tree->attributes);
+    free(tree->strings);
+    free(tree);
+}
+
+uint32_t flat_first_child(const FlatXMLTree* tree, uint32_t index) {
+    if (tree == NULL || index >= tree->node_count) return FLAT_NONE;
+    return index + 1 < tree->nodes[index].subtree_end ? index + 1 : FLAT_NONE;
+}
+
+uint32_t flat_next_sibling(const FlatXMLTree* tree, uint32_t index) {
+    if (tree == NULL || index >= tree->node_count) return FLAT_NONE;
+    uint32_t parent = tree->nodes[index].parent;
+    uint32_t next = tree->nodes[index].subtree_end;
+    if (parent == FLAT_NONE || next >= tree->nodes[parent].subtree_end) return FLAT_NONE;
+    return next;
+}
+
+uint32_t flat_find_tag(const FlatXMLTree* tree, uint32_t from, const char* tag_name) {
+    if (tree == NULL || tag_name == NULL || from >= tree->node_count) return FLAT_NONE;
+    uint32_t end = tree->nodes[from].subtree_end;
+    for (uint32_t i = from; i < end; i++) {
+        if (strcmp(tree->nodes[i].tag_name, tag_name) == 0) return i;
+    }
+    return FLAT_NONE;
+}
+
+size_t flat_count_tag(const FlatXMLTree* tree, uint32_t from, const char* tag_name) {
+    if (tree == NULL || tag_name == NULL || from >= tree->node_count) return 0;
+    size_t count = 0;
+    uint32_t end = tree->nodes[from].subtree_end;
+    for (uint32_t i = from + 1; i < end; i++) {
+        if (strcmp(tree->nodes[i].tag_name, tag_name) == 0) count++;
+    }
+    return count;
+}
+
+const char* flat_get_attribute(const FlatXMLTree* tree, uint32_t index, const char* attr_name) {
+    if (tree == NULL || attr_name == NULL || index >= tree->node_count) return NULL;
+    const FlatNode* node = &tree->nodes[index];
+    for (uint32_t i = 0; i < node->attribute_count; i++) {
+        const FlatAttribute* attr = &tree->attributes[node->first_attribute + i];
+        if (strcmp(attr->name, attr_name) == 0) return attr->value;
+    }
+    return NULL;
+}
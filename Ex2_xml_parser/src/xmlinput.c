@@ -0,0 +1,121 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "XMLInput.h"
+
+XMLInput* open_xml_input(const char* filename) {
+    if (filename == NULL) {
+        printf("[open_xml_input] Tên file không hợp lệ.\n");
+        return NULL;
+    }
+
+    int use_stdin = strcmp(filename, "-") == 0;
+    int fd = use_stdin ? STDIN_FILENO : open(filename, O_RDONLY);
+    if (fd < 0) {
+        printf("[open_xml_input] Không thể mở file: %s\n", filename);
+        return NULL;
+    }
+
+    XMLInput* input = (XMLInput*)calloc(1, sizeof(XMLInput));
+    if (input == NULL) {
+        printf("[open_xml_input] Lỗi cấp phát bộ nhớ.\n");
+        if (!use_stdin) close(fd);
+        return NULL;
+    }
+    input->fd = fd;
+    input->owns_fd = !use_stdin;
+
+    // File thường: mmap cả file, không cần giữ fd
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        size_t size = (size_t)st.st_size;
+        void* map = size > 0 ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        if (map != MAP_FAILED) {
+            madvise(map, size, MADV_SEQUENTIAL);
+            input->map = map;
+            input->map_size = size;
+            input->mapped = 1;
+            input->data = (const char*)map;
+            input->length = size;
+            input->total_read = size;
+            input->eof = 1;
+            if (input->owns_fd) close(fd);
+            input->owns_fd = 0;
+            return input;
+        }
+        if (size == 0) {
+            input->data = "";
+            input->eof = 1;
+            return input;
+        }
+    }
+
+    // Pipe, stdin hoặc mmap lỗi: đọc theo khối
+    input->capacity = XML_INPUT_CHUNK_SIZE;
+    input->buffer = (char*)malloc(input->capacity);
+    if (input->buffer == NULL) {
+        printf("[open_xml_input] Lỗi cấp phát bộ nhớ.\n");
+        close_xml_input(input);
+        return NULL;
+    }
+    input->data = input->buffer;
+    xml_input_refill(input, 0);
+    return input;
+}
+
+int xml_input_refill(XMLInput* input, size_t consumed) {
+    if (input == NULL || input->eof || input->error) return 0;
+
+    size_t rest = input->length - consumed;
+    memmove(input->buffer, input->data + consumed, rest);
+    input->data = input->buffer;
+    input->length = rest;
+
+    if (rest == input->capacity) {
+        char* grown = (char*)realloc(input->buffer, input->capacity * 2);
+        if (grown == NULL) {
+            printf("[xml_input_refill] Lỗi cấp phát bộ nhớ.\n");
+            input->error = 1;
+            return 0;
+        }
+        input->buffer = grown;
+        input->data = grown;
+        input->capacity *= 2;
+    }
+
+    ssize_t n;
+    do {
+        n = read(input->fd, input->buffer + rest, input->capacity - rest);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        printf("[xml_input_refill] Lỗi đọc dữ liệu.\n");
+        input->error = 1;
+        return 0;
+    }
+    if (n == 0) {
+        input->eof = 1;
+    }
+    input->length += (size_t)n;
+    input->total_read += (size_t)n;
+    return 1;
+}
+
+int xml_input_read_all(XMLInput* input) {
+    if (input == NULL) return 0;
+    while (xml_input_refill(input, 0)) {
+    }
+    return !input->error;
+}
+
+void close_xml_input(XMLInput* input) {
+    if (input == NULL) return;
+    if (input->map != NULL) munmap(input->map, input->map_size);
+    if (input->owns_fd) close(input->fd);
+    free(input->buffer);
+    free(input);
+}
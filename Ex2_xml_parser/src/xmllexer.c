@@ -0,0 +1,64 @@
+#include <string.h>
+#include <ctype.h>
+#include "XMLLexer.h"
+
+int next_xml_token(const char* pos, const char* limit, XMLToken* token) {
+    const char* start = memchr(pos, '<', limit - pos);
+    if (start == NULL) return XML_LEX_END;
+
+    token->start = start;
+    if (start + 1 < limit && start[1] == '?') {
+        token->type = XML_TOKEN_DECLARATION;
+    } else if (start + 1 < limit && start[1] == '/') {
+        token->type = XML_TOKEN_CLOSE;
+    } else {
+        token->type = XML_TOKEN_OPEN;
+    }
+
+    // Thẻ kết thúc tại dấu '>' đầu tiên sau dấu '<'
+    const char* close = memchr(start, '>', limit - start);
+    if (close == NULL) return XML_LEX_UNTERMINATED;
+    token->end = close + 1;
+    token->self_closing = 0;
+
+    const char* name_begin;
+    const char* name_end;
+    if (token->type == XML_TOKEN_DECLARATION) {
+        name_begin = name_end = start + 2;
+        token->body = token->body_end = name_end;
+    } else if (token->type == XML_TOKEN_CLOSE) {
+        name_begin = start + 2;
+        name_end = close;
+        token->body = token->body_end = close;
+    } else {
+        // Thẻ tự đóng: bỏ dấu '/' ngay trước '>'
+        const char* content_end = close;
+        if (content_end > start + 1 && content_end[-1] == '/') {
+            token->self_closing = 1;
+            content_end--;
+        }
+        // Tên thẻ mở dừng ở khoảng trắng đầu tiên, phần sau là thuộc tính
+        name_begin = start + 1;
+        name_end = memchr(name_begin, ' ', content_end - name_begin);
+        if (name_end == NULL) name_end = content_end;
+        token->body = name_end;
+        token->body_end = content_end;
+    }
+
+    // Cắt khoảng trắng hai đầu tên thẻ
+    while (name_begin < name_end && isspace((unsigned char)*name_begin)) name_begin++;
+    while (name_end > name_begin && isspace((unsigned char)name_end[-1])) name_end--;
+
+    token->name = name_begin;
+    token->name_length = name_end - name_begin;
+    return XML_LEX_OK;
+}
+
+size_t count_newlines(const char* begin, const char* end) {
+    size_t count = 0;
+    while (begin < end && (begin = memchr(begin, '\n', end - begin)) != NULL) {
+        count++;
+        begin++;
+    }
+    return count;
+}
@@ -0,0 +1,289 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "XMLTree.h"
+#include "XMLLexer.h"
+#include "XMLInput.h"
+
+// Phần nhỏ nhất giao cho một luồng, nhỏ hơn thì kiểm tra tuần tự sẽ nhanh hơn
+#define MIN_CHUNK_SIZE (256 * 1024)
+#define MAX_THREADS 64
+
+// Tham chiếu tới tên thẻ nằm trong buffer (không sao chép)
+typedef struct TagRef {
+    const char* name;
+    size_t length;
+    const char* at; // Vị trí dấu '<' của thẻ
+} TagRef;
+
+// Mảng động dùng làm stack/danh sách thẻ
+typedef struct TagRefArray {
+    TagRef* items;
+    size_t count;
+    size_t capacity;
+} TagRefArray;
+
+typedef enum ChunkErrorKind {
+    CHUNK_OK,
+    CHUNK_UNTERMINATED,     // Thẻ không có dấu '>'
+    CHUNK_INVALID_NAME,     // Tên thẻ không hợp lệ
+    CHUNK_MISMATCH,         // Thẻ đóng không khớp thẻ mở
+    CHUNK_OUT_OF_MEMORY
+} ChunkErrorKind;
+
+// Kết quả ghép cặp thẻ của một phần (chunk)
+typedef struct ChunkResult {
+    const char* begin;
+    const char* end;
+    const char* buffer_end;
+    TagRefArray unmatched_close; // Thẻ đóng chưa ghép được (xuất hiện khi stack cục bộ rỗng), theo thứ tự
+    TagRefArray open;            // Stack thẻ mở còn dư cuối phần, từ đáy lên đỉnh
+    ChunkErrorKind error;
+    XMLToken error_token;        // Thẻ gây lỗi
+    TagRef error_open;           // Thẻ mở bị so khớp sai (với CHUNK_MISMATCH)
+} ChunkResult;
+
+static int push_ref(TagRefArray* array, const char* name, size_t length, const char* at) {
+    if (array->count == array->capacity) {
+        size_t capacity = array->capacity ? array->capacity * 2 : 64;
+        TagRef* items = (TagRef*)realloc(array->items, capacity * sizeof(TagRef));
+        if (items == NULL) return 0;
+        array->items = items;
+        array->capacity = capacity;
+    }
+    TagRef* ref = &array->items[array->count++];
+    ref->name = name;
+    ref->length = length;
+    ref->at = at;
+    return 1;
+}
+
+static int ref_matches(const TagRef* open, const char* name, size_t length) {
+    return open->length == length && memcmp(open->name, name, length) == 0;
+}
+
+// Luồng xử lý một phần: ghép cặp thẻ cục bộ, lỗi cục bộ là lỗi thật vì thẻ mở ở đỉnh stack
+// thuộc chính phần này nên kiểm tra tuần tự cũng sẽ gặp đúng thẻ đó.
+static void* validate_chunk(void* arg) {
+    ChunkResult* chunk = (ChunkResult*)arg;
+    const char* pos = chunk->begin;
+    XMLToken token;
+    int status;
+
+    while ((status = next_xml_token(pos, chunk->buffer_end, &token)) != XML_LEX_END) {
+        if (token.start >= chunk->end) break;
+        if (status == XML_LEX_UNTERMINATED) {
+            chunk->error = CHUNK_UNTERMINATED;
+            chunk->error_token = token;
+            break;
+        }
+        pos = token.end;
+        if (token.type == XML_TOKEN_DECLARATION) continue;
+
+        if (tag_name_error(token.name, token.name_length) != NULL) {
+            chunk->error = CHUNK_INVALID_NAME;
+            chunk->error_token = token;
+            break;
+        }
+
+        if (token.type == XML_TOKEN_OPEN) {
+            if (token.self_closing) continue;
+            if (!push_ref(&chunk->open, token.name, token.name_length, token.start)) {
+                chunk->error = CHUNK_OUT_OF_MEMORY;
+                break;
+            }
+            continue;
+        }
+
+        if (chunk->open.count == 0) {
+            // Thẻ mở tương ứng nằm ở phần trước, để lại cho bước gộp
+            if (!push_ref(&chunk->unmatched_close, token.name, token.name_length, token.start)) {
+                chunk->error = CHUNK_OUT_OF_MEMORY;
+                break;
+            }
+            continue;
+        }
+
+        TagRef* top = &chunk->open.items[chunk->open.count - 1];
+        if (!ref_matches(top, token.name, token.name_length)) {
+            chunk->error = CHUNK_MISMATCH;
+            chunk->error_token = token;
+            chunk->error_open = *top;
+            break;
+        }
+        chunk->open.count--;
+    }
+    return NULL;
+}
+
+// Dấu '<' tại p là ranh giới an toàn nếu ký tự đặc biệt gần nhất phía trước là '>' (hoặc không có):
+// khi đó bộ kiểm tra tuần tự chắc chắn đang ở ngoài thẻ và sẽ bắt đầu một thẻ mới tại p.
+static const char* find_safe_boundary(const char* from, const char* buffer, const char* limit) {
+    const char* p = from;
+    while ((p = memchr(p, '<', limit - p)) != NULL) {
+        const char* q = p;
+        while (q > buffer && q[-1] != '<' && q[-1] != '>') q--;
+        if (q == buffer || q[-1] == '>') return p;
+        p++;
+    }
+    return NULL;
+}
+
+static void report_chunk_error(const char* buffer, const ChunkResult* chunk) {
+    const XMLToken* token = &chunk->error_token;
+    int line_number = 1 + (int)count_newlines(buffer, token->start);
+    int name_length = (int)token->name_length;
+
+    switch (chunk->error) {
+        case CHUNK_UNTERMINATED:
+            printf("[is_valid_xml_file_parallel] Lỗi: Thẻ %s không đóng ở dòng %d\n",
+                   token->type == XML_TOKEN_DECLARATION ? "khai báo XML" : (token->type == XML_TOKEN_CLOSE ? "đóng" : "mở"),
+                   line_number);
+            break;
+        case CHUNK_INVALID_NAME:
+            printf("[is_valid_tag] %s\n", tag_name_error(token->name, token->name_length));
+            if (token->type == XML_TOKEN_CLOSE) {
+                printf("[is_valid_xml_file_parallel] Tên thẻ đóng không hợp lệ ở dòng %d: </%.*s>\n", line_number, name_length, token->name);
+            } else {
+                printf("[is_valid_xml_file_parallel] Tên thẻ không hợp lệ ở dòng %d: <%.*s>\n", line_number, name_length, token->name);
+            }
+            break;
+        case CHUNK_MISMATCH:
+            printf("[is_valid_xml_file_parallel] Lỗi: Thẻ đóng </%.*s> không khớp với thẻ mở <%.*s> ở dòng %d\n",
+                   name_length, token->name, (int)chunk->error_open.length, chunk->error_open.name, line_number);
+            break;
+        case CHUNK_OUT_OF_MEMORY:
+            printf("[is_valid_xml_file_parallel] Lỗi cấp phát bộ nhớ.\n");
+            break;
+        default:
+            break;
+    }
+}
+
+int is_valid_xml_buffer_parallel(const char* buffer, size_t length, int num_threads) {
+    return is_valid_xml_buffer_parallel_ex(buffer, length, num_threads, MIN_CHUNK_SIZE);
+}
+
+int is_valid_xml_buffer_parallel_ex(const char* buffer, size_t length, int num_threads, size_t min_chunk) {
+    if (num_threads <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cores > 0 ? (int)cores : 1;
+    }
+    if (min_chunk == 0) min_chunk = 1;
+    if (num_threads > MAX_THREADS) num_threads = MAX_THREADS;
+    if ((size_t)num_threads > length / min_chunk) num_threads = (int)(length / min_chunk);
+    if (num_threads <= 1) return is_valid_xml_buffer(buffer, length);
+
+    const char* limit = buffer + length;
+    ChunkResult chunks[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+    int chunk_count = 0;
+
+    // Chia buffer thành các phần gần bằng nhau, ranh giới dịch tới dấu '<' an toàn kế tiếp
+    const char* begin = buffer;
+    for (int i = 1; i <= num_threads && begin < limit; i++) {
+        const char* end = limit;
+        if (i < num_threads) {
+            const char* target = buffer + (length / num_threads) * i;
+            if (target <= begin) target = begin + 1;
+            end = find_safe_boundary(target, buffer, limit);
+            if (end == NULL) end = limit;
+        }
+
+        ChunkResult* chunk = &chunks[chunk_count++];
+        memset(chunk, 0, sizeof(ChunkResult));
+        chunk->begin = begin;
+        chunk->end = end;
+        chunk->buffer_end = limit;
+        begin = end;
+    }
+
+    int started = 0;
+    for (int i = 1; i < chunk_count; i++) {
+        if (pthread_create(&threads[i], NULL, validate_chunk, &chunks[i]) != 0) break;
+        started = i;
+    }
+    validate_chunk(&chunks[0]);
+    for (int i = started + 1; i < chunk_count; i++) {
+        validate_chunk(&chunks[i]); // Tạo luồng thất bại thì xử lý ngay trên luồng hiện tại
+    }
+    for (int i = 1; i <= started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Gộp: duyệt các phần theo thứ tự, ghép thẻ đóng còn dư với stack toàn cục rồi đẩy thẻ mở còn dư vào
+    TagRefArray global = {NULL, 0, 0};
+    int valid = 1;
+    for (int i = 0; i < chunk_count && valid; i++) {
+        ChunkResult* chunk = &chunks[i];
+
+        for (size_t j = 0; j < chunk->unmatched_close.count && valid; j++) {
+            TagRef* close = &chunk->unmatched_close.items[j];
+            if (global.count == 0) {
+                printf("[is_valid_xml_file_parallel] Lỗi: Thẻ đóng </%.*s> không có thẻ mở tương ứng ở dòng %d\n",
+                       (int)close->length, close->name, 1 + (int)count_newlines(buffer, close->at));
+                valid = 0;
+            } else if (!ref_matches(&global.items[global.count - 1], close->name, close->length)) {
+                TagRef* open = &global.items[global.count - 1];
+                printf("[is_valid_xml_file_parallel] Lỗi: Thẻ đóng </%.*s> không khớp với thẻ mở <%.*s> ở dòng %d\n",
+                       (int)close->length, close->name, (int)open->length, open->name,
+                       1 + (int)count_newlines(buffer, close->at));
+                valid = 0;
+            } else {
+                global.count--;
+            }
+        }
+        if (!valid) break;
+
+        if (chunk->error != CHUNK_OK) {
+            report_chunk_error(buffer, chunk);
+            valid = 0;
+            break;
+        }
+
+        for (size_t j = 0; j < chunk->open.count; j++) {
+            TagRef* open = &chunk->open.items[j];
+            if (!push_ref(&global, open->name, open->length, open->at)) {
+                printf("[is_valid_xml_file_parallel] Lỗi cấp phát bộ nhớ.\n");
+                valid = 0;
+                break;
+            }
+        }
+    }
+
+    if (valid && global.count > 0) {
+        TagRef* top = &global.items[global.count - 1];
+        printf("[is_valid_xml_file_parallel] Lỗi: Còn thẻ chưa đóng: <%.*s>\n", (int)top->length, top->name);
+        valid = 0;
+    }
+
+    free(global.items);
+    for (int i = 0; i < chunk_count; i++) {
+        free(chunks[i].unmatched_close.items);
+        free(chunks[i].open.items);
+    }
+    return valid;
+}
+
+int is_valid_xml_file_parallel(const char* filename, int num_threads) {
+    // Chia khối cần toàn bộ dữ liệu: file thường được mmap, pipe/stdin được đọc hết vào buffer
+    XMLInput* input = open_xml_input(filename);
+    if (input == NULL) return 0;
+    if (!xml_input_read_all(input) || input->length == 0) {
+        printf("[is_valid_xml_file_parallel] Không đọc được dữ liệu: %s\n", filename);
+        close_xml_input(input);
+        return 0;
+    }
+
+    int valid = is_valid_xml_buffer_parallel(input->data, input->length, num_threads);
+    close_xml_input(input);
+
+    if (valid) {
+        printf("[is_valid_xml_file_parallel] File XML hợp lệ.\n");
+    } else {
+        printf("[is_valid_xml_file_parallel] File XML không hợp lệ.\n");
+    }
+    return valid;
+}
@@ -4,213 +4,236 @@
 #include <ctype.h>
 #include "XMLTree.h"
 #include "TagStack.h"
+#include "XMLLexer.h"
+#include "XMLInput.h"
 
-int is_valid_tag(const char* tag_name) {
+const char* tag_name_error(const char* tag_name, size_t length) {
     // Tên thẻ không được rỗng
-    if (tag_name == NULL || *tag_name == '\0') {
-        printf("[is_valid_tag] Tên thẻ không được rỗng.\n");
-        return 0;
+    if (tag_name == NULL || length == 0) {
+        return "Tên thẻ không được rỗng.";
     }
 
     // Tên thẻ không được bắt đầu bằng "xml" (phân biệt chữ hoa/thường)
-    if (strncasecmp(tag_name, "xml", 3) == 0) {
-        printf("[is_valid_tag] Tên thẻ không được bắt đầu bằng 'xml'.\n");
-        return 0;
+    if (length >= 3 && strncasecmp(tag_name, "xml", 3) == 0) {
+        return "Tên thẻ không được bắt đầu bằng 'xml'.";
     }
 
     // Ký tự đầu tiên phải là chữ cái hoặc dấu gạch dưới
-    if (!isalpha(tag_name[0]) && tag_name[0] != '_') {
-        printf("[is_valid_tag] Ký tự đầu tiên của tên thẻ phải là chữ cái hoặc dấu gạch dưới.\n");
-        return 0;
+    if (!isalpha((unsigned char)tag_name[0]) && tag_name[0] != '_') {
+        return "Ký tự đầu tiên của tên thẻ phải là chữ cái hoặc dấu gạch dưới.";
     }
 
     // Các ký tự còn lại chỉ được chứa chữ cái, số, dấu gạch dưới, dấu gạch ngang, dấu chấm.
-    for (int i = 1; tag_name[i] != '\0'; i++) {
-        if (!isalnum(tag_name[i]) && tag_name[i] != '_' && tag_name[i] != '-' && tag_name[i] != '.') {
-            printf("[is_valid_tag] Tên thẻ chỉ được chứa chữ cái, số, dấu gạch dưới, dấu gạch ngang và dấu chấm.\n");
-            return 0;
+    // Điều kiện này cũng loại bỏ dấu hai chấm (:) và khoảng trắng.
+    for (size_t i = 1; i < length; i++) {
+        char c = tag_name[i];
+        if (!isalnum((unsigned char)c) && c != '_' && c != '-' && c != '.') {
+            return "Tên thẻ chỉ được chứa chữ cái, số, dấu gạch dưới, dấu gạch ngang và dấu chấm.";
         }
     }
 
-    // Không chứa dấu hai chấm (:) trong tên thẻ
-    if (strchr(tag_name, ':') != NULL) {
-        printf("[is_valid_tag] Tên thẻ không được chứa dấu hai chấm (:).\n");
-        return 0;
-    }
+    return NULL; // Tên thẻ hợp lệ
+}
 
-    // Không chứa khoảng trắng trong tên thẻ
-    if (strchr(tag_name, ' ') != NULL) {
-        printf("[is_valid_tag] Tên thẻ không được chứa khoảng trắng.\n");
+int is_valid_tag(const char* tag_name) {
+    const char* error = tag_name_error(tag_name, tag_name ? strlen(tag_name) : 0);
+    if (error != NULL) {
+        printf("[is_valid_tag] %s\n", error);
         return 0;
     }
-
     return 1; // Tên thẻ hợp lệ
 }
 
-int is_valid_xml_file(const char* filename) {
+char* read_xml_file(const char* filename, size_t* length) {
     FILE* file = fopen(filename, "r");
     if (file == NULL) {
         printf("[read_xml_file] Không thể mở file: %s\n", filename);
-        return 0;
+        return NULL;
     }
 
     fseek(file, 0, SEEK_END);
     long filesize = ftell(file);
     rewind(file);
 
-    if (filesize == 0) {
+    if (filesize <= 0) {
         printf("[read_xml_file] File rỗng: %s\n", filename);
         fclose(file);
-        return 0;
+        return NULL;
     }
 
     char* buffer = (char*)malloc(filesize + 1);
     if (buffer == NULL) {
         printf("[read_xml_file] Lỗi cấp phát bộ nhớ.\n");
         fclose(file);
-        return 0;
+        return NULL;
     }
 
     size_t bytesRead = fread(buffer, 1, filesize, file);
     buffer[bytesRead] = '\0';
     fclose(file);
 
-    if (bytesRead != filesize) {
+    if (bytesRead != (size_t)filesize) {
         printf("[read_xml_file] Lỗi đọc file: %s\n", filename);
         free(buffer);
-        return 0;
+        return NULL;
     }
 
-    TagStack stack;
-    init_stack(&stack);
-
-    char* pos = buffer;
-    int valid = 1;
-    int line_number = 1;
+    *length = bytesRead;
+    return buffer;
+}
 
-    while ((pos = strchr(pos, '<')) != NULL) {
-        // Count newlines for better error reporting
-        for (char* p = buffer; p < pos; p++) {
-            if (*p == '\n') line_number++;
-        }
+// So sánh tên thẻ trong stack (chuỗi kết thúc '\0') với tên thẻ trong buffer
+static int tag_name_equals(const char* stored, const char* name, size_t length) {
+    return strncmp(stored, name, length) == 0 && stored[length] == '\0';
+}
 
-        // Skip XML declaration
-        if (*(pos + 1) == '?') {
-            pos = strchr(pos, '>');
-            if (pos == NULL) {
-                printf("[read_xml_file] Lỗi: Thẻ khai báo XML không đóng ở dòng %d\n", line_number);
-                valid = 0;
+// Trạng thái kiểm tra hợp lệ, giữ qua nhiều cửa sổ dữ liệu khi đọc đầu vào theo khối
+typedef struct XMLValidator {
+    TagStack stack;
+    int valid;
+    int line_number;
+} XMLValidator;
+
+// Kiểm tra các thẻ trong cửa sổ [buffer, buffer + length).
+// Nếu chưa hết đầu vào (eof = 0), thẻ bị cắt ngang ở cuối cửa sổ được để lại: consumed là vị trí của thẻ đó.
+// Trả về 1 nếu chưa phát hiện lỗi, 0 nếu đã có lỗi.
+static int validate_window(XMLValidator* v, const char* buffer, size_t length, int eof, size_t* consumed) {
+    const char* pos = buffer;
+    const char* limit = buffer + length;
+    const char* counted = buffer; // Vị trí đã đếm số dòng tới đó
+    XMLToken token;
+    int status;
+
+    while ((status = next_xml_token(pos, limit, &token)) != XML_LEX_END) {
+        // Đếm số dòng tăng dần để báo lỗi chính xác
+        v->line_number += (int)count_newlines(counted, token.start);
+        counted = token.start;
+
+        if (status == XML_LEX_UNTERMINATED) {
+            if (!eof) {
+                pos = token.start; // Đọc thêm dữ liệu rồi xử lý lại thẻ này
                 break;
             }
-            pos++;
-            continue;
+            if (token.type == XML_TOKEN_DECLARATION) {
+                printf("[read_xml_file] Lỗi: Thẻ khai báo XML không đóng ở dòng %d\n", v->line_number);
+            } else if (token.type == XML_TOKEN_CLOSE) {
+                printf("[read_xml_file] Lỗi: Thẻ đóng không hợp lệ ở dòng %d\n", v->line_number);
+            } else {
+                printf("[read_xml_file] Lỗi: Thẻ mở không đóng ở dòng %d\n", v->line_number);
+            }
+            v->valid = 0;
+            break;
         }
+        pos = token.end;
 
-        // Handle closing tag
-        if (*(pos + 1) == '/') {
-            char* end_tag = strchr(pos, '>');
-            if (end_tag == NULL) {
-                printf("[read_xml_file] Lỗi: Thẻ đóng không hợp lệ ở dòng %d\n", line_number);
-                valid = 0;
-                break;
-            }
+        // Bỏ qua khai báo XML
+        if (token.type == XML_TOKEN_DECLARATION) continue;
 
-            size_t tag_length = end_tag - pos - 2;
-            char* tag_name = (char*)malloc(tag_length + 1);
-            if (tag_name == NULL) {
-                printf("[read_xml_file] Lỗi cấp phát bộ nhớ cho tên thẻ đóng.\n");
-                free(buffer);
-                return 0;
-            }
-            strncpy(tag_name, pos + 2, tag_length);
-            tag_name[tag_length] = '\0';
-
-            // Trim whitespace
-            char* end = tag_name + strlen(tag_name) - 1;
-            while (end > tag_name && isspace(*end)) *end-- = '\0';
-            while (isspace(*tag_name)) tag_name++;
-
-            if (!is_valid_tag(tag_name)) {
-                printf("[read_xml_file] Tên thẻ đóng không hợp lệ ở dòng %d: </%s>\n", line_number, tag_name);
-                free(tag_name);
-                valid = 0;
+        int name_length = (int)token.name_length;
+        const char* error = tag_name_error(token.name, token.name_length);
+
+        // Xử lý thẻ đóng
+        if (token.type == XML_TOKEN_CLOSE) {
+            if (error != NULL) {
+                printf("[is_valid_tag] %s\n", error);
+                printf("[read_xml_file] Tên thẻ đóng không hợp lệ ở dòng %d: </%.*s>\n", v->line_number, name_length, token.name);
+                v->valid = 0;
                 break;
             }
 
-            if (is_empty(&stack)) {
-                printf("[read_xml_file] Lỗi: Thẻ đóng </%s> không có thẻ mở tương ứng ở dòng %d\n", tag_name, line_number);
-                free(tag_name);
-                valid = 0;
+            if (is_empty(&v->stack)) {
+                printf("[read_xml_file] Lỗi: Thẻ đóng </%.*s> không có thẻ mở tương ứng ở dòng %d\n", name_length, token.name, v->line_number);
+                v->valid = 0;
                 break;
             }
 
-            char* popped_tag = pop(&stack);
-            if (strcmp(popped_tag, tag_name) != 0) {
-                printf("[read_xml_file] Lỗi: Thẻ đóng </%s> không khớp với thẻ mở <%s> ở dòng %d\n", 
-                       tag_name, popped_tag, line_number);
-                free(tag_name);
+            char* popped_tag = pop(&v->stack);
+            if (!tag_name_equals(popped_tag, token.name, token.name_length)) {
+                printf("[read_xml_file] Lỗi: Thẻ đóng </%.*s> không khớp với thẻ mở <%s> ở dòng %d\n",
+                       name_length, token.name, popped_tag, v->line_number);
                 free(popped_tag);
-                valid = 0;
+                v->valid = 0;
                 break;
             }
-
-            free(tag_name);
             free(popped_tag);
-            pos = end_tag + 1;
             continue;
         }
 
-        // Handle opening tag
-        char* end_tag = strchr(pos, '>');
-        if (end_tag == NULL) {
-            printf("[read_xml_file] Lỗi: Thẻ mở không đóng ở dòng %d\n", line_number);
-            valid = 0;
+        // Xử lý thẻ mở
+        if (error != NULL) {
+            printf("[is_valid_tag] %s\n", error);
+            printf("[read_xml_file] Tên thẻ không hợp lệ ở dòng %d: <%.*s>\n", v->line_number, name_length, token.name);
+            v->valid = 0;
             break;
         }
 
-        size_t tag_length = end_tag - pos - 1;
-        char* tag_name = (char*)malloc(tag_length + 1);
-        if (tag_name == NULL) {
-            printf("[read_xml_file] Lỗi cấp phát bộ nhớ cho tên thẻ.\n");
-            free(buffer);
-            return 0;
-        }
-        strncpy(tag_name, pos + 1, tag_length);
-        tag_name[tag_length] = '\0';
-
-        // Trim whitespace and handle attributes
-        char* space_pos = strchr(tag_name, ' ');
-        if (space_pos != NULL) *space_pos = '\0';
+        // Thẻ tự đóng vừa mở vừa đóng, không cần đưa vào stack
+        if (token.self_closing) continue;
 
-        // Trim any remaining whitespace
-        char* end = tag_name + strlen(tag_name) - 1;
-        while (end > tag_name && isspace(*end)) *end-- = '\0';
-        while (isspace(*tag_name)) tag_name++;
-
-        if (!is_valid_tag(tag_name)) {
-            printf("[read_xml_file] Tên thẻ không hợp lệ ở dòng %d: <%s>\n", line_number, tag_name);
+        char* tag_name = strndup(token.name, token.name_length);
+        if (tag_name == NULL || !push(&v->stack, tag_name)) {
+            printf("[read_xml_file] Lỗi đẩy thẻ vào stack ở dòng %d.\n", v->line_number);
             free(tag_name);
-            valid = 0;
+            v->valid = 0;
             break;
         }
-
-        if (!push(&stack, tag_name)) {
-            printf("[read_xml_file] Lỗi đẩy thẻ vào stack ở dòng %d.\n", line_number);
-            free(tag_name);
-            free(buffer);
-            return 0;
-        }
         free(tag_name);
-        pos = end_tag + 1;
     }
 
-    free(buffer);
-    if (!is_empty(&stack)) {
-        printf("[read_xml_file] Lỗi: Còn thẻ chưa đóng: <%s>\n", peek(&stack));
-        valid = 0;
+    if (status == XML_LEX_END) pos = limit;
+    v->line_number += (int)count_newlines(counted, pos);
+    *consumed = pos - buffer;
+    return v->valid;
+}
+
+// Kết thúc kiểm tra: mọi thẻ mở phải đã được đóng
+static int finish_validation(XMLValidator* v) {
+    if (v->valid && !is_empty(&v->stack)) {
+        printf("[read_xml_file] Lỗi: Còn thẻ chưa đóng: <%s>\n", peek(&v->stack));
+        v->valid = 0;
     }
+    free_stack(&v->stack);
+    return v->valid;
+}
+
+int is_valid_xml_buffer(const char* buffer, size_t length) {
+    XMLValidator v;
+    init_stack(&v.stack);
+    v.valid = 1;
+    v.line_number = 1;
+
+    size_t consumed;
+    validate_window(&v, buffer, length, 1, &consumed);
+    return finish_validation(&v);
+}
+
+int is_valid_xml_input(XMLInput* input) {
+    XMLValidator v;
+    init_stack(&v.stack);
+    v.valid = 1;
+    v.line_number = 1;
+
+    // File được mmap nằm trọn trong một cửa sổ; pipe/stdin được kiểm tra dần theo từng khối
+    size_t consumed = 0;
+    while (validate_window(&v, input->data, input->length, input->eof, &consumed) && !input->eof) {
+        if (!xml_input_refill(input, consumed)) break;
+    }
+    if (input->error) v.valid = 0;
+    return finish_validation(&v);
+}
+
+int is_valid_xml_file(const char* filename) {
+    XMLInput* input = open_xml_input(filename);
+    if (input == NULL) return 0;
+    if (input->eof && input->length == 0) {
+        printf("[read_xml_file] File rỗng: %s\n", filename);
+        close_xml_input(input);
+        return 0;
+    }
+
+    int valid = is_valid_xml_input(input);
+    close_xml_input(input);
 
-    free_stack(&stack);
     if (valid) {
         printf("[read_xml_file] File XML hợp lệ.\n");
     } else {
@@ -226,14 +249,212 @@ TreeNode* create_node(const char* tag_name) {
         return NULL;
     }
     newNode->tag_name = strdup(tag_name);
-    newNode->attributes = NULL;
+    memset(&newNode->attributes, 0, sizeof(AttributeList));
     newNode->text = NULL;
     newNode->first_child = NULL;
     newNode->next_sibling = NULL;
     newNode->parent = NULL;
+    // Node mới cần được kiểm tra; trước lần kiểm tra đầu tiên được tính là hợp lệ trong bộ đếm của cha
+    newNode->self_dirty = 1;
+    newNode->subtree_dirty = 0;
+    newNode->self_valid = 1;
+    newNode->subtree_valid = 1;
+    newNode->invalid_children = 0;
+    newNode->in_dirty_list = 0;
+    newNode->dirty_children = NULL;
+    newNode->next_dirty = NULL;
     return newNode;
 }
 
+// Lan truyền cờ subtree_dirty lên các tổ tiên và đưa từng node vào danh sách cần kiểm tra của cha.
+// Dừng sớm khi gặp node đã được đánh dấu: các tổ tiên của nó chắc chắn cũng đã được đánh dấu.
+static void mark_subtree_dirty(TreeNode* node) {
+    while (node != NULL) {
+        int was_dirty = node->subtree_dirty;
+        node->subtree_dirty = 1;
+        if (node->parent != NULL && !node->in_dirty_list) {
+            node->next_dirty = node->parent->dirty_children;
+            node->parent->dirty_children = node;
+            node->in_dirty_list = 1;
+        }
+        if (was_dirty) break;
+        node = node->parent;
+    }
+}
+
+void mark_dirty(TreeNode* node) {
+    if (node == NULL) return;
+    node->self_dirty = 1;
+    mark_subtree_dirty(node);
+}
+
+// Gỡ node con khỏi cây trước khi xoá: bỏ khỏi danh sách cần kiểm tra và bộ đếm con không hợp lệ của cha
+static void detach_validation_state(TreeNode* parent, TreeNode* child) {
+    if (child->in_dirty_list) {
+        TreeNode** link = &parent->dirty_children;
+        while (*link != NULL && *link != child) link = &(*link)->next_dirty;
+        if (*link != NULL) *link = child->next_dirty;
+        child->in_dirty_list = 0;
+    }
+    if (!child->subtree_valid) parent->invalid_children--;
+    mark_subtree_dirty(parent); // Tập con của parent đã đổi, cần kết hợp lại kết quả
+}
+
+// Gắn nội dung text (đã cắt khoảng trắng hai đầu) vào node, nối tiếp bằng một dấu cách nếu node đã có text
+static int append_text(TreeNode* node, const char* begin, const char* end) {
+    while (begin < end && isspace((unsigned char)*begin)) begin++;
+    while (end > begin && isspace((unsigned char)end[-1])) end--;
+    if (begin == end) return 1;
+
+    size_t old_length = node->text ? strlen(node->text) : 0;
+    size_t separator = old_length > 0 ? 1 : 0;
+    char* text = (char*)realloc(node->text, old_length + separator + (end - begin) + 1);
+    if (text == NULL) return 0;
+    if (separator) text[old_length++] = ' ';
+    memcpy(text + old_length, begin, end - begin);
+    text[old_length + (end - begin)] = '\0';
+    node->text = text;
+    return 1;
+}
+
+// Phân tích danh sách thuộc tính dạng name="value" hoặc name='value' trong [begin, end)
+static int parse_attributes(TreeNode* node, const char* begin, const char* end) {
+    const char* p = begin;
+    while (1) {
+        while (p < end && isspace((unsigned char)*p)) p++;
+        if (p == end) break;
+
+        const char* name = p;
+        while (p < end && *p != '=' && !isspace((unsigned char)*p)) p++;
+        size_t name_length = p - name;
+        while (p < end && isspace((unsigned char)*p)) p++;
+        if (name_length == 0 || p == end || *p != '=') return 0;
+        p++;
+        while (p < end && isspace((unsigned char)*p)) p++;
+        if (p == end || (*p != '"' && *p != '\'')) return 0;
+
+        char quote = *p++;
+        const char* value = p;
+        while (p < end && *p != quote) p++;
+        if (p == end) return 0;
+
+        char* attr_name = strndup(name, name_length);
+        char* attr_value = strndup(value, p - value);
+        if (attr_name != NULL && attr_value != NULL) {
+            add_attribute(node, attr_name, attr_value);
+        }
+        free(attr_name);
+        free(attr_value);
+        p++;
+    }
+    return 1;
+}
+
+TreeNode* parse_xml_buffer(const char* buffer, size_t length) {
+    const char* pos = buffer;
+    const char* limit = buffer + length;
+    TreeNode* root = NULL;
+    TreeNode* current = NULL;  // Thẻ đang mở
+    TreeNode* previous = NULL; // Con cuối cùng của current, để nối anh em trong O(1)
+    XMLToken token;
+    int status;
+
+    while ((status = next_xml_token(pos, limit, &token)) != XML_LEX_END) {
+        if (status == XML_LEX_UNTERMINATED) {
+            printf("[parse_xml_buffer] Lỗi: Thẻ không đóng tại vị trí %ld.\n", (long)(token.start - buffer));
+            delete_tag(root);
+            return NULL;
+        }
+        if (current != NULL && !append_text(current, pos, token.start)) {
+            printf("[parse_xml_buffer] Lỗi cấp phát bộ nhớ cho nội dung thẻ.\n");
+            delete_tag(root);
+            return NULL;
+        }
+        pos = token.end;
+        if (token.type == XML_TOKEN_DECLARATION) continue;
+
+        const char* error = tag_name_error(token.name, token.name_length);
+        if (error != NULL) {
+            printf("[parse_xml_buffer] Tên thẻ không hợp lệ <%.*s>: %s\n", (int)token.name_length, token.name, error);
+            delete_tag(root);
+            return NULL;
+        }
+
+        if (token.type == XML_TOKEN_CLOSE) {
+            if (current == NULL || strncmp(current->tag_name, token.name, token.name_length) != 0 ||
+                current->tag_name[token.name_length] != '\0') {
+                printf("[parse_xml_buffer] Lỗi: Thẻ đóng </%.*s> không khớp.\n", (int)token.name_length, token.name);
+                delete_tag(root);
+                return NULL;
+            }
+            previous = current;
+            current = current->parent;
+            continue;
+        }
+
+        if (current == NULL && root != NULL) {
+            printf("[parse_xml_buffer] Lỗi: Tài liệu có nhiều hơn một thẻ gốc.\n");
+            delete_tag(root);
+            return NULL;
+        }
+
+        char* tag_name = strndup(token.name, token.name_length);
+        TreeNode* node = tag_name ? create_node(tag_name) : NULL;
+        free(tag_name);
+        if (node == NULL) {
+            delete_tag(root);
+            return NULL;
+        }
+
+        // Nối node mới vào cây trước khi phân tích thuộc tính để khi lỗi vẫn giải phóng được
+        node->parent = current;
+        if (current == NULL) {
+            root = node;
+        } else if (previous != NULL) {
+            previous->next_sibling = node;
+        } else {
+            current->first_child = node;
+        }
+
+        mark_dirty(node);
+
+        if (!parse_attributes(node, token.body, token.body_end)) {
+            printf("[parse_xml_buffer] Lỗi: Thuộc tính không hợp lệ trong thẻ <%s>.\n", node->tag_name);
+            delete_tag(root);
+            return NULL;
+        }
+
+        if (token.self_closing) {
+            previous = node;
+        } else {
+            current = node;
+            previous = NULL;
+        }
+    }
+
+    if (current != NULL) {
+        printf("[parse_xml_buffer] Lỗi: Còn thẻ chưa đóng: <%s>\n", current->tag_name);
+        delete_tag(root);
+        return NULL;
+    }
+    return root;
+}
+
+TreeNode* parse_xml_file(const char* filename) {
+    // File được mmap thì phân tích tại chỗ; pipe/stdin phải đọc hết vì cây chứa toàn bộ tài liệu
+    XMLInput* input = open_xml_input(filename);
+    if (input == NULL) return NULL;
+    if (!xml_input_read_all(input) || input->length == 0) {
+        printf("[parse_xml_file] Không đọc được dữ liệu: %s\n", filename);
+        close_xml_input(input);
+        return NULL;
+    }
+
+    TreeNode* root = parse_xml_buffer(input->data, input->length);
+    close_xml_input(input);
+    return root;
+}
+
 void add_tag(TreeNode* parent, const char* tag_name) {
     if (parent == NULL || tag_name == NULL) {
         printf("[add_tag] Thẻ cha hoặc tên thẻ không hợp lệ.\n");
@@ -254,6 +475,7 @@ void add_tag(TreeNode* parent, const char* tag_name) {
         }
         sibling->next_sibling = newNode;
     }
+    mark_dirty(newNode);
 }
 
 // Xoá node con đầu tiên có tag_name khớp khỏi danh sách con của parent
@@ -270,6 +492,7 @@ void delete_child_by_tag_name(TreeNode* parent, const char* tag_name) {
                 parent->first_child = curr->next_sibling;
             }
             curr->next_sibling = NULL; // Ngắt liên kết để tránh xoá nhầm các node khác
+            detach_validation_state(parent, curr);
             delete_tag(curr);
             return;
         }
@@ -279,54 +502,113 @@ void delete_child_by_tag_name(TreeNode* parent, const char* tag_name) {
 }
 
 void delete_tag(TreeNode* node) {
-    if (node == NULL) return;
+    // Duyệt anh em bằng vòng lặp, chỉ đệ quy theo chiều sâu để không tràn stack với node có nhiều con
+    while (node != NULL) {
+        TreeNode* sibling = node->next_sibling;
+
+        // Giải phóng thuộc tính
+        for (size_t i = 0; i < node->attributes.count; i++) {
+            Attribute* attr = attribute_at(node, i);
+            free(attr->name);
+            free(attr->value);
+        }
+        free(node->attributes.overflow);
+        free(node->attributes.index);
+        memset(&node->attributes, 0, sizeof(AttributeList));
+
+        // Giải phóng text
+        if (node->text != NULL) {
+            free(node->text);
+            node->text = NULL;
+        }
+
+        // Giải phóng con
+        delete_tag(node->first_child);
+        node->first_child = NULL;
+        node->next_sibling = NULL;
 
-    // Giải phóng thuộc tính
-    Attribute* attr = node->attributes;
-    while (attr != NULL) {
-        Attribute* next_attr = attr->next;
-        if (attr->name != NULL) free(attr->name);
-        if (attr->value != NULL) free(attr->value);
-        free(attr);
-        attr = next_attr;
+        // Giải phóng node hiện tại
+        if (node->tag_name != NULL) {
+            free(node->tag_name);
+            node->tag_name = NULL;
+        }
+        free(node);
+        node = sibling;
     }
-    node->attributes = NULL;
+}
+
+uint32_t hash_xml_name(const char* name) {
+    uint32_t hash = 2166136261u; // FNV-1a
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+size_t attribute_count(const TreeNode* node) {
+    return node ? node->attributes.count : 0;
+}
 
-    // Giải phóng text
-    if (node->text != NULL) {
-        free(node->text);
-        node->text = NULL;
+Attribute* attribute_at(const TreeNode* node, size_t i) {
+    const AttributeList* list = &node->attributes;
+    if (i < XML_INLINE_ATTRIBUTES) return (Attribute*)&list->inline_items[i];
+    return &list->overflow[i - XML_INLINE_ATTRIBUTES];
+}
+
+// Ghi vị trí thuộc tính vào bảng băm (bảng luôn còn ô trống vì hệ số tải <= 1/2)
+static void index_attribute(AttributeList* list, const char* name, size_t position) {
+    size_t mask = list->index_capacity - 1;
+    size_t slot = hash_xml_name(name) & mask;
+    while (list->index[slot] != 0) slot = (slot + 1) & mask;
+    list->index[slot] = position + 1;
+}
+
+// Dựng lại bảng băm với kích thước đủ cho thêm một thuộc tính
+static int rebuild_attribute_index(TreeNode* node) {
+    AttributeList* list = &node->attributes;
+    size_t capacity = list->index_capacity ? list->index_capacity : 4 * XML_INLINE_ATTRIBUTES;
+    while ((list->count + 1) * 2 > capacity) capacity *= 2;
+
+    size_t* index = (size_t*)calloc(capacity, sizeof(size_t));
+    if (index == NULL) return 0;
+    free(list->index);
+    list->index = index;
+    list->index_capacity = capacity;
+    for (size_t i = 0; i < list->count; i++) {
+        index_attribute(list, attribute_at(node, i)->name, i);
     }
+    return 1;
+}
 
-    // Lưu lại con trỏ trước khi giải phóng
-    TreeNode* child = node->first_child;
-    TreeNode* sibling = node->next_sibling;
-    node->first_child = NULL;
-    node->next_sibling = NULL;
+Attribute* find_attribute(const TreeNode* node, const char* attr_name) {
+    if (node == NULL || attr_name == NULL) return NULL;
+    const AttributeList* list = &node->attributes;
 
-    // Giải phóng con và anh em
-    delete_tag(child);
-    delete_tag(sibling);
+    // Ít thuộc tính: duyệt trực tiếp phần inline
+    if (list->index == NULL) {
+        for (size_t i = 0; i < list->count; i++) {
+            if (strcmp(list->inline_items[i].name, attr_name) == 0) return (Attribute*)&list->inline_items[i];
+        }
+        return NULL;
+    }
 
-    // Giải phóng node hiện tại
-    if (node->tag_name != NULL) {
-        free(node->tag_name);
-        node->tag_name = NULL;
+    size_t mask = list->index_capacity - 1;
+    for (size_t slot = hash_xml_name(attr_name) & mask; list->index[slot] != 0; slot = (slot + 1) & mask) {
+        Attribute* attr = attribute_at(node, list->index[slot] - 1);
+        if (strcmp(attr->name, attr_name) == 0) return attr;
     }
-    free(node);
+    return NULL;
 }
 
 void change_attribute(TreeNode* node, const char* attr_name, const char* new_value) {
     if (node == NULL || attr_name == NULL || new_value == NULL) return;
 
-    Attribute* attr = node->attributes;
-    while (attr != NULL) {
-        if (strcmp(attr->name, attr_name) == 0) {
-            free(attr->value);
-            attr->value = strdup(new_value);
-            return;
-        }
-        attr = attr->next;
+    Attribute* attr = find_attribute(node, attr_name);
+    if (attr != NULL) {
+        free(attr->value);
+        attr->value = strdup(new_value);
+        mark_dirty(node);
     }
 }
 
@@ -336,15 +618,112 @@ void add_attribute(TreeNode* node, const char* attr_name, const char* value) {
         return;
     }
 
-    Attribute* new_attr = (Attribute*)malloc(sizeof(Attribute));
-    if (new_attr == NULL) {
-        printf("[add_attribute] Lỗi cấp phát bộ nhớ cho thuộc tính.\n");
+    // XML không cho phép thuộc tính trùng tên: cập nhật giá trị cũ
+    if (find_attribute(node, attr_name) != NULL) {
+        change_attribute(node, attr_name, value);
         return;
     }
+
+    AttributeList* list = &node->attributes;
+    if (list->count >= XML_INLINE_ATTRIBUTES) {
+        size_t overflow_count = list->count - XML_INLINE_ATTRIBUTES;
+        if (overflow_count == list->overflow_capacity) {
+            size_t capacity = list->overflow_capacity ? list->overflow_capacity * 2 : XML_INLINE_ATTRIBUTES;
+            Attribute* overflow = (Attribute*)realloc(list->overflow, capacity * sizeof(Attribute));
+            if (overflow == NULL) {
+                printf("[add_attribute] Lỗi cấp phát bộ nhớ cho thuộc tính.\n");
+                return;
+            }
+            list->overflow = overflow;
+            list->overflow_capacity = capacity;
+        }
+        if ((list->count + 1) * 2 > list->index_capacity && !rebuild_attribute_index(node)) {
+            printf("[add_attribute] Lỗi cấp phát bộ nhớ cho bảng băm thuộc tính.\n");
+            return;
+        }
+    }
+
+    Attribute* new_attr = attribute_at(node, list->count);
     new_attr->name = strdup(attr_name);
     new_attr->value = strdup(value);
-    new_attr->next = node->attributes;
-    node->attributes = new_attr;
+    if (list->index != NULL) index_attribute(list, new_attr->name, list->count);
+    list->count++;
+    mark_dirty(node);
+}
+
+void set_text(TreeNode* node, const char* text) {
+    if (node == NULL) return;
+    free(node->text);
+    node->text = text ? strdup(text) : NULL;
+    mark_dirty(node);
+}
+
+// Kiểm tra riêng một node (không tính con)
+static int is_valid_node(const TreeNode* node) {
+    if (node->tag_name == NULL || tag_name_error(node->tag_name, strlen(node->tag_name)) != NULL) return 0;
+    if (node->text != NULL && strchr(node->text, '<') != NULL) return 0;
+
+    // add_attribute không tạo thuộc tính trùng tên nên chỉ cần kiểm tra từng thuộc tính
+    for (size_t i = 0; i < node->attributes.count; i++) {
+        const Attribute* attr = attribute_at(node, i);
+        if (attr->name == NULL || attr->value == NULL) return 0;
+        if (tag_name_error(attr->name, strlen(attr->name)) != NULL) return 0;
+        if (strpbrk(attr->value, "<\"") != NULL) return 0;
+    }
+    return 1;
+}
+
+// Kiểm tra lại cây con của node. Khi subtree_valid của node đổi, bộ đếm invalid_children của cha được cập nhật
+// ngay tại đây, nên kết quả của cha luôn khớp dù cây con được kiểm tra từ cha hay được gọi trực tiếp.
+static int revalidate_node(TreeNode* node) {
+    if (!node->subtree_dirty && !node->self_dirty) return node->subtree_valid;
+
+    if (node->self_dirty) {
+        node->self_valid = is_valid_node(node);
+        node->self_dirty = 0;
+    }
+
+    // Chỉ kiểm tra lại các con nằm trong danh sách, các con khác giữ nguyên kết quả đã đếm
+    TreeNode* child = node->dirty_children;
+    node->dirty_children = NULL;
+    while (child != NULL) {
+        TreeNode* next = child->next_dirty;
+        child->next_dirty = NULL;
+        child->in_dirty_list = 0;
+        revalidate_node(child);
+        child = next;
+    }
+
+    int was_valid = node->subtree_valid;
+    node->subtree_valid = node->self_valid && node->invalid_children == 0;
+    node->subtree_dirty = 0;
+    if (node->parent != NULL && was_valid != node->subtree_valid) {
+        node->parent->invalid_children += was_valid ? 1 : -1;
+    }
+    return node->subtree_valid;
+}
+
+int revalidate_xml_tree(TreeNode* root) {
+    if (root == NULL) return 1;
+    int was_valid = root->subtree_valid;
+    int now_valid = revalidate_node(root);
+    // Gọi trực tiếp trên một cây con: bộ đếm của cha đã đổi nhưng subtree_valid của cha và các tổ tiên
+    // chưa được kết hợp lại, nên đánh dấu để lần kiểm tra từ gốc tính lại
+    if (root->parent != NULL && was_valid != now_valid) mark_subtree_dirty(root->parent);
+    return now_valid;
+}
+
+TreeNode* next_preorder_node(TreeNode* node, TreeNode* root, int* depth) {
+    if (node->first_child != NULL) {
+        (*depth)++;
+        return node->first_child;
+    }
+    while (node != root) {
+        if (node->next_sibling != NULL) return node->next_sibling;
+        node = node->parent;
+        (*depth)--;
+    }
+    return NULL;
 }
 
 int search_and_print_tag(TreeNode* root, const char* tag_name) {
@@ -402,10 +781,9 @@ void write_tag(FILE* file, TreeNode* node, int indent) {
 
     // In thẻ mở và thuộc tính
     fprintf(file, "<%s", node->tag_name);
-    Attribute* attr = node->attributes;
-    while (attr) {
+    for (size_t i = 0; i < node->attributes.count; i++) {
+        Attribute* attr = attribute_at(node, i);
         fprintf(file, " %s=\"%s\"", attr->name, attr->value);
-        attr = attr->next;
     }
 
     // Nếu có con hoặc có text
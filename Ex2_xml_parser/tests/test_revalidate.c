@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <string.h>
+#include "XMLTree.h"
+
+// Kiểm tra tăng dần khi một cây con được kiểm tra lại trực tiếp trước khi kiểm tra từ gốc:
+// bộ đếm invalid_children của các tổ tiên phải theo kịp thay đổi của cây con.
+
+static int failures = 0;
+
+static void expect(int actual, int expected, const char* what) {
+    if (actual != expected) {
+        printf("[test_revalidate] SAI: %s: nhận %d, mong đợi %d\n", what, actual, expected);
+        failures++;
+    }
+}
+
+int main(void) {
+    const char* xml = "<root><a><b><c/></b></a><d/></root>";
+    TreeNode* root = parse_xml_buffer(xml, strlen(xml));
+    if (root == NULL) {
+        printf("[test_revalidate] Không dựng được cây.\n");
+        return 1;
+    }
+    TreeNode* a = root->first_child;
+    TreeNode* b = a->first_child;
+    TreeNode* c = b->first_child;
+    expect(revalidate_xml_tree(root), 1, "cây ban đầu");
+
+    // Cháu không hợp lệ, kiểm tra cây con a trước rồi mới tới gốc
+    add_attribute(b, "x", "<bad");
+    expect(revalidate_xml_tree(a), 0, "cây con a sau khi thêm thuộc tính sai");
+    expect(revalidate_xml_tree(root), 0, "gốc sau khi đã kiểm tra cây con a");
+
+    // Sửa lại, cũng kiểm tra cây con trước
+    change_attribute(b, "x", "good");
+    expect(revalidate_xml_tree(a), 1, "cây con a sau khi sửa");
+    expect(revalidate_xml_tree(root), 1, "gốc sau khi sửa");
+
+    // Kiểm tra trực tiếp từ node sâu nhất, rồi từ một node ở giữa, rồi từ gốc
+    set_text(c, "a < b");
+    expect(revalidate_xml_tree(c), 0, "node c có text sai");
+    expect(revalidate_xml_tree(b), 0, "cây con b");
+    expect(revalidate_xml_tree(root), 0, "gốc với node c sai");
+    set_text(c, "ok");
+    expect(revalidate_xml_tree(c), 1, "node c sau khi sửa");
+    expect(revalidate_xml_tree(root), 1, "gốc sau khi sửa node c");
+
+    // Hai cây con sai, một cây được sửa và kiểm tra trực tiếp: gốc vẫn sai vì cây còn lại
+    add_attribute(c, "y", "<");
+    add_attribute(a->next_sibling, "z", "\"");
+    expect(revalidate_xml_tree(root), 0, "gốc với hai cây con sai");
+    change_attribute(c, "y", "fine");
+    expect(revalidate_xml_tree(a), 1, "cây con a sau khi sửa c");
+    expect(revalidate_xml_tree(root), 0, "gốc khi d vẫn sai");
+    change_attribute(a->next_sibling, "z", "fine");
+    expect(revalidate_xml_tree(root), 1, "gốc sau khi sửa cả hai");
+
+    free_xml_tree(root);
+    if (failures == 0) printf("[test_revalidate] OK\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,484 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "mem_alloc.h"
+#include "bitmap_alloc.h"
+#include "tlsf_alloc.h"
+#include "flat_buddy.h"
+
+// Benchmark cấp phát/giải phóng ngẫu nhiên (churn) trên cùng một chuỗi thao tác cho:
+//   first fit, best fit, worst fit, next fit (boundary tag, tìm trên cây AVL theo kích thước / theo địa chỉ),
+//   bitmap phân cấp, TLSF và buddy mảng phẳng.
+// Log được tắt (out = NULL) để chỉ đo chi phí thuật toán.
+// Mỗi thao tác là một cặp giải phóng + cấp phát. Cách dùng: ./mem_bench [số thao tác] [số khối sống]
+// Phần thứ hai đo churn với vài kích thước đối tượng cố định, so sánh slab cache với first fit, best fit và TLSF.
+// Phần thứ ba đo các buffer tăng dần kích thước: realloc_mem so với cấp phát mới + sao chép + giải phóng.
+// Phần thứ tư mô phỏng các request: mỗi request cấp phát nhiều đối tượng nhỏ rồi tất cả chết cùng lúc,
+// so sánh first fit (giải phóng từng đối tượng) với region (reset một lần).
+// Phần thứ năm chạy buddy arena (mmap nhiều GB, commit trang khi cần) và so RSS khi có/không trả trang lúc gộp khối lớn.
+
+#define POOL_SIZE (16u << 20) // 16 MB
+#define MIN_REQUEST 16
+#define MAX_REQUEST 512
+
+typedef enum Strategy { FIRST_FIT, BEST_FIT, WORST_FIT, NEXT_FIT, BITMAP, TLSF, BUDDY, STRATEGY_COUNT } Strategy;
+static const char* strategy_names[STRATEGY_COUNT] = {"first fit", "best fit", "worst fit", "next fit", "bitmap", "tlsf", "buddy"};
+
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+typedef struct Allocators {
+    MemoryManagement* manager;
+    BitmapAllocator* bitmap;
+    TLSFAllocator* tlsf;
+    FlatBuddySystem* buddy;
+} Allocators;
+
+static void* allocate(Strategy strategy, Allocators* a, size_t size) {
+    switch (strategy) {
+        case FIRST_FIT: return firstfit_malloc(a->manager, size, NULL);
+        case BEST_FIT:  return bestfit_malloc(a->manager, size, NULL);
+        case WORST_FIT: return worstfit_malloc(a->manager, size, NULL);
+        case NEXT_FIT:  return nextfit_malloc(a->manager, size, NULL);
+        case BITMAP:    return bitmap_malloc(a->bitmap, size, NULL);
+        case TLSF:      return tlsf_malloc(a->tlsf, size, NULL);
+        default:        return flat_buddy_malloc(a->buddy, size, NULL);
+    }
+}
+
+static void run(Strategy strategy, int operations, int max_live) {
+    void* pool = malloc(POOL_SIZE);
+    Allocators a = {NULL, NULL, NULL, NULL};
+    if (strategy == BITMAP) {
+        a.bitmap = create_bitmap_allocator(pool, POOL_SIZE, NULL);
+    } else if (strategy == TLSF) {
+        a.tlsf = create_tlsf_allocator(pool, POOL_SIZE, NULL);
+    } else if (strategy == BUDDY) {
+        a.buddy = create_flat_buddy_system(pool, POOL_SIZE, NULL);
+    } else {
+        a.manager = initialize_memory_manager(pool, POOL_SIZE, NULL);
+    }
+    void** slots = (void**)calloc(max_live, sizeof(void*));
+    if (pool == NULL || (a.manager == NULL && a.bitmap == NULL && a.tlsf == NULL && a.buddy == NULL) || slots == NULL) {
+        printf("[mem_bench] Lỗi cấp phát bộ nhớ.\n");
+        exit(1);
+    }
+
+    // Giai đoạn 1: cấp phát tới max_live khối. Giai đoạn 2 (được đo): mỗi bước giải phóng một khối ngẫu nhiên
+    // rồi cấp phát một khối mới, danh sách vùng trống bị phân mảnh dần.
+    unsigned int seed = 12345;
+    int live = 0, failures = 0;
+    while (live < max_live) {
+        seed = seed * 1103515245u + 12345u;
+        size_t size = MIN_REQUEST + (seed >> 8) % (MAX_REQUEST - MIN_REQUEST + 1);
+        slots[live] = allocate(strategy, &a, size);
+        if (slots[live] == NULL) break;
+        live++;
+    }
+
+    double start = now_ms();
+    for (int i = 0; i < operations; i++) {
+        seed = seed * 1103515245u + 12345u;
+        if (live > 0) {
+            int victim = (seed >> 4) % live;
+            if (strategy == BITMAP) {
+                free_bitmap(a.bitmap, slots[victim], NULL);
+            } else if (strategy == TLSF) {
+                free_tlsf(a.tlsf, slots[victim], NULL);
+            } else if (strategy == BUDDY) {
+                free_flat_buddy(a.buddy, slots[victim], NULL);
+            } else {
+                free_mem(a.manager, slots[victim], NULL);
+            }
+            slots[victim] = slots[--live];
+        }
+
+        seed = seed * 1103515245u + 12345u;
+        size_t size = MIN_REQUEST + (seed >> 8) % (MAX_REQUEST - MIN_REQUEST + 1);
+        void* ptr = allocate(strategy, &a, size);
+        if (ptr == NULL) {
+            failures++;
+            continue;
+        }
+        slots[live++] = ptr;
+    }
+    double elapsed = now_ms() - start;
+
+    // Phân mảnh = 1 - khối trống lớn nhất / tổng vùng trống (bitmap và buddy không có danh sách khối trống chung nên bỏ qua)
+    size_t free_blocks = 0, free_bytes = 0, largest = 0;
+    if (a.manager != NULL) {
+        for (MemoryBlock* block = a.manager->free_list; block != NULL; block = block->next) {
+            free_blocks++;
+            free_bytes += block->size;
+            if (block->size > largest) largest = block->size;
+        }
+    } else if (a.tlsf != NULL) {
+        TLSFStats stats;
+        tlsf_get_stats(a.tlsf, &stats);
+        free_blocks = stats.free_blocks;
+        free_bytes = stats.free_bytes;
+        largest = stats.largest_free_block;
+    }
+    printf("%-12s %12.1f %14.0f %10d ", strategy_names[strategy], elapsed * 1e6 / operations,
+           operations / elapsed * 1e3, failures);
+    if (a.bitmap != NULL || a.buddy != NULL) {
+        printf("%12s %11s\n", "-", "-");
+    } else {
+        double fragmentation = free_bytes == 0 ? 0.0 : 100.0 * (1.0 - (double)largest / free_bytes);
+        printf("%12zu %10.1f%%\n", free_blocks, fragmentation);
+    }
+
+    free(slots);
+    if (a.bitmap != NULL) {
+        cleanup_bitmap_allocator(a.bitmap, NULL);
+        free(pool);
+    } else if (a.tlsf != NULL) {
+        cleanup_tlsf_allocator(a.tlsf, NULL);
+        free(pool);
+    } else if (a.buddy != NULL) {
+        cleanup_flat_buddy_system(a.buddy, NULL);
+        free(pool);
+    } else {
+        cleanup_memory_manager(a.manager, NULL); // Giải phóng cả pool
+    }
+}
+
+// Churn với các đối tượng kích thước cố định (kiểu node, request, session...): mỗi kích thước có một slab cache riêng
+static const size_t fixed_sizes[] = {32, 96, 240};
+#define FIXED_SIZE_COUNT (sizeof(fixed_sizes) / sizeof(fixed_sizes[0]))
+
+typedef enum FixedStrategy { FIXED_FIRST_FIT, FIXED_BEST_FIT, FIXED_TLSF, FIXED_SLAB, FIXED_STRATEGY_COUNT } FixedStrategy;
+static const char* fixed_strategy_names[FIXED_STRATEGY_COUNT] = {"first fit", "best fit", "tlsf", "slab"};
+
+typedef struct FixedSlot {
+    void* ptr;
+    int size_index;
+} FixedSlot;
+
+static void* fixed_allocate(FixedStrategy strategy, MemoryManagement* manager, TLSFAllocator* tlsf, SlabCache** caches,
+                            int size_index) {
+    switch (strategy) {
+        case FIXED_FIRST_FIT: return firstfit_malloc(manager, fixed_sizes[size_index], NULL);
+        case FIXED_BEST_FIT:  return bestfit_malloc(manager, fixed_sizes[size_index], NULL);
+        case FIXED_TLSF:      return tlsf_malloc(tlsf, fixed_sizes[size_index], NULL);
+        default:              return slab_malloc(caches[size_index], NULL);
+    }
+}
+
+static void fixed_free(FixedStrategy strategy, MemoryManagement* manager, TLSFAllocator* tlsf, SlabCache** caches,
+                       FixedSlot* slot) {
+    switch (strategy) {
+        case FIXED_TLSF: free_tlsf(tlsf, slot->ptr, NULL); break;
+        case FIXED_SLAB: slab_free(caches[slot->size_index], slot->ptr, NULL); break;
+        default:         free_mem(manager, slot->ptr, NULL); break;
+    }
+}
+
+static void run_fixed(FixedStrategy strategy, int operations, int max_live) {
+    void* pool = malloc(POOL_SIZE);
+    MemoryManagement* manager = NULL;
+    TLSFAllocator* tlsf = NULL;
+    SlabCache* caches[FIXED_SIZE_COUNT] = {NULL};
+    if (strategy == FIXED_TLSF) {
+        tlsf = create_tlsf_allocator(pool, POOL_SIZE, NULL);
+    } else {
+        manager = initialize_memory_manager(pool, POOL_SIZE, NULL);
+    }
+    if (strategy == FIXED_SLAB && manager != NULL) {
+        for (size_t i = 0; i < FIXED_SIZE_COUNT; i++) caches[i] = create_slab_cache(manager, fixed_sizes[i], NULL);
+    }
+    FixedSlot* slots = (FixedSlot*)calloc(max_live, sizeof(FixedSlot));
+    if (pool == NULL || (manager == NULL && tlsf == NULL) || slots == NULL) {
+        printf("[mem_bench] Lỗi cấp phát bộ nhớ.\n");
+        exit(1);
+    }
+
+    unsigned int seed = 12345;
+    int live = 0, failures = 0;
+    while (live < max_live) {
+        seed = seed * 1103515245u + 12345u;
+        slots[live].size_index = (seed >> 8) % FIXED_SIZE_COUNT;
+        slots[live].ptr = fixed_allocate(strategy, manager, tlsf, caches, slots[live].size_index);
+        if (slots[live].ptr == NULL) break;
+        live++;
+    }
+
+    double start = now_ms();
+    for (int i = 0; i < operations; i++) {
+        seed = seed * 1103515245u + 12345u;
+        if (live > 0) {
+            int victim = (seed >> 4) % live;
+            fixed_free(strategy, manager, tlsf, caches, &slots[victim]);
+            slots[victim] = slots[--live];
+        }
+
+        seed = seed * 1103515245u + 12345u;
+        int size_index = (seed >> 8) % FIXED_SIZE_COUNT;
+        void* ptr = fixed_allocate(strategy, manager, tlsf, caches, size_index);
+        if (ptr == NULL) {
+            failures++;
+            continue;
+        }
+        slots[live].ptr = ptr;
+        slots[live].size_index = size_index;
+        live++;
+    }
+    double elapsed = now_ms() - start;
+
+    printf("%-12s %12.1f %14.0f %10d\n", fixed_strategy_names[strategy], elapsed * 1e6 / operations,
+           operations / elapsed * 1e3, failures);
+
+    for (int i = 0; i < live; i++) fixed_free(strategy, manager, tlsf, caches, &slots[i]);
+    free(slots);
+    for (size_t i = 0; i < FIXED_SIZE_COUNT; i++) {
+        if (caches[i] != NULL) destroy_slab_cache(caches[i], NULL);
+    }
+    if (tlsf != NULL) {
+        cleanup_tlsf_allocator(tlsf, NULL);
+        free(pool);
+    } else {
+        cleanup_memory_manager(manager, NULL); // Giải phóng cả pool
+    }
+}
+
+// Lấp đầy pool bằng một slab cache tới khi hết trang: các trang phải nằm sát nhau nên gần như cả pool chứa đối tượng
+static void run_slab_fill(size_t object_size) {
+    void* pool = malloc(POOL_SIZE);
+    MemoryManagement* manager = pool != NULL ? initialize_memory_manager(pool, POOL_SIZE, NULL) : NULL;
+    SlabCache* cache = manager != NULL ? create_slab_cache(manager, object_size, NULL) : NULL;
+    if (cache == NULL) {
+        printf("[mem_bench] Lỗi cấp phát bộ nhớ.\n");
+        exit(1);
+    }
+    size_t objects = 0;
+    while (slab_malloc(cache, NULL) != NULL) objects++;
+    printf("Lấp đầy pool bằng slab %zu bytes: %zu đối tượng, %zu trang, trang phủ %.1f%% pool, dữ liệu %.1f%% pool\n",
+           object_size, objects, cache->page_count, 100.0 * cache->page_count * cache->page_size / POOL_SIZE,
+           100.0 * objects * object_size / POOL_SIZE);
+    destroy_slab_cache(cache, NULL);
+    cleanup_memory_manager(manager, NULL); // Giải phóng cả pool
+}
+
+// Các buffer lớn dần từng bước nhỏ (như vector, chuỗi được nối thêm); buffer đạt GROWTH_MAX_SIZE thì bị giải phóng
+#define GROWTH_BUFFERS 256
+#define GROWTH_MAX_SIZE 16384
+
+static void run_growth(int use_realloc, int operations) {
+    void* pool = malloc(POOL_SIZE);
+    MemoryManagement* manager = pool != NULL ? initialize_memory_manager(pool, POOL_SIZE, NULL) : NULL;
+    if (manager == NULL) {
+        printf("[mem_bench] Lỗi cấp phát bộ nhớ.\n");
+        exit(1);
+    }
+    char* buffers[GROWTH_BUFFERS] = {NULL};
+    size_t sizes[GROWTH_BUFFERS] = {0};
+    size_t copied = 0;
+    int failures = 0;
+
+    unsigned int seed = 12345;
+    double start = now_ms();
+    for (int i = 0; i < operations; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int index = (seed >> 8) % GROWTH_BUFFERS;
+        size_t new_size = sizes[index] + 16 + (seed >> 20) % 241;
+        if (new_size > GROWTH_MAX_SIZE) {
+            free_mem(manager, buffers[index], NULL);
+            buffers[index] = NULL;
+            sizes[index] = 0;
+            continue;
+        }
+
+        char* grown;
+        if (use_realloc) {
+            grown = (char*)realloc_mem(manager, buffers[index], new_size, NULL);
+            if (grown != NULL && buffers[index] != NULL && grown != buffers[index]) copied += sizes[index];
+        } else {
+            grown = (char*)firstfit_malloc(manager, new_size, NULL);
+            if (grown != NULL && buffers[index] != NULL) {
+                memcpy(grown, buffers[index], sizes[index]);
+                copied += sizes[index];
+                free_mem(manager, buffers[index], NULL);
+            }
+        }
+        if (grown == NULL) {
+            failures++;
+            continue;
+        }
+        grown[new_size - 1] = (char)i; // Ghi vào phần mới như chương trình thật
+        buffers[index] = grown;
+        sizes[index] = new_size;
+    }
+    double elapsed = now_ms() - start;
+
+    printf("%-22s %12.1f %14.0f %10d %14.1f\n", use_realloc ? "realloc_mem" : "cấp phát + sao chép",
+           elapsed * 1e6 / operations, operations / elapsed * 1e3, failures, (double)copied / operations);
+    cleanup_memory_manager(manager, NULL); // Giải phóng cả pool
+}
+
+// Mỗi request cấp phát 16..REQUEST_MAX_OBJECTS đối tượng 16..256 bytes; heap đã bị phân mảnh sẵn bởi các đối tượng
+// sống lâu (cấp phát xen kẽ rồi giải phóng một nửa), giống một server đang chạy
+#define REQUEST_MAX_OBJECTS 256
+#define REQUEST_BACKGROUND_OBJECTS 4000
+
+static void run_requests(int use_region, int operations) {
+    void* pool = malloc(POOL_SIZE);
+    MemoryManagement* manager = pool != NULL ? initialize_memory_manager(pool, POOL_SIZE, NULL) : NULL;
+    Region* region = manager != NULL && use_region ? create_region(manager, 0, NULL) : NULL;
+    if (manager == NULL || (use_region && region == NULL)) {
+        printf("[mem_bench] Lỗi cấp phát bộ nhớ.\n");
+        exit(1);
+    }
+    unsigned int seed = 12345;
+    void* background[REQUEST_BACKGROUND_OBJECTS];
+    for (int i = 0; i < REQUEST_BACKGROUND_OBJECTS; i++) {
+        seed = seed * 1103515245u + 12345u;
+        background[i] = firstfit_malloc(manager, 16 + (seed >> 8) % 241, NULL);
+    }
+    for (int i = 0; i < REQUEST_BACKGROUND_OBJECTS; i += 2) free_mem(manager, background[i], NULL);
+
+    char* objects[REQUEST_MAX_OBJECTS];
+    int requests = 0, failures = 0, objects_total = 0;
+    double start = now_ms();
+    for (; objects_total < operations; requests++) {
+        seed = seed * 1103515245u + 12345u;
+        int count = 16 + (int)((seed >> 8) % (REQUEST_MAX_OBJECTS - 15));
+        for (int i = 0; i < count; i++) {
+            seed = seed * 1103515245u + 12345u;
+            size_t size = 16 + (seed >> 8) % 241;
+            objects[i] = (char*)(use_region ? region_malloc(region, size, NULL) : firstfit_malloc(manager, size, NULL));
+            if (objects[i] == NULL) {
+                failures++;
+                continue;
+            }
+            objects[i][0] = (char)i;
+        }
+        if (use_region) {
+            region_reset(region, NULL);
+        } else {
+            for (int i = 0; i < count; i++) {
+                if (objects[i] != NULL) free_mem(manager, objects[i], NULL);
+            }
+        }
+        objects_total += count;
+    }
+    double elapsed = now_ms() - start;
+
+    printf("%-22s %12.1f %14.0f %10d %12.1f\n", use_region ? "region (reset)" : "first fit (free từng cái)",
+           elapsed * 1e6 / objects_total, requests / elapsed * 1e3, failures, elapsed * 1e3 / requests);
+    if (region != NULL) destroy_region(region, NULL);
+    cleanup_memory_manager(manager, NULL); // Giải phóng cả pool
+}
+
+// Arena 8 GB; mỗi chu kỳ cấp phát các khối 64 KB..4 MB tới ARENA_PEAK_BYTES dữ liệu sống (ghi vào mọi trang),
+// rồi giải phóng ngẫu nhiên đến khi chỉ còn 1/16
+#define ARENA_RESERVE ((size_t)8 << 30)
+#define ARENA_PEAK_BYTES ((size_t)512 << 20)
+#define ARENA_CYCLES 4
+#define ARENA_MAX_BLOCKS 8192
+
+static size_t resident_bytes(void) {
+    FILE* statm = fopen("/proc/self/statm", "r");
+    unsigned long pages = 0, resident = 0;
+    if (statm == NULL) return 0;
+    if (fscanf(statm, "%lu %lu", &pages, &resident) != 2) resident = 0;
+    fclose(statm);
+    return resident * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+static void run_arena(size_t release_size) {
+    FlatBuddySystem* arena = create_flat_buddy_arena(ARENA_RESERVE, release_size, NULL);
+    if (arena == NULL) {
+        printf("[mem_bench] Lỗi: Không thể tạo arena %zu bytes.\n", ARENA_RESERVE);
+        exit(1);
+    }
+    static char* blocks[ARENA_MAX_BLOCKS];
+    static size_t sizes[ARENA_MAX_BLOCKS];
+    int count = 0, operations = 0;
+    size_t live = 0, base_rss = resident_bytes(), peak_rss = 0, low_rss = 0;
+    long page = sysconf(_SC_PAGESIZE);
+
+    unsigned int seed = 12345;
+    double start = now_ms();
+    for (int cycle = 0; cycle < ARENA_CYCLES; cycle++) {
+        while (live < ARENA_PEAK_BYTES && count < ARENA_MAX_BLOCKS) {
+            seed = seed * 1103515245u + 12345u;
+            size_t size = (size_t)65536 << ((seed >> 16) % 7);
+            char* block = (char*)flat_buddy_malloc(arena, size, NULL);
+            if (block == NULL) break;
+            for (size_t offset = 0; offset < size; offset += page) block[offset] = (char)cycle;
+            blocks[count] = block;
+            sizes[count++] = size;
+            live += size;
+            operations++;
+        }
+        size_t rss = resident_bytes() - base_rss;
+        if (rss > peak_rss) peak_rss = rss;
+        while (live > ARENA_PEAK_BYTES / 16) {
+            seed = seed * 1103515245u + 12345u;
+            int index = (int)((seed >> 8) % (unsigned int)count);
+            free_flat_buddy(arena, blocks[index], NULL);
+            live -= sizes[index];
+            blocks[index] = blocks[--count];
+            sizes[index] = sizes[count];
+            operations++;
+        }
+        low_rss = resident_bytes() - base_rss;
+    }
+    double elapsed = now_ms() - start;
+
+    char label[64];
+    if (release_size >= ARENA_RESERVE) {
+        snprintf(label, sizeof(label), "không trả trang");
+    } else {
+        snprintf(label, sizeof(label), "trả khối >= %zu KB", arena->release_size >> 10);
+    }
+    printf("%-20s %12.1f %12zu %12zu %12zu %10zu %10zu\n", label, elapsed * 1e6 / operations, peak_rss >> 20,
+           low_rss >> 20, live >> 20, arena->commit_calls, arena->release_calls);
+    cleanup_flat_buddy_system(arena, NULL); // munmap cả arena
+}
+
+int main(int argc, char** argv) {
+    int operations = argc > 1 ? atoi(argv[1]) : 200000;
+    int max_live = argc > 2 ? atoi(argv[2]) : 4000;
+    if (operations <= 0 || max_live <= 0) {
+        printf("Cách dùng: %s [số thao tác] [số khối sống]\n", argv[0]);
+        return 1;
+    }
+
+    printf("Pool: %u bytes | Thao tác: %d | Khối sống: %d | Kích thước: %d..%d bytes\n\n",
+           POOL_SIZE, operations, max_live, MIN_REQUEST, MAX_REQUEST);
+    printf("%-12s %12s %14s %10s %12s %11s\n", "Chiến lược", "ns/cặp", "cặp/giây", "thất bại", "khối trống", "phân mảnh");
+    for (int s = 0; s < STRATEGY_COUNT; s++) run((Strategy)s, operations, max_live);
+
+    printf("\nĐối tượng kích thước cố định: %zu / %zu / %zu bytes\n\n", fixed_sizes[0], fixed_sizes[1], fixed_sizes[2]);
+    printf("%-12s %12s %14s %10s\n", "Chiến lược", "ns/cặp", "cặp/giây", "thất bại");
+    for (int s = 0; s < FIXED_STRATEGY_COUNT; s++) run_fixed((FixedStrategy)s, operations, max_live);
+    printf("\n");
+    for (size_t i = 0; i < FIXED_SIZE_COUNT; i++) run_slab_fill(fixed_sizes[i]);
+
+    printf("\nBuffer tăng dần (first fit, %d buffer, tối đa %d bytes)\n\n", GROWTH_BUFFERS, GROWTH_MAX_SIZE);
+    printf("%-22s %12s %14s %10s %14s\n", "Cách làm", "ns/thao tác", "thao tác/giây", "thất bại", "byte chép/t.tác");
+    run_growth(0, operations);
+    run_growth(1, operations);
+
+    printf("\nĐối tượng theo request (16..%d đối tượng 16..256 bytes mỗi request, first fit làm nền)\n\n",
+           REQUEST_MAX_OBJECTS);
+    printf("%-22s %12s %14s %10s %12s\n", "Cách làm", "ns/đối tượng", "request/giây", "thất bại", "µs/request");
+    run_requests(0, operations);
+    run_requests(1, operations);
+
+    printf("\nBuddy arena %zu GB, dữ liệu sống tối đa %zu MB, %d chu kỳ cấp phát/giải phóng (RSS tính bằng MB)\n\n",
+           ARENA_RESERVE >> 30, ARENA_PEAK_BYTES >> 20, ARENA_CYCLES);
+    printf("%-20s %12s %12s %12s %12s %10s %10s\n", "Chế độ", "ns/thao tác", "RSS đỉnh", "RSS sau free",
+           "dữ liệu sống", "mprotect", "madvise");
+    run_arena(ARENA_RESERVE);
+    run_arena((size_t)1 << 20);
+    run_arena((size_t)16 << 20);
+    return 0;
+}
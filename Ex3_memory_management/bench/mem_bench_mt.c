@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include "thread_cache.h"
+#include "multi_arena.h"
+
+// Benchmark đa luồng cho ConcurrentAllocator: mỗi luồng churn trên tập khối riêng (giải phóng một khối ngẫu nhiên
+// rồi cấp phát khối mới), so sánh khi có và không có cache theo luồng với từng chiến lược trung tâm.
+// Phần thứ hai so sánh một arena với N arena (MultiArenaAllocator) trên cùng kiểu churn, thêm các đợt mỗi luồng
+// giải phóng toàn bộ khối của luồng bên cạnh (remote free) rồi cấp phát lại tập khối của mình.
+// Cách dùng: ./mem_bench_mt [số thao tác mỗi luồng] [số luồng tối đa]
+
+#define POOL_SIZE (64u << 20) // 64 MB
+#define LIVE_PER_THREAD 256
+#define MIN_REQUEST 16
+#define MAX_REQUEST 512
+
+static const char* backend_names[] = {"first fit", "tlsf", "buddy"};
+
+typedef struct Worker {
+    pthread_t thread;
+    ConcurrentAllocator* allocator;
+    int operations;
+    unsigned int seed;
+    int failures;
+} Worker;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static size_t next_size(unsigned int* seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    return MIN_REQUEST + (*seed >> 8) % (MAX_REQUEST - MIN_REQUEST + 1);
+}
+
+static void* run_worker(void* arg) {
+    Worker* worker = (Worker*)arg;
+    void* slots[LIVE_PER_THREAD];
+    int live = 0;
+    while (live < LIVE_PER_THREAD) {
+        slots[live] = concurrent_malloc(worker->allocator, next_size(&worker->seed));
+        if (slots[live] == NULL) break;
+        live++;
+    }
+    for (int i = 0; i < worker->operations; i++) {
+        if (live > 0) {
+            worker->seed = worker->seed * 1103515245u + 12345u;
+            int victim = (worker->seed >> 4) % live;
+            concurrent_free(worker->allocator, slots[victim]);
+            slots[victim] = slots[--live];
+        }
+        void* ptr = concurrent_malloc(worker->allocator, next_size(&worker->seed));
+        if (ptr == NULL) {
+            worker->failures++;
+            continue;
+        }
+        slots[live++] = ptr;
+    }
+    for (int i = 0; i < live; i++) concurrent_free(worker->allocator, slots[i]);
+    return NULL;
+}
+
+static void run(ConcurrentBackend backend, int cache_enabled, int threads, int operations) {
+    void* pool = malloc(POOL_SIZE);
+    ConcurrentAllocator* allocator = pool != NULL ? create_concurrent_allocator(pool, POOL_SIZE, backend, cache_enabled, NULL) : NULL;
+    Worker* workers = (Worker*)calloc(threads, sizeof(Worker));
+    if (allocator == NULL || workers == NULL) {
+        printf("[mem_bench_mt] Lỗi khởi tạo bộ cấp phát.\n");
+        exit(1);
+    }
+
+    double start = now_ms();
+    for (int t = 0; t < threads; t++) {
+        workers[t].allocator = allocator;
+        workers[t].operations = operations;
+        workers[t].seed = 12345u + t;
+        pthread_create(&workers[t].thread, NULL, run_worker, &workers[t]);
+    }
+    int failures = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+        failures += workers[t].failures;
+    }
+    double elapsed = now_ms() - start;
+
+    double total_operations = (double)operations * threads;
+    printf("%-10s %-6s %6d %14.0f %14.4f %10d\n", backend_names[backend], cache_enabled ? "có" : "không", threads,
+           total_operations / elapsed * 1e3, allocator->lock_acquisitions / total_operations, failures);
+
+    free(workers);
+    cleanup_concurrent_allocator(allocator, NULL);
+    free(pool);
+}
+
+#define ARENA_ROUNDS 8 // Số đợt remote free trong mỗi lần chạy
+
+typedef struct ArenaWorker {
+    pthread_t thread;
+    MultiArenaAllocator* allocator;
+    pthread_barrier_t* barrier;
+    struct ArenaWorker* neighbour;
+    void* slots[LIVE_PER_THREAD];
+    int live;
+    int operations;
+    unsigned int seed;
+    int failures;
+} ArenaWorker;
+
+static void fill_slots(ArenaWorker* worker) {
+    while (worker->live < LIVE_PER_THREAD) {
+        void* ptr = multi_arena_malloc(worker->allocator, next_size(&worker->seed));
+        if (ptr == NULL) {
+            worker->failures++;
+            break;
+        }
+        worker->slots[worker->live++] = ptr;
+    }
+}
+
+static void* run_arena_worker(void* arg) {
+    ArenaWorker* worker = (ArenaWorker*)arg;
+    fill_slots(worker);
+    for (int round = 0; round < ARENA_ROUNDS; round++) {
+        for (int i = 0; i < worker->operations / ARENA_ROUNDS; i++) {
+            if (worker->live > 0) {
+                worker->seed = worker->seed * 1103515245u + 12345u;
+                int victim = (worker->seed >> 4) % worker->live;
+                multi_arena_free(worker->allocator, worker->slots[victim]);
+                worker->slots[victim] = worker->slots[--worker->live];
+            }
+            void* ptr = multi_arena_malloc(worker->allocator, next_size(&worker->seed));
+            if (ptr == NULL) {
+                worker->failures++;
+                continue;
+            }
+            worker->slots[worker->live++] = ptr;
+        }
+        // Giải phóng toàn bộ khối của luồng bên cạnh (luồng đó đang chờ ở barrier), rồi cấp phát lại tập của mình
+        pthread_barrier_wait(worker->barrier);
+        for (int i = 0; i < worker->neighbour->live; i++) multi_arena_free(worker->allocator, worker->neighbour->slots[i]);
+        worker->neighbour->live = 0;
+        pthread_barrier_wait(worker->barrier);
+        fill_slots(worker);
+    }
+    for (int i = 0; i < worker->live; i++) multi_arena_free(worker->allocator, worker->slots[i]);
+    return NULL;
+}
+
+static void run_arenas(ConcurrentBackend backend, int arena_count, int threads, int operations) {
+    void* pool = aligned_alloc(MULTI_ARENA_ALIGN, POOL_SIZE);
+    MultiArenaAllocator* allocator = pool != NULL ? create_multi_arena_allocator(pool, POOL_SIZE, arena_count, backend, NULL) : NULL;
+    ArenaWorker* workers = (ArenaWorker*)calloc(threads, sizeof(ArenaWorker));
+    if (allocator == NULL || workers == NULL) {
+        printf("[mem_bench_mt] Lỗi khởi tạo bộ cấp phát.\n");
+        exit(1);
+    }
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, threads);
+
+    double start = now_ms();
+    for (int t = 0; t < threads; t++) {
+        workers[t].allocator = allocator;
+        workers[t].barrier = &barrier;
+        workers[t].neighbour = &workers[(t + 1) % threads];
+        workers[t].operations = operations;
+        workers[t].seed = 12345u + t;
+        pthread_create(&workers[t].thread, NULL, run_arena_worker, &workers[t]);
+    }
+    int failures = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+        failures += workers[t].failures;
+    }
+    double elapsed = now_ms() - start;
+
+    multi_arena_drain(allocator);
+    size_t locks = 0, remote = 0;
+    for (int i = 0; i < arena_count; i++) {
+        locks += allocator->arenas[i].lock_acquisitions;
+        remote += allocator->arenas[i].remote_frees_drained;
+    }
+    double total_operations = (double)operations * threads;
+    printf("%-10s %6d %6d %14.0f %14.4f %12zu %10d\n", backend_names[backend], arena_count, threads,
+           total_operations / elapsed * 1e3, locks / total_operations, remote, failures);
+
+    pthread_barrier_destroy(&barrier);
+    free(workers);
+    cleanup_multi_arena_allocator(allocator, NULL);
+    free(pool);
+}
+
+int main(int argc, char** argv) {
+    int operations = argc > 1 ? atoi(argv[1]) : 200000;
+    int max_threads = argc > 2 ? atoi(argv[2]) : 8;
+    if (operations <= 0 || max_threads <= 0) {
+        printf("Cách dùng: %s [số thao tác mỗi luồng] [số luồng tối đa]\n", argv[0]);
+        return 1;
+    }
+
+    printf("Pool: %u bytes | Thao tác mỗi luồng: %d | Khối sống mỗi luồng: %d\n\n", POOL_SIZE, operations, LIVE_PER_THREAD);
+    printf("%-10s %-6s %6s %14s %14s %10s\n", "Trung tâm", "Cache", "Luồng", "cặp/giây", "khoá/cặp", "thất bại");
+    for (int backend = CONCURRENT_BACKEND_FIRST_FIT; backend <= CONCURRENT_BACKEND_BUDDY; backend++) {
+        for (int cache_enabled = 0; cache_enabled <= 1; cache_enabled++) {
+            for (int threads = 1; threads <= max_threads; threads *= 2) {
+                run((ConcurrentBackend)backend, cache_enabled, threads, operations);
+            }
+        }
+    }
+
+    printf("\nNhiều arena: %d đợt giải phóng chéo (remote free) mỗi lần chạy\n\n", ARENA_ROUNDS);
+    printf("%-10s %6s %6s %14s %14s %12s %10s\n", "Arena", "Số", "Luồng", "cặp/giây", "khoá/cặp", "remote free", "thất bại");
+    for (int backend = CONCURRENT_BACKEND_FIRST_FIT; backend <= CONCURRENT_BACKEND_BUDDY; backend++) {
+        for (int threads = 2; threads <= max_threads; threads *= 2) {
+            run_arenas((ConcurrentBackend)backend, 1, threads, operations);
+            run_arenas((ConcurrentBackend)backend, threads, threads, operations);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,378 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mem_alloc.h"
+#include "buddy_alloc.h"
+#include "flat_buddy.h"
+#include "mem_stats.h"
+
+// Benchmark phát lại trace (trace replay): cùng một chuỗi thao tác cấp phát/giải phóng được chạy lại trên
+// first fit, best fit, next fit, worst fit, buddy (cây) và buddy mảng phẳng.
+//
+// Trace là file văn bản, mỗi dòng một thao tác (dòng bắt đầu bằng '#' là chú thích):
+//   a <id> <size>    cấp phát size bytes, đặt tên khối là id (số nguyên không âm, không lặp lại)
+//   f <id>           giải phóng khối id
+// Khi không truyền file, chương trình sinh các trace tổng hợp (kích thước, thời gian sống, cấp phát theo đợt).
+//
+// Kết quả là bảng CSV trên stdout, mỗi dòng một cặp (trace, chiến lược):
+//   ops_per_sec         số thao tác (cấp phát + giải phóng) mỗi giây, không tính thời gian lấy mẫu
+//   avg_search_length   số nút cây trung bình đã đi qua mỗi lần cấp phát (trống với buddy)
+//   peak_fragmentation  phân mảnh ngoài lớn nhất trong các lần lấy mẫu, 1 - khối trống lớn nhất / tổng vùng trống
+//   utilization         số byte người dùng đang giữ / số byte bị chiếm khỏi pool, tại thời điểm nhiều byte sống nhất
+//
+// Cách dùng: ./trace_bench [số lần cấp phát] [-w thư mục] [-s file] [file trace ...]
+//   -w thư mục   ghi các trace tổng hợp ra thư mục (định dạng như trên) để phát lại hoặc chỉnh sửa sau
+//   -s file      ghi snapshot thống kê (mem_stats.h, CSV) tại mỗi lần lấy mẫu
+
+#define POOL_SIZE (32u << 20) // 32 MB, luỹ thừa 2 để buddy (cây) dùng được toàn bộ
+#define SAMPLE_INTERVAL 256   // Số thao tác giữa hai lần lấy mẫu phân mảnh
+#define TARGET_LIVE 2000      // Số khối sống trung bình của trace tổng hợp
+
+typedef enum Strategy { FIRST_FIT, BEST_FIT, NEXT_FIT, WORST_FIT, BUDDY, FLAT_BUDDY, STRATEGY_COUNT } Strategy;
+static const char* strategy_names[STRATEGY_COUNT] = {"first_fit", "best_fit", "next_fit", "worst_fit", "buddy", "flat_buddy"};
+
+typedef struct TraceOp {
+    long time;      // Chỉ dùng khi sinh trace, để sắp xếp thao tác
+    int is_alloc;
+    size_t id;
+    size_t size;
+} TraceOp;
+
+typedef struct Trace {
+    char name[64];
+    TraceOp* ops;
+    size_t count;
+    size_t capacity;
+    size_t id_count; // Các id nằm trong [0, id_count)
+} Trace;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void push_op(Trace* trace, long time, int is_alloc, size_t id, size_t size) {
+    if (trace->count == trace->capacity) {
+        trace->capacity = trace->capacity == 0 ? 1024 : trace->capacity * 2;
+        trace->ops = (TraceOp*)realloc(trace->ops, trace->capacity * sizeof(TraceOp));
+        if (trace->ops == NULL) {
+            printf("[trace_bench] Lỗi cấp phát bộ nhớ cho trace.\n");
+            exit(1);
+        }
+    }
+    TraceOp op = {time, is_alloc, id, size};
+    trace->ops[trace->count++] = op;
+    if (id >= trace->id_count) trace->id_count = id + 1;
+}
+
+// ============================ Trace tổng hợp ============================ //
+
+static unsigned int next_random(unsigned int* seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    return *seed >> 8;
+}
+
+static size_t uniform(unsigned int* seed, size_t low, size_t high) {
+    return low + next_random(seed) % (high - low + 1);
+}
+
+// Cùng thời điểm thì giải phóng trước cấp phát, rồi theo id
+static int compare_ops(const void* a, const void* b) {
+    const TraceOp* x = (const TraceOp*)a;
+    const TraceOp* y = (const TraceOp*)b;
+    if (x->time != y->time) return x->time < y->time ? -1 : 1;
+    if (x->is_alloc != y->is_alloc) return x->is_alloc - y->is_alloc;
+    return x->id < y->id ? -1 : (x->id > y->id);
+}
+
+// Mỗi khối được sinh tại birth và sống lifetime đơn vị thời gian; khối còn sống ở cuối trace được giải phóng sau cùng
+static void add_object(Trace* trace, size_t id, long birth, long lifetime, size_t size) {
+    push_op(trace, birth, 1, id, size);
+    push_op(trace, birth + lifetime, 0, id, 0);
+}
+
+// churn: kích thước đều 16..512 bytes, thời gian sống đều, số khối sống ổn định quanh TARGET_LIVE
+static void generate_churn(Trace* trace, size_t allocations, unsigned int seed) {
+    for (size_t i = 0; i < allocations; i++) {
+        add_object(trace, i, (long)i, (long)uniform(&seed, 1, 2 * TARGET_LIVE), uniform(&seed, 16, 512));
+    }
+}
+
+// bimodal: 90% khối nhỏ sống ngắn, 10% khối lớn sống lâu, khối lớn chặn việc gộp các khối nhỏ xung quanh
+static void generate_bimodal(Trace* trace, size_t allocations, unsigned int seed) {
+    for (size_t i = 0; i < allocations; i++) {
+        if (next_random(&seed) % 10 == 0) {
+            add_object(trace, i, (long)i, (long)uniform(&seed, TARGET_LIVE, 8 * TARGET_LIVE), uniform(&seed, 1024, 16384));
+        } else {
+            add_object(trace, i, (long)i, (long)uniform(&seed, 1, 64), uniform(&seed, 16, 128));
+        }
+    }
+}
+
+// burst: cấp phát theo đợt 256 khối (như một request), cả đợt chết cùng lúc
+static void generate_burst(Trace* trace, size_t allocations, unsigned int seed) {
+    const size_t burst_size = 256;
+    for (size_t first = 0; first < allocations; first += burst_size) {
+        long birth = (long)first;
+        long lifetime = (long)uniform(&seed, burst_size, 2 * TARGET_LIVE);
+        for (size_t i = first; i < first + burst_size && i < allocations; i++) {
+            add_object(trace, i, birth, lifetime, uniform(&seed, 16, 1024));
+        }
+    }
+}
+
+// phase: phân bố kích thước đổi theo từng pha, các khối sống sót từ pha trước làm phân mảnh pha sau
+static void generate_phase(Trace* trace, size_t allocations, unsigned int seed) {
+    static const size_t phase_sizes[] = {32, 512, 64, 2048, 128};
+    const size_t phase_count = sizeof(phase_sizes) / sizeof(phase_sizes[0]);
+    for (size_t i = 0; i < allocations; i++) {
+        size_t base = phase_sizes[i * phase_count / allocations];
+        long lifetime = next_random(&seed) % 8 == 0 ? (long)allocations : (long)uniform(&seed, 1, 2 * TARGET_LIVE);
+        add_object(trace, i, (long)i, lifetime, uniform(&seed, base / 2, base * 2));
+    }
+}
+
+typedef void (*TraceGenerator)(Trace* trace, size_t allocations, unsigned int seed);
+
+static Trace* make_synthetic(const char* name, TraceGenerator generator, size_t allocations) {
+    Trace* trace = (Trace*)calloc(1, sizeof(Trace));
+    if (trace == NULL) {
+        printf("[trace_bench] Lỗi cấp phát bộ nhớ cho trace.\n");
+        exit(1);
+    }
+    snprintf(trace->name, sizeof(trace->name), "%s", name);
+    generator(trace, allocations, 12345u);
+    qsort(trace->ops, trace->count, sizeof(TraceOp), compare_ops);
+    return trace;
+}
+
+// ============================ Đọc / ghi file trace ============================ //
+
+static Trace* load_trace(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        printf("[load_trace] Lỗi: Không thể mở file trace %s.\n", path);
+        return NULL;
+    }
+    Trace* trace = (Trace*)calloc(1, sizeof(Trace));
+    if (trace == NULL) {
+        fclose(file);
+        return NULL;
+    }
+    const char* base = strrchr(path, '/');
+    snprintf(trace->name, sizeof(trace->name), "%s", base != NULL ? base + 1 : path);
+
+    char line[256];
+    size_t line_number = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line_number++;
+        char kind;
+        size_t id, size;
+        if (line[0] == '#' || line[0] == '\n') continue;
+        if (sscanf(line, " %c %zu %zu", &kind, &id, &size) == 3 && kind == 'a' && size > 0) {
+            push_op(trace, (long)trace->count, 1, id, size);
+        } else if (sscanf(line, " %c %zu", &kind, &id) == 2 && kind == 'f') {
+            push_op(trace, (long)trace->count, 0, id, 0);
+        } else {
+            printf("[load_trace] Bỏ qua dòng %zu không hợp lệ trong %s.\n", line_number, path);
+        }
+    }
+    fclose(file);
+    return trace;
+}
+
+static int save_trace(const Trace* trace, const char* directory) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.trace", directory, trace->name);
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        printf("[save_trace] Lỗi: Không thể ghi file %s.\n", path);
+        return 0;
+    }
+    fprintf(file, "# trace %s: %zu thao tác\n", trace->name, trace->count);
+    for (size_t i = 0; i < trace->count; i++) {
+        if (trace->ops[i].is_alloc) {
+            fprintf(file, "a %zu %zu\n", trace->ops[i].id, trace->ops[i].size);
+        } else {
+            fprintf(file, "f %zu\n", trace->ops[i].id);
+        }
+    }
+    fclose(file);
+    return 1;
+}
+
+static void free_trace(Trace* trace) {
+    free(trace->ops);
+    free(trace);
+}
+
+// ============================ Phát lại ============================ //
+
+typedef struct Allocators {
+    MemoryManagement* manager;
+    BuddySystem* buddy;
+    FlatBuddySystem* flat_buddy;
+} Allocators;
+
+static void* allocate(Strategy strategy, Allocators* a, size_t size) {
+    switch (strategy) {
+        case FIRST_FIT:  return firstfit_malloc(a->manager, size, NULL);
+        case BEST_FIT:   return bestfit_malloc(a->manager, size, NULL);
+        case NEXT_FIT:   return nextfit_malloc(a->manager, size, NULL);
+        case WORST_FIT:  return worstfit_malloc(a->manager, size, NULL);
+        case BUDDY:      return buddy_malloc(a->buddy, size, NULL); // Handle là BuddyBlock*
+        default:         return flat_buddy_malloc(a->flat_buddy, size, NULL);
+    }
+}
+
+static void release(Strategy strategy, Allocators* a, void* handle) {
+    switch (strategy) {
+        case BUDDY:      free_buddy(a->buddy, (BuddyBlock*)handle, NULL); break;
+        case FLAT_BUDDY: free_flat_buddy(a->flat_buddy, handle, NULL); break;
+        default:         free_mem(a->manager, handle, NULL); break;
+    }
+}
+
+static void take_stats(Strategy strategy, Allocators* a, MemoryStats* stats) {
+    if (strategy == BUDDY) {
+        mem_stats_from_buddy(a->buddy, stats);
+    } else if (strategy == FLAT_BUDDY) {
+        mem_stats_from_flat_buddy(a->flat_buddy, stats);
+    } else {
+        mem_stats_from_manager(a->manager, stats);
+    }
+}
+
+static void replay(const Trace* trace, Strategy strategy, FILE* snapshots) {
+    void* pool = malloc(POOL_SIZE);
+    Allocators a = {NULL, NULL, NULL};
+    if (strategy == BUDDY) {
+        a.buddy = create_buddy_system(pool, POOL_SIZE, NULL);
+    } else if (strategy == FLAT_BUDDY) {
+        a.flat_buddy = create_flat_buddy_system(pool, POOL_SIZE, NULL);
+    } else {
+        a.manager = initialize_memory_manager(pool, POOL_SIZE, NULL);
+    }
+    void** handles = (void**)calloc(trace->id_count, sizeof(void*));
+    size_t* sizes = (size_t*)calloc(trace->id_count, sizeof(size_t));
+    if (pool == NULL || (a.manager == NULL && a.buddy == NULL && a.flat_buddy == NULL) || handles == NULL || sizes == NULL) {
+        printf("[trace_bench] Lỗi khởi tạo bộ cấp phát.\n");
+        exit(1);
+    }
+
+    size_t failures = 0, live_bytes = 0, peak_live_bytes = 0;
+    double elapsed = 0.0, peak_fragmentation = 0.0, utilization = 0.0;
+    size_t i = 0;
+    while (i < trace->count) {
+        // Đo một đoạn SAMPLE_INTERVAL thao tác, lấy mẫu trạng thái ngoài thời gian đo
+        size_t end = i + SAMPLE_INTERVAL < trace->count ? i + SAMPLE_INTERVAL : trace->count;
+        double start = now_ms();
+        for (; i < end; i++) {
+            const TraceOp* op = &trace->ops[i];
+            if (op->is_alloc) {
+                handles[op->id] = allocate(strategy, &a, op->size);
+                if (handles[op->id] == NULL) {
+                    failures++;
+                    continue;
+                }
+                sizes[op->id] = op->size;
+                live_bytes += op->size;
+            } else if (handles[op->id] != NULL) {
+                release(strategy, &a, handles[op->id]);
+                handles[op->id] = NULL;
+                live_bytes -= sizes[op->id];
+            }
+        }
+        elapsed += now_ms() - start;
+
+        MemoryStats stats;
+        take_stats(strategy, &a, &stats);
+        if (stats.fragmentation > peak_fragmentation) peak_fragmentation = stats.fragmentation;
+        if (live_bytes > peak_live_bytes && stats.used_bytes > 0) {
+            peak_live_bytes = live_bytes;
+            utilization = (double)live_bytes / stats.used_bytes;
+        }
+        if (snapshots != NULL) {
+            char label[128];
+            snprintf(label, sizeof(label), "%s/%s/%zu", trace->name, strategy_names[strategy], i);
+            mem_stats_write_csv(&stats, label, snapshots);
+        }
+    }
+
+    mem_stats_write_csv_field(trace->name, stdout);
+    printf(",%s,%zu,%zu,%.0f,", strategy_names[strategy], trace->count, failures,
+           elapsed > 0.0 ? trace->count / elapsed * 1e3 : 0.0);
+    if (a.manager != NULL && a.manager->search_count > 0) {
+        printf("%.2f", (double)a.manager->search_steps / a.manager->search_count);
+    }
+    printf(",%.4f,%.4f\n", peak_fragmentation, utilization);
+    fflush(stdout);
+
+    for (size_t id = 0; id < trace->id_count; id++) {
+        if (handles[id] != NULL) release(strategy, &a, handles[id]);
+    }
+    free(handles);
+    free(sizes);
+    if (a.buddy != NULL) {
+        cleanup_buddy_system(a.buddy, NULL);
+        free(pool);
+    } else if (a.flat_buddy != NULL) {
+        cleanup_flat_buddy_system(a.flat_buddy, NULL);
+        free(pool);
+    } else {
+        cleanup_memory_manager(a.manager, NULL); // Giải phóng cả pool
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t allocations = 100000;
+    const char* save_directory = NULL;
+    FILE* snapshots = NULL;
+    Trace* traces[64];
+    size_t trace_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        char* end;
+        long value = strtol(argv[i], &end, 10);
+        if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            save_directory = argv[++i];
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            snapshots = fopen(argv[++i], "w");
+            if (snapshots == NULL) {
+                printf("[trace_bench] Lỗi: Không thể ghi file %s.\n", argv[i]);
+                return 1;
+            }
+            mem_stats_write_csv_header(snapshots);
+        } else if (*end == '\0') {
+            if (value <= 0) {
+                printf("Cách dùng: %s [số lần cấp phát] [-w thư mục] [-s file] [file trace ...]\n", argv[0]);
+                return 1;
+            }
+            allocations = (size_t)value;
+        } else if (trace_count < sizeof(traces) / sizeof(traces[0])) {
+            Trace* trace = load_trace(argv[i]);
+            if (trace == NULL) return 1;
+            traces[trace_count++] = trace;
+        }
+    }
+
+    if (trace_count == 0) {
+        traces[trace_count++] = make_synthetic("churn", generate_churn, allocations);
+        traces[trace_count++] = make_synthetic("bimodal", generate_bimodal, allocations);
+        traces[trace_count++] = make_synthetic("burst", generate_burst, allocations);
+        traces[trace_count++] = make_synthetic("phase", generate_phase, allocations);
+        for (size_t t = 0; save_directory != NULL && t < trace_count; t++) {
+            if (!save_trace(traces[t], save_directory)) return 1;
+        }
+    }
+
+    printf("trace,strategy,ops,failures,ops_per_sec,avg_search_length,peak_fragmentation,utilization\n");
+    for (size_t t = 0; t < trace_count; t++) {
+        for (int s = 0; s < STRATEGY_COUNT; s++) replay(traces[t], (Strategy)s, snapshots);
+        free_trace(traces[t]);
+    }
+    if (snapshots != NULL) fclose(snapshots);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#ifndef BITMAP_ALLOC_H
+#define BITMAP_ALLOC_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Bộ cấp phát dùng bitmap phân cấp: vùng nhớ được chia thành các granule kích thước cố định,
+// mỗi granule ứng với một bit (1 = trống). Các tầng tóm tắt phía trên đánh dấu word nào của tầng dưới còn bit 1,
+// nên tìm vùng trống chỉ cần vài lệnh ctz/clz trên mỗi tầng thay vì duyệt danh sách liên kết.
+// Bitmap end_bits đánh dấu granule cuối của mỗi khối đã cấp phát để free không cần truyền kích thước.
+// Cây run_tree (cây phân đoạn trên các word của tầng 0) lưu độ dài đoạn trống đầu, cuối và dài nhất của mỗi nhánh,
+// nên bitmap_malloc đi thẳng từ gốc tới đoạn trống đầu tiên đủ lớn trong O(log n) thay vì duyệt từ word 0.
+
+#define BITMAP_GRANULE_SIZE 16 // bytes
+#define BITMAP_MAX_LEVELS 4    // 64^4 granule, đủ cho vùng nhớ 256 GB
+
+// Tóm tắt đoạn trống của một nhánh cây run_tree, tính theo granule (granule_count <= 64^4 nên vừa 32 bit)
+typedef struct BitmapRunSummary {
+    uint32_t prefix;    // Số granule trống liên tiếp từ đầu nhánh
+    uint32_t suffix;    // Số granule trống liên tiếp tới cuối nhánh
+    uint32_t longest;   // Đoạn trống dài nhất trong nhánh
+} BitmapRunSummary;
+
+typedef struct BitmapAllocator {
+    void* base_memory_address;
+    void* last_memory_address;
+    size_t total_memory_size;
+    size_t allocated_memory_size;   // Tổng kích thước các khối đã cấp phát (đã làm tròn theo granule)
+    size_t granule_count;
+    size_t free_granules;
+
+    int level_count;                        // Số tầng, tầng 0 là bitmap granule
+    uint64_t* levels[BITMAP_MAX_LEVELS];    // levels[l] có bit i = 1 nếu word i của tầng l - 1 còn bit 1
+    size_t level_words[BITMAP_MAX_LEVELS];
+    uint64_t* end_bits;                     // Bit 1 tại granule cuối của mỗi khối đã cấp phát
+    BitmapRunSummary* run_tree;             // Cây nhị phân dạng heap (gốc ở 1), lá run_leaves + i ứng với word i của tầng 0
+    size_t run_leaves;                      // Số lá, luỹ thừa của 2 >= level_words[0]
+} BitmapAllocator;
+
+// Khởi tạo bộ cấp phát trên vùng nhớ [base_addr, base_addr + total_size)
+BitmapAllocator* create_bitmap_allocator(void* base_addr, size_t total_size, FILE* out);
+
+// Cấp phát size bytes (làm tròn lên bội số granule), trả về NULL nếu không có vùng trống liên tiếp đủ lớn
+void* bitmap_malloc(BitmapAllocator* allocator, size_t size, FILE* out);
+
+// Giải phóng khối bắt đầu tại ptr
+void free_bitmap(BitmapAllocator* allocator, void* ptr, FILE* out);
+
+// In thông tin và các đoạn granule trống
+void print_bitmap_allocator(BitmapAllocator* allocator, FILE* out);
+
+// Giải phóng cấu trúc quản lý (không giải phóng vùng nhớ được quản lý)
+void cleanup_bitmap_allocator(BitmapAllocator* allocator, FILE* out);
+
+#endif
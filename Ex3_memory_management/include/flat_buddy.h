@@ -0,0 +1,72 @@
+#ifndef FLAT_BUDDY_H
+#define FLAT_BUDDY_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Buddy system dạng mảng phẳng: không cấp phát node BuddyBlock nào khi chia/gộp khối.
+// Cây nhị phân buddy được đánh số ngầm như heap (gốc = 1, con của i là 2i và 2i + 1), trạng thái mỗi node
+// nằm trong hai bitmap: split_bits (node đã bị chia) và free_bits (node là một khối trống trong danh sách của bậc đó).
+// Mỗi bậc có một danh sách liên kết đôi các khối trống, node danh sách nằm ngay trong khối trống.
+// Buddy của khối tại offset với kích thước 2^k là offset ^ 2^k, nên cấp phát/giải phóng là O(log N).
+//
+// Vùng nhớ không phải luỹ thừa của 2 được chia thành các khối luỹ thừa 2 lớn nhất có thể khi khởi tạo;
+// buddy nằm ngoài vùng nhớ không bao giờ trống nên không bao giờ bị gộp.
+//
+// Chế độ arena (create_flat_buddy_arena): buddy system tự giữ chỗ một vùng địa chỉ ảo lớn (nhiều GB) bằng
+// mmap(PROT_NONE), chưa tốn bộ nhớ thật. Trang được commit (mprotect đọc/ghi) theo đơn vị FLAT_BUDDY_COMMIT_SIZE
+// khi khối được cấp phát lần đầu; khi gộp được khối trống >= release_size, mọi đơn vị commit của khối trừ đơn vị đầu
+// (chứa node danh sách trống) được trả lại bằng madvise(MADV_DONTNEED) và mprotect(PROT_NONE), nên RSS bám theo dữ liệu sống.
+
+#define FLAT_BUDDY_MIN_ORDER 4      // Khối nhỏ nhất 16 bytes, đủ chứa node danh sách trống
+#define FLAT_BUDDY_MAX_ORDERS 48
+#define FLAT_BUDDY_COMMIT_SIZE 65536 // Đơn vị commit/trả trang của chế độ arena (bội số kích thước trang)
+
+typedef struct FlatBuddyNode {
+    struct FlatBuddyNode* next;
+    struct FlatBuddyNode* prev;
+} FlatBuddyNode;
+
+typedef struct FlatBuddySystem {
+    void* base_memory_address;
+    void* last_memory_address;
+    size_t total_memory_size;
+    size_t managed_memory_size;     // total_memory_size làm tròn xuống bội số khối nhỏ nhất
+    size_t allocated_memory_size;   // Tổng kích thước các khối đã cấp phát (đã làm tròn luỹ thừa 2)
+
+    int top_order;                  // Bậc của gốc cây: 2^(top_order + FLAT_BUDDY_MIN_ORDER) >= managed_memory_size
+    uint64_t nonempty_orders;       // Bit k = 1 nếu free_lists[k] khác rỗng
+    FlatBuddyNode* free_lists[FLAT_BUDDY_MAX_ORDERS];
+    size_t free_counts[FLAT_BUDDY_MAX_ORDERS]; // Số khối trống của từng bậc, dùng cho thống kê
+    uint64_t* split_bits;
+    uint64_t* free_bits;
+
+    // Chế độ arena, commit_bits == NULL nếu vùng nhớ do người gọi cấp
+    size_t release_size;            // Khối trống gộp đến kích thước này trở lên thì trả trang cho hệ điều hành
+    size_t committed_bytes;         // Số byte đang được commit
+    size_t commit_calls;            // Số lần mprotect để commit
+    size_t release_calls;           // Số lần madvise để trả trang
+    uint64_t* commit_bits;          // Bit i = 1 nếu đơn vị commit thứ i đang đọc/ghi được
+} FlatBuddySystem;
+
+// Khởi tạo buddy system trên vùng nhớ [base_addr, base_addr + total_size), base_addr phải căn 16 bytes
+FlatBuddySystem* create_flat_buddy_system(void* base_addr, size_t total_size, FILE* out);
+
+// Giữ chỗ reserve_size bytes địa chỉ ảo (làm tròn lên bội số FLAT_BUDDY_COMMIT_SIZE) và quản lý bằng buddy system
+// ở chế độ arena. release_size là kích thước khối trống nhỏ nhất được trả trang, làm tròn lên luỹ thừa 2 và tối thiểu
+// 2 * FLAT_BUDDY_COMMIT_SIZE
+FlatBuddySystem* create_flat_buddy_arena(size_t reserve_size, size_t release_size, FILE* out);
+
+// Cấp phát khối luỹ thừa 2 nhỏ nhất chứa được size bytes
+void* flat_buddy_malloc(FlatBuddySystem* system, size_t size, FILE* out);
+
+// Giải phóng khối bắt đầu tại ptr và gộp với các buddy trống
+void free_flat_buddy(FlatBuddySystem* system, void* ptr, FILE* out);
+
+// In số khối trống của từng bậc
+void print_flat_buddy_system(FlatBuddySystem* system, FILE* out);
+
+// Giải phóng cấu trúc quản lý (không giải phóng vùng nhớ được quản lý, trừ vùng do create_flat_buddy_arena giữ chỗ)
+void cleanup_flat_buddy_system(FlatBuddySystem* system, FILE* out);
+
+#endif
@@ -3,38 +3,70 @@
 
 #include <stdio.h>
 
-// Định nghĩa cấu trúc cho một khối bộ nhớ (block)
+// Boundary tag: mỗi khối (trống hoặc đã cấp phát) trong vùng nhớ được quản lý có dạng
+//   [size][requested] [dữ liệu ...] [size]
+// size là kích thước cả khối (tính cả header và footer), requested là số byte người dùng xin (0 = khối trống).
+// Địa chỉ trả về cho người dùng nằm ngay sau header. Khối trống chứa luôn MemoryBlock mô tả nó ở đầu vùng dữ liệu
+// (không cấp phát gì ngoài vùng nhớ được quản lý), nên khi giải phóng có thể gộp ngay với khối liền trước/liền sau trong O(1).
+// Đầu khối và kích thước khối là bội số MEM_BLOCK_ALIGN để descriptor luôn thẳng hàng.
+#define MEM_BLOCK_HEADER_SIZE (2 * sizeof(size_t))
+#define MEM_BLOCK_FOOTER_SIZE (sizeof(size_t))
+#define MEM_BLOCK_ALIGN 8
+#define MEM_BLOCK_MIN_SIZE (MEM_BLOCK_HEADER_SIZE + sizeof(MemoryBlock) + MEM_BLOCK_FOOTER_SIZE) // Khối trống nhỏ nhất
+
+// Lớp kích thước dùng cho histogram vùng trống (xem mem_stats.h): lớp 0 chứa khối < 32 bytes,
+// lớp k chứa khối [16 * 2^k, 32 * 2^k), lớp cuối không có giới hạn trên
+#define MEM_SIZE_CLASS_COUNT 24
+
+struct MemoryBlock;
+
+// Liên kết của một khối trong cây AVL (xem mem_tree.h)
+typedef struct MemoryTreeLink {
+    struct MemoryBlock* left;
+    struct MemoryBlock* right;
+    int height;
+} MemoryTreeLink;
+
+// Định nghĩa cấu trúc cho một khối bộ nhớ (block) trống, nằm ngay sau header của khối
 typedef struct MemoryBlock {
-    void* start_addr;
-    size_t size;
+    void* start_addr;           // Địa chỉ đầu khối (header)
+    size_t size;                // Kích thước cả khối
     struct MemoryBlock* next;
+    struct MemoryBlock* prev;
+    MemoryTreeLink size_link;     // Vị trí trong cây sắp theo (kích thước, địa chỉ)
+    MemoryTreeLink address_link;  // Vị trí trong cây sắp theo địa chỉ
+    size_t subtree_max_size;      // Kích thước lớn nhất trong cây con theo địa chỉ có gốc là khối này (dùng cho first fit)
 } MemoryBlock;
 
 typedef struct MemoryManagement {
-    MemoryBlock *free_list; // Danh sách quản lý các vùng trống tự do trong vùng trống ban đầu
+    MemoryBlock *free_list; // Danh sách liên kết đôi các vùng trống tự do, khối mới giải phóng được chèn vào đầu
     void *base_memory_address; // Con trỏ giữ địa chỉ bắt đầu của vùng trống tự do mà ta quản lý
     void *last_memory_address; // Con trỏ giữ địa chỉ kết thúc của vùng trống tự do mà ta quản lý
     size_t total_memory_size; // Tổng vùng trống tự do ban đầu
-    size_t allocated_memory_size; // Tổng vùng trống đã cấp phát
-    MemoryBlock *next_fit_last_block; // Con trỏ lưu lại vị trí tìm kiếm khối trước đó, phục vụ cho chiến lược next fit.
+    size_t allocated_memory_size; // Tổng số byte người dùng đã xin (không tính boundary tag)
+    MemoryBlock *size_tree; // Cây AVL các vùng trống theo kích thước, dùng cho best fit / worst fit
+    MemoryBlock *address_tree; // Cây AVL các vùng trống theo địa chỉ, dùng cho first fit, next fit và allocate_at_address
+    size_t next_fit_offset; // Vị trí bắt đầu lần tìm next fit kế tiếp, tính từ base_memory_address (không phụ thuộc descriptor nào)
+    size_t free_memory_size; // Tổng kích thước các vùng trống, cập nhật mỗi khi danh sách vùng trống thay đổi
+    size_t free_block_count;
+    size_t free_size_classes[MEM_SIZE_CLASS_COUNT]; // Số vùng trống theo lớp kích thước
+    size_t search_count; // Số lần tìm vùng trống của các chiến lược cấp phát
+    size_t search_steps; // Tổng số nút cây đã đi qua, độ dài tìm kiếm trung bình = search_steps / search_count
 } MemoryManagement;
 
-// Hàm khởi tạo một vùng nhớ trống ban đầu
+// Hàm khởi tạo một vùng nhớ trống ban đầu (base_addr căn theo MEM_BLOCK_ALIGN)
 MemoryManagement* initialize_memory_manager(void *base_addr, size_t total_size, FILE *out);
 
 // Giải phóng cấu trúc MemoryManagement
 void cleanup_memory_manager(MemoryManagement *manager, FILE *out);
 
-// Hàm in ra danh sách các khối đang trống
+// Hàm in ra các khối đang trống theo thứ tự địa chỉ
 void print_free_list(MemoryManagement *manager, FILE *out);
 
-// Hàm hợp nhất các khối trống liền kề
-void merge_free_blocks(MemoryManagement *manager, FILE *out);
-
-// Thêm vùng trống vào danh sách vùng trống tự do
+// Đánh dấu khối [start_addr, start_addr + size) là trống và gộp ngay với các khối trống liền kề
 void add_free_mem_block(MemoryManagement *manager, void *start_addr, size_t size, FILE *out);
 
-// Hàm cấp phát tại địa chỉ cụ thể
+// Hàm cấp phát tại địa chỉ cụ thể (header của khối nằm ngay trước start_addr_request, địa chỉ căn theo MEM_BLOCK_ALIGN)
 void *allocate_at_address(MemoryManagement *manager, void *start_addr_request, size_t size, FILE *out);
 
 // Các chiến lược cấp phát bộ nhớ
@@ -43,8 +75,102 @@ void *bestfit_malloc(MemoryManagement *manager, size_t size, FILE *out); // Best
 void *worstfit_malloc(MemoryManagement *manager, size_t size, FILE *out); // Worst Fit
 void *nextfit_malloc(MemoryManagement *manager, size_t size, FILE *out); // Next Fit
 
-// Hàm giải phóng
-void free_mem(MemoryManagement *manager, void *ptr, size_t size, FILE *out);
+// Cấp phát với địa chỉ dữ liệu căn theo alignment (luỹ thừa 2)
+void *aligned_malloc(MemoryManagement *manager, size_t size, size_t alignment, FILE *out);
+
+// Hàm giải phóng, kích thước khối được đọc từ boundary tag
+void free_mem(MemoryManagement *manager, void *ptr, FILE *out);
+
+// Đổi kích thước khối tại ptr thành size bytes, giữ nguyên dữ liệu (như realloc): ưu tiên thu nhỏ/mở rộng tại chỗ
+// sang khối trống liền sau, chỉ sao chép khi phải chuyển khối. ptr = NULL tương đương first fit, size = 0 tương đương free_mem.
+// Trả về NULL (khối cũ giữ nguyên) nếu không đủ vùng trống.
+void *realloc_mem(MemoryManagement *manager, void *ptr, size_t size, FILE *out);
+
+// Chế độ slab (object pool) cho các đối tượng cùng kích thước: mỗi trang slab được cấp phát từ manager bằng
+// aligned_malloc, căn theo page_size, và chia thành các slot cố định. Slot trống nối với nhau bằng con trỏ
+// nằm ngay trong slot, nên cấp phát/giải phóng là O(1) và không có header trên từng đối tượng;
+// trang chứa một đối tượng được tìm bằng cách xoá các bit thấp của địa chỉ.
+#define MEM_SLAB_PAGE_SIZE 4096 // Kích thước trang tối thiểu, trang lớn hơn khi đối tượng lớn
+
+typedef struct SlabPage {
+    struct SlabCache *cache;
+    struct SlabPage *next;
+    struct SlabPage *prev;
+    void *free_slots;           // Danh sách slot trống, mỗi slot trống chứa con trỏ tới slot trống kế tiếp
+    size_t used_slots;
+} SlabPage;
+
+typedef struct SlabCache {
+    MemoryManagement *manager;
+    size_t object_size;
+    size_t slot_size;           // object_size làm tròn lên bội số 16
+    size_t page_size;
+    size_t slots_per_page;
+    SlabPage *partial_pages;    // Còn slot trống, được dùng trước
+    SlabPage *full_pages;
+    SlabPage *empty_page;       // Giữ lại tối đa một trang trống để tránh cấp phát/trả trang liên tục
+    size_t page_count;
+    size_t allocated_objects;
+} SlabCache;
+
+// Tạo slab cache cho đối tượng object_size bytes, trang được lấy từ manager
+SlabCache *create_slab_cache(MemoryManagement *manager, size_t object_size, FILE *out);
+
+// Cấp phát một đối tượng
+void *slab_malloc(SlabCache *cache, FILE *out);
+
+// Giải phóng một đối tượng do slab_malloc của cache này trả về
+void slab_free(SlabCache *cache, void *ptr, FILE *out);
+
+// Trả mọi trang về manager và giải phóng cache (các đối tượng còn sống trở nên không hợp lệ)
+void destroy_slab_cache(SlabCache *cache, FILE *out);
+
+// Chế độ region (bump pointer) cho các đối tượng chết cùng lúc (theo request, theo frame...): region lấy các chunk
+// lớn từ manager và cấp phát bằng cách tăng con trỏ, không có header trên từng đối tượng và không giải phóng riêng lẻ.
+// Các chunk nối thành chuỗi và được giữ lại khi reset/rollback để tái sử dụng, nên cấp phát, lưu savepoint,
+// rollback và reset đều O(1); chỉ destroy_region mới trả chunk về manager.
+#define MEM_REGION_CHUNK_SIZE 16384 // Kích thước chunk mặc định
+#define MEM_REGION_ALIGN 16
+
+typedef struct RegionChunk {
+    struct RegionChunk *next;   // Chunk kế tiếp trong chuỗi (đã dùng trước đó hoặc chưa dùng)
+    char *limit;                // Cuối vùng dữ liệu của chunk
+} RegionChunk;
+
+typedef struct Region {
+    MemoryManagement *manager;
+    size_t chunk_size;
+    RegionChunk *first;
+    RegionChunk *current;       // Chunk đang cấp phát
+    char *cursor;               // Vị trí cấp phát kế tiếp trong chunk hiện tại
+    size_t chunk_count;
+    size_t allocated_bytes;     // Tổng số byte đã cấp phát (đã làm tròn) kể từ lần reset gần nhất
+} Region;
+
+// Vị trí cấp phát của region tại một thời điểm, dùng để rollback
+typedef struct RegionSavepoint {
+    RegionChunk *chunk;
+    char *cursor;
+    size_t allocated_bytes;
+} RegionSavepoint;
+
+// Tạo region lấy chunk chunk_size bytes từ manager (0: MEM_REGION_CHUNK_SIZE)
+Region *create_region(MemoryManagement *manager, size_t chunk_size, FILE *out);
+
+// Cấp phát size bytes căn theo MEM_REGION_ALIGN; yêu cầu lớn hơn chunk được cấp một chunk riêng vừa đủ
+void *region_malloc(Region *region, size_t size, FILE *out);
+
+// Lưu vị trí cấp phát hiện tại
+RegionSavepoint region_save(const Region *region);
+
+// Giải phóng mọi đối tượng cấp phát sau savepoint (savepoint phải được lưu sau lần reset gần nhất)
+void region_rollback(Region *region, RegionSavepoint savepoint, FILE *out);
+
+// Giải phóng mọi đối tượng của region, giữ lại các chunk
+void region_reset(Region *region, FILE *out);
+
+// Trả mọi chunk về manager và giải phóng region
+void destroy_region(Region *region, FILE *out);
 
 #endif
 
@@ -0,0 +1,9 @@
+#ifndef MEM_LOG_H
+#define MEM_LOG_H
+
+#include <stdio.h>
+
+// Ghi log của các bộ cấp phát. Truyền out = NULL để tắt log (dùng khi đo hiệu năng).
+#define MEM_LOG(out, ...) do { if ((out) != NULL) fprintf((out), __VA_ARGS__); } while (0)
+
+#endif
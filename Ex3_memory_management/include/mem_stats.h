@@ -0,0 +1,48 @@
+#ifndef MEM_STATS_H
+#define MEM_STATS_H
+
+#include <stdio.h>
+#include "mem_alloc.h"
+#include "buddy_alloc.h"
+#include "flat_buddy.h"
+
+// Ảnh chụp (snapshot) trạng thái heap của một bộ cấp phát, dùng chung cho các chiến lược.
+// MemoryManagement và FlatBuddySystem duy trì bộ đếm vùng trống khi cấp phát/giải phóng, nên lấy snapshot
+// chỉ tốn O(log n) (tìm khối lớn nhất) và có thể lấy mẫu liên tục. Buddy dạng cây phải duyệt cây, O(số node).
+//
+// Buddy mảng phẳng không lưu số byte người dùng xin, nên allocated_bytes = used_bytes và internal_waste = 0.
+
+typedef struct MemoryStats {
+    size_t total_bytes;          // Kích thước vùng nhớ được quản lý
+    size_t allocated_bytes;      // Số byte người dùng đang giữ
+    size_t used_bytes;           // Số byte các khối đã cấp phát chiếm (gồm boundary tag, phần làm tròn)
+    size_t free_bytes;
+    size_t free_blocks;
+    size_t largest_free_block;
+    double fragmentation;        // Chỉ số phân mảnh ngoài: 1 - largest_free_block / free_bytes
+    size_t internal_waste;       // used_bytes - allocated_bytes
+    size_t free_histogram[MEM_SIZE_CLASS_COUNT]; // Số khối trống theo lớp kích thước (mem_size_class)
+} MemoryStats;
+
+// Lớp kích thước của một khối size bytes (xem MEM_SIZE_CLASS_COUNT)
+size_t mem_size_class(size_t size);
+
+// Kích thước nhỏ nhất thuộc lớp size_class (lớp 0 tính từ 0)
+size_t mem_size_class_min(size_t size_class);
+
+void mem_stats_from_manager(const MemoryManagement *manager, MemoryStats *stats);
+void mem_stats_from_buddy(const BuddySystem *system, MemoryStats *stats);
+void mem_stats_from_flat_buddy(const FlatBuddySystem *system, MemoryStats *stats);
+
+// Ghi snapshot thành một object JSON trên một dòng (JSON Lines), label dùng để đánh dấu thời điểm/nguồn
+// (label được escape nên có thể chứa ký tự bất kỳ, ví dụ tên file trace)
+void mem_stats_write_json(const MemoryStats *stats, const char *label, FILE *out);
+
+// Ghi dòng tiêu đề CSV, sau đó mỗi snapshot là một dòng; cột free_<n> là số khối trống thuộc lớp bắt đầu từ n bytes
+void mem_stats_write_csv_header(FILE *out);
+void mem_stats_write_csv(const MemoryStats *stats, const char *label, FILE *out);
+
+// Ghi một trường CSV, đặt trong nháy kép khi chứa dấu phẩy, dấu nháy hoặc xuống dòng
+void mem_stats_write_csv_field(const char *field, FILE *out);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef MEM_TREE_H
+#define MEM_TREE_H
+
+#include <stddef.h>
+#include "mem_alloc.h"
+
+// Cây AVL xâm nhập (intrusive) trên các descriptor MemoryBlock của vùng trống.
+// Mỗi khối nằm đồng thời trong hai cây qua size_link và address_link:
+//   MEM_TREE_BY_SIZE     khoá (size, start_addr), tìm best fit / worst fit trong O(log n)
+//   MEM_TREE_BY_ADDRESS  khoá start_addr, tìm vùng trống chứa một địa chỉ trong O(log n); mỗi nút giữ thêm
+//                        subtree_max_size nên tìm khối đủ lớn có địa chỉ thấp nhất (first fit) cũng trong O(log n)
+// Các hàm insert/remove nhận gốc cây và trả về gốc mới. Khoá của khối không được đổi khi đang nằm trong cây.
+
+typedef enum MemoryTreeKind {
+    MEM_TREE_BY_SIZE,
+    MEM_TREE_BY_ADDRESS
+} MemoryTreeKind;
+
+MemoryBlock* mem_tree_insert(MemoryBlock* root, MemoryBlock* block, MemoryTreeKind kind);
+MemoryBlock* mem_tree_remove(MemoryBlock* root, MemoryBlock* block, MemoryTreeKind kind);
+
+// Đặt new_block vào đúng vị trí của old_block (khi descriptor bị dời chỗ): new_block phải đã mang liên kết của old_block
+// và khoá không làm đổi thứ tự; vùng nhớ của old_block không được đọc tới nên có thể đã bị ghi đè.
+MemoryBlock* mem_tree_replace(MemoryBlock* root, MemoryBlock* old_block, MemoryBlock* new_block, MemoryTreeKind kind);
+
+// Khối nhỏ nhất có size >= size (cây theo kích thước), NULL nếu không có.
+// visited (có thể NULL) được cộng thêm số nút đã đi qua.
+MemoryBlock* mem_tree_ceiling_size(MemoryBlock* root, size_t size, size_t* visited);
+
+// Khối lớn nhất (cây theo kích thước)
+MemoryBlock* mem_tree_max_size(MemoryBlock* root, size_t* visited);
+
+// Tính lại subtree_max_size trên đường từ gốc tới block sau khi size của block đổi tại chỗ (cây theo địa chỉ)
+void mem_tree_size_changed(MemoryBlock* root, MemoryBlock* block);
+
+// Khối có địa chỉ thấp nhất mà start_addr >= addr và size >= size (cây theo địa chỉ), NULL nếu không có.
+// visited (có thể NULL) được cộng thêm số nút đã đi qua.
+MemoryBlock* mem_tree_first_fit(MemoryBlock* root, const void* addr, size_t size, size_t* visited);
+
+// Khối có start_addr lớn nhất mà <= addr (cây theo địa chỉ), NULL nếu không có. visited như trên.
+MemoryBlock* mem_tree_floor_address(MemoryBlock* root, const void* addr, size_t* visited);
+
+// Khối có start_addr nhỏ nhất mà >= addr (cây theo địa chỉ), NULL nếu không có. visited như trên.
+MemoryBlock* mem_tree_ceiling_address(MemoryBlock* root, const void* addr, size_t* visited);
+
+#endif
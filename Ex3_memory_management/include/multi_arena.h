@@ -0,0 +1,62 @@
+#ifndef MULTI_ARENA_H
+#define MULTI_ARENA_H
+
+#include <stdio.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "thread_cache.h"
+
+// Bộ cấp phát nhiều arena: vùng nhớ được chia đều thành arena_count arena độc lập, mỗi arena có bộ cấp phát
+// riêng (danh sách trống first fit, TLSF hoặc buddy) và khoá riêng. Mỗi luồng được gán một arena khi cấp phát
+// lần đầu (lần lượt vòng tròn, hoặc chỉ định bằng multi_arena_bind_thread, ví dụ gom các luồng cùng socket),
+// nên các luồng ở arena khác nhau không tranh chấp khoá và dữ liệu của một luồng nằm gần nhau.
+//
+// Arena sở hữu một khối được tính từ địa chỉ (các arena cùng kích thước), nên khối không cần header.
+// Giải phóng khối của arena khác (remote free) không khoá arena đó: khối được đẩy vào hàng đợi remote_frees
+// của arena chủ (ngăn xếp không khoá, con trỏ kế tiếp nằm ngay trong khối) và chỉ thực sự được trả về bộ cấp phát
+// khi luồng của arena chủ cấp phát lần tới, dưới khoá của chính arena đó.
+
+#define MULTI_ARENA_ALIGN 64 // Đầu mỗi arena căn theo 64 bytes
+
+typedef struct MemoryArena {
+    _Alignas(64) pthread_mutex_t lock; // Bảo vệ bộ cấp phát của arena và các bộ đếm; mỗi arena nằm trên cache line riêng
+    MemoryManagement* manager;
+    TLSFAllocator* tlsf;
+    FlatBuddySystem* buddy;
+    _Atomic(void*) remote_frees;    // Khối do luồng thuộc arena khác giải phóng, chờ trả về
+    size_t lock_acquisitions;
+    size_t remote_frees_drained;    // Số khối remote đã được trả về bộ cấp phát
+    size_t thread_count;            // Số luồng đang gán vào arena
+} MemoryArena;
+
+typedef struct MultiArenaAllocator {
+    ConcurrentBackend backend;
+    int arena_count;
+    char* base_memory_address;
+    size_t arena_size;              // Khoảng cách giữa đầu hai arena liền nhau
+    MemoryArena* arenas;
+    atomic_uint next_arena;         // Arena gán cho luồng mới kế tiếp
+    pthread_key_t arena_key;
+} MultiArenaAllocator;
+
+// Chia vùng nhớ [base_addr, base_addr + total_size) thành arena_count arena dùng chiến lược backend
+MultiArenaAllocator* create_multi_arena_allocator(void* base_addr, size_t total_size, int arena_count,
+                                                  ConcurrentBackend backend, FILE* out);
+
+// Gán luồng hiện tại vào arena arena_index (thay cho cách gán vòng tròn), trả về 0 nếu thành công
+int multi_arena_bind_thread(MultiArenaAllocator* allocator, int arena_index);
+
+// Cấp phát size bytes từ arena của luồng hiện tại; arena hết chỗ thì thử các arena khác
+void* multi_arena_malloc(MultiArenaAllocator* allocator, size_t size);
+
+// Giải phóng khối do multi_arena_malloc trả về, từ bất kỳ luồng nào
+void multi_arena_free(MultiArenaAllocator* allocator, void* ptr);
+
+// Trả mọi khối đang chờ trong hàng đợi remote của các arena về bộ cấp phát của chúng
+void multi_arena_drain(MultiArenaAllocator* allocator);
+
+// Giải phóng cấu trúc quản lý; các luồng khác dùng bộ cấp phát phải kết thúc trước.
+// Vùng nhớ được quản lý không bị giải phóng.
+void cleanup_multi_arena_allocator(MultiArenaAllocator* allocator, FILE* out);
+
+#endif
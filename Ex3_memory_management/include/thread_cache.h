@@ -0,0 +1,68 @@
+#ifndef THREAD_CACHE_H
+#define THREAD_CACHE_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include "mem_alloc.h"
+#include "tlsf_alloc.h"
+#include "flat_buddy.h"
+
+// Bộ cấp phát dùng được từ nhiều luồng: mỗi luồng có một cache riêng (magazine) chứa các khối vừa giải phóng
+// theo từng lớp kích thước, nên phần lớn thao tác cấp phát/giải phóng không cần khoá.
+// Khi magazine rỗng (hoặc đầy), luồng khoá bộ cấp phát trung tâm một lần để lấy (hoặc trả) nửa magazine.
+// Bộ cấp phát trung tâm là một trong các chiến lược sẵn có, được bảo vệ bằng mutex.
+//
+// Mỗi khối có header TC_HEADER_SIZE bytes ghi lớp kích thước, nên free không cần truyền kích thước.
+// Khối lớn hơn lớp lớn nhất đi thẳng tới bộ cấp phát trung tâm.
+// Cache của một luồng được trả về bộ cấp phát trung tâm khi luồng kết thúc.
+
+#define TC_HEADER_SIZE 16
+#define TC_CLASS_COUNT 8             // Lớp kích thước 16, 32, ..., 2048 bytes (tính cả header)
+#define TC_MIN_CLASS_SHIFT 4
+#define TC_MAGAZINE_SIZE 64
+
+typedef enum ConcurrentBackend {
+    CONCURRENT_BACKEND_FIRST_FIT,
+    CONCURRENT_BACKEND_TLSF,
+    CONCURRENT_BACKEND_BUDDY
+} ConcurrentBackend;
+
+typedef struct ThreadCache {
+    struct ConcurrentAllocator* owner;
+    void* magazines[TC_CLASS_COUNT][TC_MAGAZINE_SIZE];
+    int counts[TC_CLASS_COUNT];
+    struct ThreadCache* next;       // Danh sách cache còn sống của bộ cấp phát
+    struct ThreadCache* prev;
+} ThreadCache;
+
+typedef struct ConcurrentAllocator {
+    ConcurrentBackend backend;
+    int cache_enabled;              // 0: mọi thao tác đều khoá bộ cấp phát trung tâm (để so sánh)
+    MemoryManagement* manager;
+    TLSFAllocator* tlsf;
+    FlatBuddySystem* buddy;
+
+    pthread_mutex_t lock;           // Bảo vệ bộ cấp phát trung tâm, danh sách cache và các bộ đếm
+    pthread_key_t cache_key;
+    ThreadCache* caches;
+    size_t lock_acquisitions;
+} ConcurrentAllocator;
+
+// Khởi tạo bộ cấp phát trên vùng nhớ [base_addr, base_addr + total_size) với chiến lược trung tâm backend
+ConcurrentAllocator* create_concurrent_allocator(void* base_addr, size_t total_size, ConcurrentBackend backend,
+                                                 int cache_enabled, FILE* out);
+
+// Cấp phát size bytes, an toàn khi gọi đồng thời từ nhiều luồng
+void* concurrent_malloc(ConcurrentAllocator* allocator, size_t size);
+
+// Giải phóng khối do concurrent_malloc trả về (có thể từ luồng khác luồng đã cấp phát)
+void concurrent_free(ConcurrentAllocator* allocator, void* ptr);
+
+// Trả cache của luồng hiện tại về bộ cấp phát trung tâm
+void flush_thread_cache(ConcurrentAllocator* allocator);
+
+// Giải phóng cấu trúc quản lý; các luồng khác dùng bộ cấp phát phải kết thúc trước.
+// Vùng nhớ được quản lý không bị giải phóng.
+void cleanup_concurrent_allocator(ConcurrentAllocator* allocator, FILE* out);
+
+#endif
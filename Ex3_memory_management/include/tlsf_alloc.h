@@ -0,0 +1,69 @@
+#ifndef TLSF_ALLOC_H
+#define TLSF_ALLOC_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Bộ cấp phát TLSF (Two-Level Segregated Fit): các khối trống được chia vào các lớp kích thước hai tầng.
+// Tầng 1 theo luỹ thừa của 2, tầng 2 chia đều mỗi khoảng [2^f, 2^(f+1)) thành TLSF_SL_COUNT lớp con.
+// Hai bitmap (fl_bitmap, sl_bitmap) cho biết lớp nào còn khối trống, nên cả cấp phát lẫn giải phóng
+// chỉ tốn vài lệnh ctz/clz và thời gian không phụ thuộc số khối trống (good fit, O(1)).
+//
+// Header của mỗi khối nằm ngay trước vùng dữ liệu trong vùng nhớ được quản lý:
+//   [prev_phys][size | cờ] [dữ liệu ...]
+// Khối trống dùng 16 byte đầu của vùng dữ liệu để lưu con trỏ next_free/prev_free.
+
+#define TLSF_ALIGN_SIZE 16                               // Kích thước và địa chỉ dữ liệu luôn là bội số 16
+#define TLSF_SL_COUNT_LOG2 5
+#define TLSF_SL_COUNT (1 << TLSF_SL_COUNT_LOG2)          // 32 lớp con trong mỗi lớp tầng 1
+#define TLSF_FL_SHIFT (TLSF_SL_COUNT_LOG2 + 4)           // Khối < 512 bytes nằm chung lớp tầng 1 đầu tiên
+#define TLSF_FL_MAX 40                                   // Khối lớn nhất < 1 TB
+#define TLSF_FL_COUNT (TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+
+typedef struct TLSFBlock {
+    struct TLSFBlock* prev_phys;    // Khối liền trước trong bộ nhớ
+    size_t size;                    // Kích thước dữ liệu, bit 0: khối trống, bit 1: khối liền trước trống
+    struct TLSFBlock* next_free;    // Hai trường này chỉ có nghĩa khi khối trống (nằm trong vùng dữ liệu)
+    struct TLSFBlock* prev_free;
+} TLSFBlock;
+
+typedef struct TLSFAllocator {
+    void* base_memory_address;
+    void* last_memory_address;
+    size_t total_memory_size;
+    size_t allocated_memory_size;   // Tổng kích thước dữ liệu các khối đã cấp phát (không tính header)
+    size_t free_memory_size;        // Tổng kích thước dữ liệu các khối trống
+    size_t free_block_count;
+
+    uint32_t fl_bitmap;                                      // Bit f = 1 nếu sl_bitmap[f] khác 0
+    uint32_t sl_bitmap[TLSF_FL_COUNT];                       // Bit s = 1 nếu blocks[f][s] khác NULL
+    TLSFBlock* blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];         // Đầu danh sách khối trống của từng lớp
+} TLSFAllocator;
+
+// Thống kê phân mảnh của các vùng trống
+typedef struct TLSFStats {
+    size_t free_bytes;
+    size_t free_blocks;
+    size_t largest_free_block;
+    double fragmentation;           // 1 - largest_free_block / free_bytes (0 = một vùng trống liền)
+} TLSFStats;
+
+// Khởi tạo bộ cấp phát trên vùng nhớ [base_addr, base_addr + total_size)
+TLSFAllocator* create_tlsf_allocator(void* base_addr, size_t total_size, FILE* out);
+
+// Cấp phát size bytes (làm tròn lên bội số TLSF_ALIGN_SIZE), trả về NULL nếu không có khối trống đủ lớn
+void* tlsf_malloc(TLSFAllocator* allocator, size_t size, FILE* out);
+
+// Giải phóng khối bắt đầu tại ptr và gộp với các khối trống liền kề
+void free_tlsf(TLSFAllocator* allocator, void* ptr, FILE* out);
+
+// Tính thống kê phân mảnh (duyệt các khối theo thứ tự địa chỉ)
+void tlsf_get_stats(TLSFAllocator* allocator, TLSFStats* stats);
+
+// In các khối trống theo thứ tự địa chỉ (cùng định dạng với print_free_list) và thống kê phân mảnh
+void print_tlsf_allocator(TLSFAllocator* allocator, FILE* out);
+
+// Giải phóng cấu trúc quản lý (không giải phóng vùng nhớ được quản lý)
+void cleanup_tlsf_allocator(TLSFAllocator* allocator, FILE* out);
+
+#endif
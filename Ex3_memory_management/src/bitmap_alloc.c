@@ -0,0 +1,307 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "bitmap_alloc.h"
+#include "mem_log.h"
+
+#define NOT_FOUND SIZE_MAX
+#define WORD_BITS 64
+
+static int ctz64(uint64_t x) { return __builtin_ctzll(x); }
+static int clz64(uint64_t x) { return __builtin_clzll(x); }
+
+// Cập nhật bit tóm tắt của word index ở tầng level - 1 lên các tầng trên, dừng khi trạng thái không đổi
+static void update_summary(BitmapAllocator* allocator, size_t index) {
+    for (int level = 1; level < allocator->level_count; level++) {
+        int has_free = allocator->levels[level - 1][index] != 0;
+        uint64_t* word = &allocator->levels[level][index / WORD_BITS];
+        uint64_t bit = 1ULL << (index % WORD_BITS);
+        uint64_t old = *word;
+        *word = has_free ? (old | bit) : (old & ~bit);
+        // Word tầng trên vẫn khác 0 (hoặc vẫn bằng 0) thì các tầng cao hơn không đổi
+        if ((old != 0) == (*word != 0)) return;
+        index /= WORD_BITS;
+    }
+}
+
+// Vị trí bit 1 đầu tiên >= index ở tầng level, dùng tầng trên để bỏ qua các word toàn 0
+static size_t find_next_set(const BitmapAllocator* allocator, int level, size_t index) {
+    if (index >= allocator->level_words[level] * WORD_BITS) return NOT_FOUND;
+    size_t word = index / WORD_BITS;
+    uint64_t bits = allocator->levels[level][word] & (~0ULL << (index % WORD_BITS));
+    if (bits != 0) return word * WORD_BITS + ctz64(bits);
+
+    if (level + 1 == allocator->level_count) {
+        for (word++; word < allocator->level_words[level]; word++) {
+            if (allocator->levels[level][word] != 0) return word * WORD_BITS + ctz64(allocator->levels[level][word]);
+        }
+        return NOT_FOUND;
+    }
+    size_t next_word = find_next_set(allocator, level + 1, word + 1);
+    if (next_word == NOT_FOUND) return NOT_FOUND;
+    return next_word * WORD_BITS + ctz64(allocator->levels[level][next_word]);
+}
+
+// Các vị trí p trong word mà bit p..p + count - 1 đều bằng 1 (count <= 64)
+static uint64_t run_starts(uint64_t bits, size_t count) {
+    size_t have = 1;
+    while (have < count && bits != 0) {
+        size_t shift = have < count - have ? have : count - have;
+        bits &= bits >> shift;
+        have += shift;
+    }
+    return bits;
+}
+
+// Tóm tắt đoạn trống của một word tầng 0
+static BitmapRunSummary word_summary(uint64_t bits) {
+    BitmapRunSummary summary;
+    if (bits == ~0ULL) {
+        summary.prefix = summary.suffix = summary.longest = WORD_BITS;
+        return summary;
+    }
+    summary.prefix = (uint32_t)ctz64(~bits);
+    summary.suffix = (uint32_t)clz64(~bits);
+    uint32_t longest = 0;
+    while (bits != 0) {
+        bits &= bits >> 1;
+        longest++;
+    }
+    summary.longest = longest;
+    return summary;
+}
+
+// Gộp tóm tắt hai nhánh liền kề, mỗi nhánh dài span granule
+static BitmapRunSummary merge_summary(BitmapRunSummary left, BitmapRunSummary right, uint32_t span) {
+    BitmapRunSummary summary;
+    summary.prefix = left.prefix == span ? span + right.prefix : left.prefix;
+    summary.suffix = right.suffix == span ? span + left.suffix : right.suffix;
+    summary.longest = left.longest > right.longest ? left.longest : right.longest;
+    if (left.suffix + right.prefix > summary.longest) summary.longest = left.suffix + right.prefix;
+    return summary;
+}
+
+// Tính lại lá của word index và các nút tổ tiên, dừng khi tóm tắt của một nút không đổi
+static void update_run_tree(BitmapAllocator* allocator, size_t index) {
+    BitmapRunSummary* tree = allocator->run_tree;
+    size_t node = allocator->run_leaves + index;
+    tree[node] = word_summary(allocator->levels[0][index]);
+    for (uint32_t span = WORD_BITS; node > 1; span *= 2) {
+        node /= 2;
+        BitmapRunSummary summary = merge_summary(tree[2 * node], tree[2 * node + 1], span);
+        if (memcmp(&summary, &tree[node], sizeof(summary)) == 0) return;
+        tree[node] = summary;
+    }
+}
+
+// Granule đầu của đoạn trống đầu tiên (địa chỉ thấp nhất) dài ít nhất count granule
+static size_t find_first_run(const BitmapAllocator* allocator, size_t count) {
+    const BitmapRunSummary* tree = allocator->run_tree;
+    if (tree[1].longest < count) return NOT_FOUND;
+
+    size_t node = 1;
+    size_t offset = 0; // Granule đầu của nhánh node
+    size_t span = allocator->run_leaves * WORD_BITS;
+    while (node < allocator->run_leaves) {
+        span /= 2;
+        const BitmapRunSummary* left = &tree[2 * node];
+        const BitmapRunSummary* right = &tree[2 * node + 1];
+        if (left->longest >= count) {
+            node = 2 * node;
+        } else if ((size_t)left->suffix + right->prefix >= count) {
+            // Đoạn vắt qua ranh giới hai nhánh bắt đầu trước mọi đoạn nằm trọn trong nhánh phải
+            return offset + span - left->suffix;
+        } else {
+            node = 2 * node + 1;
+            offset += span;
+        }
+    }
+    // Đoạn nằm trọn trong một word nên count <= 64
+    size_t word = node - allocator->run_leaves;
+    return word * WORD_BITS + ctz64(run_starts(allocator->levels[0][word], count));
+}
+
+// Đặt (free = 1) hoặc xoá các bit granule trong [first, first + count) và cập nhật tầng tóm tắt
+static void mark_granules(BitmapAllocator* allocator, size_t first, size_t count, int free) {
+    size_t last = first + count;
+    while (first < last) {
+        size_t word = first / WORD_BITS;
+        size_t offset = first % WORD_BITS;
+        size_t n = WORD_BITS - offset < last - first ? WORD_BITS - offset : last - first;
+        uint64_t mask = (n == WORD_BITS ? ~0ULL : ((1ULL << n) - 1)) << offset;
+        if (free) {
+            allocator->levels[0][word] |= mask;
+        } else {
+            allocator->levels[0][word] &= ~mask;
+        }
+        update_summary(allocator, word);
+        update_run_tree(allocator, word);
+        first += n;
+    }
+}
+
+BitmapAllocator* create_bitmap_allocator(void* base_addr, size_t total_size, FILE* out) {
+    if (base_addr == NULL || total_size < BITMAP_GRANULE_SIZE) {
+        MEM_LOG(out, "[create_bitmap_allocator] Lỗi: Tham số khởi tạo không hợp lệ.\n");
+        return NULL;
+    }
+
+    BitmapAllocator* allocator = (BitmapAllocator*)calloc(1, sizeof(BitmapAllocator));
+    if (allocator == NULL) {
+        MEM_LOG(out, "[create_bitmap_allocator] Lỗi: Không thể cấp phát cấu trúc BitmapAllocator.\n");
+        return NULL;
+    }
+    allocator->base_memory_address = base_addr;
+    allocator->total_memory_size = total_size;
+    allocator->last_memory_address = (char*)base_addr + total_size;
+    allocator->granule_count = total_size / BITMAP_GRANULE_SIZE;
+
+    // Dựng các tầng cho tới khi tầng trên cùng chỉ còn một word
+    size_t bits = allocator->granule_count;
+    int ok = 1;
+    do {
+        if (allocator->level_count == BITMAP_MAX_LEVELS) {
+            ok = 0;
+            break;
+        }
+        size_t words = (bits + WORD_BITS - 1) / WORD_BITS;
+        allocator->level_words[allocator->level_count] = words;
+        allocator->levels[allocator->level_count] = (uint64_t*)calloc(words, sizeof(uint64_t));
+        ok = allocator->levels[allocator->level_count] != NULL;
+        allocator->level_count++;
+        bits = words;
+    } while (ok && (bits > 1 || allocator->level_count < 2)); // Luôn có ít nhất một tầng tóm tắt
+    allocator->end_bits = ok ? (uint64_t*)calloc(allocator->level_words[0], sizeof(uint64_t)) : NULL;
+
+    // Các lá thừa sau word cuối giữ tóm tắt 0 nên không bao giờ được chọn
+    allocator->run_leaves = 1;
+    while (allocator->run_leaves < allocator->level_words[0]) allocator->run_leaves *= 2;
+    allocator->run_tree = ok ? (BitmapRunSummary*)calloc(2 * allocator->run_leaves, sizeof(BitmapRunSummary)) : NULL;
+
+    if (!ok || allocator->end_bits == NULL || allocator->run_tree == NULL) {
+        MEM_LOG(out, "[create_bitmap_allocator] Lỗi: Không thể cấp phát bitmap cho %zu granule.\n", allocator->granule_count);
+        cleanup_bitmap_allocator(allocator, NULL);
+        return NULL;
+    }
+
+    // Ban đầu mọi granule đều trống; các bit thừa ở word cuối giữ 0 nên không bao giờ được chọn
+    mark_granules(allocator, 0, allocator->granule_count, 1);
+    allocator->free_granules = allocator->granule_count;
+
+    MEM_LOG(out, "[create_bitmap_allocator] Vùng nhớ %p, kích thước %zu bytes, %zu granule, %d tầng bitmap.\n",
+            base_addr, total_size, allocator->granule_count, allocator->level_count);
+    return allocator;
+}
+
+void* bitmap_malloc(BitmapAllocator* allocator, size_t size, FILE* out) {
+    if (allocator == NULL) {
+        MEM_LOG(out, "[bitmap_malloc] Lỗi: Con trỏ allocator là NULL.\n");
+        return NULL;
+    }
+    if (size == 0) {
+        MEM_LOG(out, "[bitmap_malloc] Kích thước khối nhớ xin cấp phát không hợp lệ.\n");
+        return NULL;
+    }
+
+    size_t count = (size + BITMAP_GRANULE_SIZE - 1) / BITMAP_GRANULE_SIZE;
+    if (count > allocator->free_granules) {
+        MEM_LOG(out, "[bitmap_malloc] Không tồn tại vùng trống tự do đáp ứng yêu cầu (%zu bytes).\n", size);
+        return NULL;
+    }
+
+    // Đi từ gốc run_tree xuống đoạn trống đầu tiên đủ dài, không phụ thuộc số word đã bị chiếm
+    size_t start = find_first_run(allocator, count);
+
+    if (start == NOT_FOUND) {
+        MEM_LOG(out, "[bitmap_malloc] Không tồn tại vùng trống tự do đáp ứng yêu cầu (%zu bytes).\n", size);
+        return NULL;
+    }
+
+    mark_granules(allocator, start, count, 0);
+    allocator->end_bits[(start + count - 1) / WORD_BITS] |= 1ULL << ((start + count - 1) % WORD_BITS);
+    allocator->free_granules -= count;
+    allocator->allocated_memory_size += count * BITMAP_GRANULE_SIZE;
+
+    void* allocated_addr = (char*)allocator->base_memory_address + start * BITMAP_GRANULE_SIZE;
+    MEM_LOG(out, "[bitmap_malloc] Cấp phát %zu bytes (%zu granule) tại địa chỉ %p.\n", size, count, allocated_addr);
+    return allocated_addr;
+}
+
+static int test_bit(const uint64_t* bits, size_t index) {
+    return (bits[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+void free_bitmap(BitmapAllocator* allocator, void* ptr, FILE* out) {
+    if (allocator == NULL) {
+        MEM_LOG(out, "[free_bitmap] Lỗi: Con trỏ allocator là NULL.\n");
+        return;
+    }
+    if (ptr == NULL) {
+        MEM_LOG(out, "[free_bitmap] Không thể giải phóng địa chỉ NULL.\n");
+        return;
+    }
+
+    size_t offset = (size_t)((char*)ptr - (char*)allocator->base_memory_address);
+    if (ptr < allocator->base_memory_address || ptr >= allocator->last_memory_address ||
+        offset % BITMAP_GRANULE_SIZE != 0) {
+        MEM_LOG(out, "[free_bitmap] Địa chỉ %p nằm ngoài vùng bộ nhớ được quản lý hoặc không thẳng hàng granule.\n", ptr);
+        return;
+    }
+
+    // ptr phải là granule đầu của một khối đang cấp phát: granule đó bận, granule trước trống hoặc là cuối một khối khác
+    size_t first = offset / BITMAP_GRANULE_SIZE;
+    if (first >= allocator->granule_count || test_bit(allocator->levels[0], first) ||
+        (first > 0 && !test_bit(allocator->levels[0], first - 1) && !test_bit(allocator->end_bits, first - 1))) {
+        MEM_LOG(out, "[free_bitmap] Địa chỉ %p không phải đầu một khối đang được cấp phát.\n", ptr);
+        return;
+    }
+
+    // Granule cuối của khối là bit 1 đầu tiên trong end_bits tính từ first
+    size_t word = first / WORD_BITS;
+    uint64_t bits = allocator->end_bits[word] & (~0ULL << (first % WORD_BITS));
+    while (bits == 0) bits = allocator->end_bits[++word];
+    size_t last = word * WORD_BITS + ctz64(bits);
+    size_t count = last - first + 1;
+
+    allocator->end_bits[word] &= ~(1ULL << (last % WORD_BITS));
+    mark_granules(allocator, first, count, 1);
+    allocator->free_granules += count;
+    allocator->allocated_memory_size -= count * BITMAP_GRANULE_SIZE;
+
+    MEM_LOG(out, "[free_bitmap] Đã giải phóng %zu bytes (%zu granule) tại địa chỉ %p.\n", count * BITMAP_GRANULE_SIZE, count, ptr);
+}
+
+void print_bitmap_allocator(BitmapAllocator* allocator, FILE* out) {
+    if (allocator == NULL) {
+        MEM_LOG(out, "[print_bitmap_allocator] Lỗi: Con trỏ allocator là NULL.\n");
+        return;
+    }
+    MEM_LOG(out, "\n================= Bitmap Allocator =================\n");
+    MEM_LOG(out, "Kích thước vùng bộ nhớ quản lý: %zu bytes, Đã cấp phát: %zu bytes, Granule trống: %zu/%zu\n",
+            allocator->total_memory_size, allocator->allocated_memory_size, allocator->free_granules, allocator->granule_count);
+
+    // In các đoạn granule trống liên tiếp
+    int i = 0;
+    size_t start = find_next_set(allocator, 0, 0);
+    while (start != NOT_FOUND) {
+        size_t end = start;
+        while (end < allocator->granule_count && test_bit(allocator->levels[0], end)) end++;
+        MEM_LOG(out, "Block %d: Start Addr: %p, Size: %zu bytes\n", i++,
+                (void*)((char*)allocator->base_memory_address + start * BITMAP_GRANULE_SIZE), (end - start) * BITMAP_GRANULE_SIZE);
+        start = find_next_set(allocator, 0, end);
+    }
+    MEM_LOG(out, "====================================================\n\n");
+}
+
+void cleanup_bitmap_allocator(BitmapAllocator* allocator, FILE* out) {
+    if (allocator == NULL) {
+        MEM_LOG(out, "[cleanup_bitmap_allocator] Con trỏ allocator trỏ tới NULL.\n");
+        return;
+    }
+    for (int level = 0; level < allocator->level_count; level++) free(allocator->levels[level]);
+    free(allocator->end_bits);
+    free(allocator->run_tree);
+    free(allocator);
+    MEM_LOG(out, "[cleanup_bitmap_allocator] Đã giải phóng cấu trúc quản lý bitmap.\n");
+}
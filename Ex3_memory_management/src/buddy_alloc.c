@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include "buddy_alloc.h"
+#include "mem_log.h"
 
 #define MIN_BLOCK_SIZE 1  // KB
 
@@ -15,13 +16,13 @@ size_t next_power_of_two(size_t n) {
 // Tạo và khởi tạo buddy system
 BuddySystem* create_buddy_system(void *base_addr, size_t total_size, FILE *out) {
     if (base_addr == NULL || total_size <= MIN_BLOCK_SIZE) {
-        fprintf(out, "[create_buddy_system] Lỗi: Tham số khởi tạo hệ thống Buddy không hợp lệ.\n");
+        MEM_LOG(out, "[create_buddy_system] Lỗi: Tham số khởi tạo hệ thống Buddy không hợp lệ.\n");
         return NULL;
     }
 
     BuddySystem* system = (BuddySystem*)malloc(sizeof(BuddySystem));
     if (system == NULL) {
-        fprintf(out, "[create_buddy_system] Lỗi: Không thể cấp phát cho Buddy System.\n");
+        MEM_LOG(out, "[create_buddy_system] Lỗi: Không thể cấp phát cho Buddy System.\n");
         return NULL;
     }
 
@@ -36,7 +37,7 @@ BuddySystem* create_buddy_system(void *base_addr, size_t total_size, FILE *out)
     // Tạo block ban đầu với kích thước lớn nhất
     BuddyBlock* root_block = (BuddyBlock*)malloc(sizeof(BuddyBlock));
     if (root_block == NULL) {
-        fprintf(out, "[create_buddy_system] Lỗi: Không thể cấp phát initial_block.\n");
+        MEM_LOG(out, "[create_buddy_system] Lỗi: Không thể cấp phát initial_block.\n");
         free(system);
         return NULL;
     }
@@ -53,14 +54,14 @@ BuddySystem* create_buddy_system(void *base_addr, size_t total_size, FILE *out)
     // Gán root trỏ vào vùng trống lớn nhất vừa khởi tạo
     system->root = root_block;
 
-    fprintf(out, "[create_buddy_system] Đã khởi tạo buddy system");
+    MEM_LOG(out, "[create_buddy_system] Đã khởi tạo buddy system");
     return system;
 }
 
 // Hàm chia thành hai buddy
 BuddyBlock* split_block(BuddyBlock* block, FILE *out) {
     if (block == NULL) {
-        fprintf(out, "[split_block] Lỗi: Block không hợp lệ.\n");
+        MEM_LOG(out, "[split_block] Lỗi: Block không hợp lệ.\n");
         return NULL;
     }
 
@@ -69,7 +70,7 @@ BuddyBlock* split_block(BuddyBlock* block, FILE *out) {
     BuddyBlock* left_child = (BuddyBlock*)malloc(sizeof(BuddyBlock));
     BuddyBlock* right_child = (BuddyBlock*)malloc(sizeof(BuddyBlock));
     if (left_child == NULL || right_child == NULL) {
-        fprintf(out, "[split_block] Lỗi: Không thể cấp phát cho các buddy con.\n");
+        MEM_LOG(out, "[split_block] Lỗi: Không thể cấp phát cho các buddy con.\n");
         free(left_child);
         free(right_child);
     }
@@ -159,12 +160,12 @@ BuddyBlock* find_and_allocate(BuddyBlock *root, size_t request_size, FILE* out)
 // Cấp phát bộ nhớ sử dụng buddy system
 BuddyBlock* buddy_malloc(BuddySystem *system, size_t request_size, FILE *out) {
     if (system == NULL || system->root == NULL) {
-        fprintf(out, "[buddy_malloc] Lỗi: Hệ thống Buddy không tồn tại.\n");
+        MEM_LOG(out, "[buddy_malloc] Lỗi: Hệ thống Buddy không tồn tại.\n");
         return NULL;
     }
 
     if (request_size < MIN_BLOCK_SIZE || request_size >= system->total_memory_size) {
-        fprintf(out, "[buddy_malloc] Lỗi: Yêu cầu cấp phát vùng trống không hợp lệ.\n");
+        MEM_LOG(out, "[buddy_malloc] Lỗi: Yêu cầu cấp phát vùng trống không hợp lệ.\n");
         return NULL;
     }
 
@@ -174,7 +175,7 @@ BuddyBlock* buddy_malloc(BuddySystem *system, size_t request_size, FILE *out) {
     // Tìm vùng trống tự do phù hợp và cấp phát
     BuddyBlock *allocated_block = find_and_allocate(system->root, actual_size, out);
     if (allocated_block == NULL) {
-        fprintf(out, "[buddy_malloc] Không tìm thấy block phù hợp.\n");
+        MEM_LOG(out, "[buddy_malloc] Không tìm thấy block phù hợp.\n");
         return NULL;
     }
 
@@ -191,15 +192,15 @@ BuddyBlock* buddy_malloc(BuddySystem *system, size_t request_size, FILE *out) {
 // Hợp nhất các buddies
 BuddyBlock* merge_buddies(BuddyBlock* request_block, FILE *out) {
     if (request_block == NULL || request_block->parent == NULL) {
-        fprintf(out, "[merge_buddies] Khối yêu cầu hiện tại không tồn tại hoặc khối hiện tại không có cha.\n");
+        MEM_LOG(out, "[merge_buddies] Khối yêu cầu hiện tại không tồn tại hoặc khối hiện tại không có cha.\n");
         return request_block; // Trả về khối buddy hiện tại
     }
 
     BuddyBlock* parent = request_block->parent;
     BuddyBlock* buddy = (request_block == parent->leftChild) ? parent->rightChild : parent->leftChild;
 
-    // Nếu buddy không tồn tại hoặc đang được cấp phát thì không thể gộp
-    if (buddy == NULL || !buddy->is_free) return request_block;
+    // Nếu buddy không tồn tại, đang được cấp phát hoặc đã bị chia (còn khối con) thì không thể gộp
+    if (buddy == NULL || !buddy->is_free || buddy->leftChild != NULL || buddy->rightChild != NULL) return request_block;
 
     // Giải phóng bộ nhớ buddy và chính block hiện tại
     free(parent->leftChild);
@@ -208,7 +209,7 @@ BuddyBlock* merge_buddies(BuddyBlock* request_block, FILE *out) {
     parent->rightChild = NULL;
     parent->is_free = 1;
 
-    fprintf(out, "[merge_buddies] Gộp thành công block size %zu tại level %d\n",
+    MEM_LOG(out, "[merge_buddies] Gộp thành công block size %zu tại level %d\n",
             parent->size, parent->level);
 
     // Đệ quy lên parent
@@ -218,13 +219,13 @@ BuddyBlock* merge_buddies(BuddyBlock* request_block, FILE *out) {
 
 void free_buddy(BuddySystem *system, BuddyBlock* request_block, FILE *out) {
     if (system == NULL || system->root == NULL || request_block == NULL) {
-        fprintf(out, "[buddy_free] Lỗi: Hệ thống Buddy hoặc khối nhớ không tồn tại.\n");
+        MEM_LOG(out, "[buddy_free] Lỗi: Hệ thống Buddy hoặc khối nhớ không tồn tại.\n");
         return;
     }
 
     request_block->is_free = 1;
     system->allocated_memory_size -= request_block->actual_allocated_size;
-    fprintf(out, "[buddy_free] Đã đánh dấu block size %zu tại địa chỉ %p là tự do.\n",
+    MEM_LOG(out, "[buddy_free] Đã đánh dấu block size %zu tại địa chỉ %p là tự do.\n",
             request_block->size, request_block->start_addr);
 
     // Gộp nếu có thể
@@ -245,7 +246,7 @@ void free_buddy_tree(BuddyBlock* node) {
 
 void cleanup_buddy_system(BuddySystem *system, FILE *out) {
     if (system == NULL) {
-        fprintf(out, "[cleanup_buddy_system] Con trỏ system trỏ tới NULL.\n");
+        MEM_LOG(out, "[cleanup_buddy_system] Con trỏ system trỏ tới NULL.\n");
         return;
     }
 
@@ -255,7 +256,7 @@ void cleanup_buddy_system(BuddySystem *system, FILE *out) {
     // Giải phóng system
     free(system);
 
-    fprintf(out, "[cleanup_buddy_system] Đã giải phóng toàn bộ bộ nhớ của Buddy System.\n");
+    MEM_LOG(out, "[cleanup_buddy_system] Đã giải phóng toàn bộ bộ nhớ của Buddy System.\n");
 }
 
 
@@ -267,7 +268,7 @@ void print_free_blocks(BuddyBlock* node, FILE* out) {
 
     // In block nếu nó đang free và là nút lá
     if (node->is_free && node->leftChild == NULL && node->rightChild == NULL) {
-        fprintf(out, "Free block | Start: %p | Size: %zu KB | Level: %d\n",
+        MEM_LOG(out, "Free block | Start: %p | Size: %zu KB | Level: %d\n",
                 node->start_addr, node->size, node->level);
     }
 
@@ -277,15 +278,15 @@ void print_free_blocks(BuddyBlock* node, FILE* out) {
 
 void print_buddy_system(BuddySystem *system, FILE *out) {
     if (system == NULL || system->root == NULL) {
-        fprintf(out, "[print_buddy_system] Lỗi: Buddy system chưa được khởi tạo.\n");
+        MEM_LOG(out, "[print_buddy_system] Lỗi: Buddy system chưa được khởi tạo.\n");
         return;
     }
 
-    fprintf(out, "\n================== Buddy System Free Blocks ==================\n");
-    fprintf(out, "Total memory: %zu KB | Allocated: %zu KB | Max level: %d\n\n",
+    MEM_LOG(out, "\n================== Buddy System Free Blocks ==================\n");
+    MEM_LOG(out, "Total memory: %zu KB | Allocated: %zu KB | Max level: %d\n\n",
             system->total_memory_size, system->allocated_memory_size, system->max_level);
 
     print_free_blocks(system->root, out);
 
-    fprintf(out, "===============================================================\n");
+    MEM_LOG(out, "===============================================================\n");
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include "flat_buddy.h"
+#include "mem_log.h"
+
+#define WORD_BITS 64
+
+static int test_bit(const uint64_t* bits, size_t index) { return (bits[index / WORD_BITS] >> (index % WORD_BITS)) & 1; }
+static void set_bit(uint64_t* bits, size_t index) { bits[index / WORD_BITS] |= 1ULL << (index % WORD_BITS); }
+static void clear_bit(uint64_t* bits, size_t index) { bits[index / WORD_BITS] &= ~(1ULL << (index % WORD_BITS)); }
+
+static size_t order_size(int order) { return (size_t)1 << (order + FLAT_BUDDY_MIN_ORDER); }
+
+// Chỉ số node của khối bậc order bắt đầu tại offset
+static size_t node_index(const FlatBuddySystem* system, int order, size_t offset) {
+    return ((size_t)1 << (system->top_order - order)) + (offset >> (order + FLAT_BUDDY_MIN_ORDER));
+}
+
+static void push_free(FlatBuddySystem* system, int order, size_t offset) {
+    FlatBuddyNode* node = (FlatBuddyNode*)((char*)system->base_memory_address + offset);
+    node->prev = NULL;
+    node->next = system->free_lists[order];
+    if (node->next != NULL) node->next->prev = node;
+    system->free_lists[order] = node;
+    system->nonempty_orders |= 1ULL << order;
+    system->free_counts[order]++;
+    set_bit(system->free_bits, node_index(system, order, offset));
+}
+
+static void remove_free(FlatBuddySystem* system, int order, size_t offset) {
+    FlatBuddyNode* node = (FlatBuddyNode*)((char*)system->base_memory_address + offset);
+    if (node->prev != NULL) {
+        node->prev->next = node->next;
+    } else {
+        system->free_lists[order] = node->next;
+        if (node->next == NULL) system->nonempty_orders &= ~(1ULL << order);
+    }
+    if (node->next != NULL) node->next->prev = node->prev;
+    system->free_counts[order]--;
+    clear_bit(system->free_bits, node_index(system, order, offset));
+}
+
+// Commit các đơn vị chưa commit giao với [offset, offset + size), mỗi dãy đơn vị liền nhau một lời gọi mprotect
+static int commit_range(FlatBuddySystem* system, size_t offset, size_t size) {
+    size_t last = (offset + size - 1) / FLAT_BUDDY_COMMIT_SIZE;
+    for (size_t unit = offset / FLAT_BUDDY_COMMIT_SIZE; unit <= last; unit++) {
+        if (test_bit(system->commit_bits, unit)) continue;
+        size_t end = unit + 1;
+        while (end <= last && !test_bit(system->commit_bits, end)) end++;
+        char* start = (char*)system->base_memory_address + unit * FLAT_BUDDY_COMMIT_SIZE;
+        size_t length = (end - unit) * FLAT_BUDDY_COMMIT_SIZE;
+        if (mprotect(start, length, PROT_READ | PROT_WRITE) != 0) return -1;
+        for (size_t i = unit; i < end; i++) set_bit(system->commit_bits, i);
+        system->committed_bytes += length;
+        system->commit_calls++;
+        unit = end;
+    }
+    return 0;
+}
+
+// Trả cho hệ điều hành các đơn vị đang commit trong [offset, offset + size) (offset, size là bội số đơn vị commit).
+// Từ đang toàn 0 trong commit_bits được bỏ qua cả 64 đơn vị, nên gộp lại khối rất lớn đã trả trang phần lớn vẫn rẻ.
+static void release_range(FlatBuddySystem* system, size_t offset, size_t size) {
+    size_t unit = offset / FLAT_BUDDY_COMMIT_SIZE;
+    size_t last = (offset + size) / FLAT_BUDDY_COMMIT_SIZE;
+    while (unit < last) {
+        if (unit % WORD_BITS == 0 && unit + WORD_BITS <= last && system->commit_bits[unit / WORD_BITS] == 0) {
+            unit += WORD_BITS;
+            continue;
+        }
+        if (!test_bit(system->commit_bits, unit)) {
+            unit++;
+            continue;
+        }
+        size_t end = unit + 1;
+        while (end < last && test_bit(system->commit_bits, end)) end++;
+        char* start = (char*)system->base_memory_address + unit * FLAT_BUDDY_COMMIT_SIZE;
+        size_t length = (end - unit) * FLAT_BUDDY_COMMIT_SIZE;
+        // DONTNEED bỏ các trang ngay (lần chạm sau là trang 0 mới), PROT_NONE để truy cập nhầm vào khối đã giải phóng bị bắt
+        if (madvise(start, length, MADV_DONTNEED) == 0 && mprotect(start, length, PROT_NONE) == 0) {
+            for (size_t i = unit; i < end; i++) clear_bit(system->commit_bits, i);
+            system->committed_bytes -= length;
+            system->release_calls++;
+        }
+        unit = end;
+    }
+}
+
+// Chia vùng [offset, offset + 2^order) thành các khối trống nằm trọn trong vùng nhớ được quản lý
+static int seed_free_blocks(FlatBuddySystem* system, int order, size_t offset) {
+    if (offset >= system->managed_memory_size) return 0;
+    if (offset + order_size(order) <= system->managed_memory_size) {
+        // Ở chế độ arena node danh sách trống phải nằm trên trang đã commit
+        if (system->commit_bits != NULL && commit_range(system, offset, sizeof(FlatBuddyNode)) != 0) return -1;
+        push_free(system, order, offset);
+        return 0;
+    }
+    set_bit(system->split_bits, node_index(system, order, offset));
+    if (seed_free_blocks(system, order - 1, offset) != 0) return -1;
+    return seed_free_blocks(system, order - 1, offset + order_size(order - 1));
+}
+
+// Phần khởi tạo chung của create_flat_buddy_system và create_flat_buddy_arena, system đã được calloc
+static FlatBuddySystem* setup_flat_buddy_system(FlatBuddySystem* system, void* base_addr, size_t total_size, FILE* out) {
+    system->base_memory_address = base_addr;
+    system->total_memory_size = total_size;
+    system->last_memory_address = (char*)base_addr + total_size;
+    system->managed_memory_size = total_size & ~(order_size(0) - 1);
+    while (order_size(system->top_order) < system->managed_memory_size) system->top_order++;
+    if (system->top_order >= FLAT_BUDDY_MAX_ORDERS) {
+        MEM_LOG(out, "[create_flat_buddy_system] Lỗi: Vùng nhớ %zu bytes quá lớn.\n", total_size);
+        cleanup_flat_buddy_system(system, NULL);
+        return NULL;
+    }
+
+    // Cây có 2^(top_order + 1) node (chỉ số 0 không dùng)
+    size_t words = (((size_t)2 << system->top_order) + WORD_BITS - 1) / WORD_BITS;
+    system->split_bits = (uint64_t*)calloc(words, sizeof(uint64_t));
+    system->free_bits = (uint64_t*)calloc(words, sizeof(uint64_t));
+    if (system->split_bits == NULL || system->free_bits == NULL) {
+        MEM_LOG(out, "[create_flat_buddy_system] Lỗi: Không thể cấp phát bitmap trạng thái.\n");
+        cleanup_flat_buddy_system(system, NULL);
+        return NULL;
+    }
+    if (seed_free_blocks(system, system->top_order, 0) != 0) {
+        MEM_LOG(out, "[create_flat_buddy_system] Lỗi: Không thể commit trang cho danh sách trống.\n");
+        cleanup_flat_buddy_system(system, NULL);
+        return NULL;
+    }
+
+    MEM_LOG(out, "[create_flat_buddy_system] Đã khởi tạo buddy system %zu bytes, bậc cao nhất %d (%zu bytes).\n",
+            system->managed_memory_size, system->top_order, order_size(system->top_order));
+    return system;
+}
+
+FlatBuddySystem* create_flat_buddy_system(void* base_addr, size_t total_size, FILE* out) {
+    if (base_addr == NULL || (uintptr_t)base_addr % order_size(0) != 0 || total_size < order_size(0)) {
+        MEM_LOG(out, "[create_flat_buddy_system] Lỗi: Tham số khởi tạo hệ thống Buddy không hợp lệ.\n");
+        return NULL;
+    }
+
+    FlatBuddySystem* system = (FlatBuddySystem*)calloc(1, sizeof(FlatBuddySystem));
+    if (system == NULL) {
+        MEM_LOG(out, "[create_flat_buddy_system] Lỗi: Không thể cấp phát cho Buddy System.\n");
+        return NULL;
+    }
+    return setup_flat_buddy_system(system, base_addr, total_size, out);
+}
+
+FlatBuddySystem* create_flat_buddy_arena(size_t reserve_size, size_t release_size, FILE* out) {
+    if (reserve_size == 0 || reserve_size > SIZE_MAX - FLAT_BUDDY_COMMIT_SIZE) {
+        MEM_LOG(out, "[create_flat_buddy_arena] Lỗi: Kích thước arena không hợp lệ.\n");
+        return NULL;
+    }
+    reserve_size = (reserve_size + FLAT_BUDDY_COMMIT_SIZE - 1) & ~(size_t)(FLAT_BUDDY_COMMIT_SIZE - 1);
+    size_t min_release = 2 * (size_t)FLAT_BUDDY_COMMIT_SIZE;
+    if (release_size < min_release) release_size = min_release;
+    while (release_size & (release_size - 1)) release_size += release_size & -release_size; // Làm tròn lên luỹ thừa 2
+
+    FlatBuddySystem* system = (FlatBuddySystem*)calloc(1, sizeof(FlatBuddySystem));
+    // Chỉ giữ chỗ địa chỉ ảo: PROT_NONE + MAP_NORESERVE không tính vào bộ nhớ commit của tiến trình
+    void* base_addr = mmap(NULL, reserve_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (system == NULL || base_addr == MAP_FAILED) {
+        MEM_LOG(out, "[create_flat_buddy_arena] Lỗi: Không thể giữ chỗ %zu bytes địa chỉ ảo.\n", reserve_size);
+        if (base_addr != MAP_FAILED) munmap(base_addr, reserve_size);
+        free(system);
+        return NULL;
+    }
+    system->release_size = release_size;
+    system->commit_bits = (uint64_t*)calloc((reserve_size / FLAT_BUDDY_COMMIT_SIZE + WORD_BITS - 1) / WORD_BITS,
+                                            sizeof(uint64_t));
+    if (system->commit_bits == NULL) {
+        MEM_LOG(out, "[create_flat_buddy_arena] Lỗi: Không thể cấp phát bitmap commit.\n");
+        munmap(base_addr, reserve_size);
+        free(system);
+        return NULL;
+    }
+    if (setup_flat_buddy_system(system, base_addr, reserve_size, out) == NULL) return NULL;
+
+    MEM_LOG(out, "[create_flat_buddy_arena] Giữ chỗ %zu bytes tại %p, trả trang khi gộp được khối >= %zu bytes.\n",
+            reserve_size, base_addr, release_size);
+    return system;
+}
+
+void* flat_buddy_malloc(FlatBuddySystem* system, size_t size, FILE* out) {
+    if (system == NULL) {
+        MEM_LOG(out, "[flat_buddy_malloc] Lỗi: Hệ thống Buddy không tồn tại.\n");
+        return NULL;
+    }
+    if (size == 0 || size > system->managed_memory_size) {
+        MEM_LOG(out, "[flat_buddy_malloc] Lỗi: Yêu cầu cấp phát vùng trống không hợp lệ.\n");
+        return NULL;
+    }
+
+    int order = 0;
+    while (order_size(order) < size) order++;
+
+    // Bậc nhỏ nhất >= order còn khối trống
+    uint64_t candidates = system->nonempty_orders & (~0ULL << order);
+    if (candidates == 0) {
+        MEM_LOG(out, "[flat_buddy_malloc] Không tìm thấy block phù hợp cho %zu bytes.\n", size);
+        return NULL;
+    }
+    int current = __builtin_ctzll(candidates);
+    size_t offset = (size_t)((char*)system->free_lists[current] - (char*)system->base_memory_address);
+
+    // Arena: commit khối trả về và trang chứa node của các nửa buddy sắp đưa về danh sách trống trước khi đổi trạng thái
+    if (system->commit_bits != NULL) {
+        int failed = commit_range(system, offset, order_size(order)) != 0;
+        for (int split = order; split < current && !failed; split++) {
+            failed = commit_range(system, offset + order_size(split), sizeof(FlatBuddyNode)) != 0;
+        }
+        if (failed) {
+            MEM_LOG(out, "[flat_buddy_malloc] Lỗi: Không thể commit trang cho %zu bytes.\n", size);
+            return NULL;
+        }
+    }
+    remove_free(system, current, offset);
+
+    // Chia đôi tới khi đạt bậc yêu cầu, nửa phải (buddy) trả về danh sách trống
+    while (current > order) {
+        set_bit(system->split_bits, node_index(system, current, offset));
+        current--;
+        push_free(system, current, offset ^ order_size(current));
+    }
+    system->allocated_memory_size += order_size(order);
+
+    void* allocated_addr = (char*)system->base_memory_address + offset;
+    MEM_LOG(out, "[flat_buddy_malloc] Cấp phát %zu bytes (khối %zu bytes) tại địa chỉ %p.\n", size, order_size(order), allocated_addr);
+    return allocated_addr;
+}
+
+void free_flat_buddy(FlatBuddySystem* system, void* ptr, FILE* out) {
+    if (system == NULL || ptr == NULL) {
+        MEM_LOG(out, "[free_flat_buddy] Lỗi: Hệ thống Buddy hoặc khối nhớ không tồn tại.\n");
+        return;
+    }
+    size_t offset = (size_t)((char*)ptr - (char*)system->base_memory_address);
+    if ((char*)ptr < (char*)system->base_memory_address || offset >= system->managed_memory_size ||
+        offset % order_size(0) != 0) {
+        MEM_LOG(out, "[free_flat_buddy] Địa chỉ %p nằm ngoài vùng bộ nhớ được quản lý.\n", ptr);
+        return;
+    }
+
+    // Bậc của khối: đi từ gốc xuống theo các node đã bị chia
+    int order = system->top_order;
+    while (test_bit(system->split_bits, node_index(system, order, offset & ~(order_size(order) - 1)))) order--;
+    size_t node = node_index(system, order, offset);
+    if ((offset & (order_size(order) - 1)) != 0 || test_bit(system->free_bits, node)) {
+        MEM_LOG(out, "[free_flat_buddy] Địa chỉ %p không phải đầu một khối đang được cấp phát.\n", ptr);
+        return;
+    }
+    system->allocated_memory_size -= order_size(order);
+    MEM_LOG(out, "[free_flat_buddy] Giải phóng khối %zu bytes tại địa chỉ %p.\n", order_size(order), ptr);
+
+    // Gộp với buddy (offset ^ kích thước khối) khi buddy cũng trống
+    while (order < system->top_order) {
+        size_t buddy = offset ^ order_size(order);
+        if (buddy >= system->managed_memory_size || !test_bit(system->free_bits, node_index(system, order, buddy))) break;
+        remove_free(system, order, buddy);
+        offset &= ~order_size(order);
+        order++;
+        clear_bit(system->split_bits, node_index(system, order, offset));
+        MEM_LOG(out, "[free_flat_buddy] Gộp thành khối %zu bytes tại offset %zu.\n", order_size(order), offset);
+    }
+    // Đầu khối gộp là đầu khối vừa giải phóng hoặc đầu một buddy trống, nên node luôn nằm trên trang đã commit
+    push_free(system, order, offset);
+
+    if (system->commit_bits != NULL && order_size(order) >= system->release_size) {
+        size_t before = system->committed_bytes;
+        release_range(system, offset + FLAT_BUDDY_COMMIT_SIZE, order_size(order) - FLAT_BUDDY_COMMIT_SIZE);
+        if (system->committed_bytes != before) {
+            MEM_LOG(out, "[free_flat_buddy] Trả %zu bytes cho hệ điều hành.\n", before - system->committed_bytes);
+        }
+    }
+}
+
+void print_flat_buddy_system(FlatBuddySystem* system, FILE* out) {
+    if (system == NULL) {
+        MEM_LOG(out, "[print_flat_buddy_system] Lỗi: Buddy system chưa được khởi tạo.\n");
+        return;
+    }
+    MEM_LOG(out, "\n================== Flat Buddy System Free Blocks ==================\n");
+    MEM_LOG(out, "Total memory: %zu bytes | Allocated: %zu bytes | Top order: %d\n\n",
+            system->managed_memory_size, system->allocated_memory_size, system->top_order);
+    if (system->commit_bits != NULL) {
+        MEM_LOG(out, "Committed: %zu bytes | mprotect: %zu | madvise: %zu\n\n",
+                system->committed_bytes, system->commit_calls, system->release_calls);
+    }
+    for (int order = 0; order <= system->top_order; order++) {
+        if (system->free_counts[order] > 0) {
+            MEM_LOG(out, "Bậc %d (%zu bytes): %zu khối trống\n", order, order_size(order), system->free_counts[order]);
+        }
+    }
+    MEM_LOG(out, "====================================================================\n");
+}
+
+void cleanup_flat_buddy_system(FlatBuddySystem* system, FILE* out) {
+    if (system == NULL) {
+        MEM_LOG(out, "[cleanup_flat_buddy_system] Buddy system trỏ tới NULL.\n");
+        return;
+    }
+    if (system->commit_bits != NULL) munmap(system->base_memory_address, system->total_memory_size);
+    free(system->commit_bits);
+    free(system->split_bits);
+    free(system->free_bits);
+    free(system);
+    MEM_LOG(out, "[cleanup_flat_buddy_system] Đã giải phóng cấu trúc quản lý buddy system.\n");
+}
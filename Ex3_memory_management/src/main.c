@@ -27,16 +27,16 @@ int main() {
     // fprintf(logfile, "\n=== Bắt đầu tạo phân mảnh ban đầu bằng allocate_at_address ===\n");
     // void *base_addr = global_mem_manager->base_memory_address;
 
-    // void *fixed_ptr_A = allocate_at_address(global_mem_manager, base_addr, 50, logfile);
-    // void *fixed_ptr_B = allocate_at_address(global_mem_manager, (char*)base_addr + 100, 100, logfile);
-    // void *fixed_ptr_C = allocate_at_address(global_mem_manager, (char*)base_addr + 300, 100, logfile);
-    // void *fixed_ptr_D = allocate_at_address(global_mem_manager, (char*)base_addr + 500, 100, logfile);
-    // void *fixed_ptr_E = allocate_at_address(global_mem_manager, (char*)base_addr + 700, 100, logfile);
+    // void *fixed_ptr_A = allocate_at_address(global_mem_manager, (char*)base_addr + MEM_BLOCK_HEADER_SIZE, 50, logfile);
+    // void *fixed_ptr_B = allocate_at_address(global_mem_manager, (char*)base_addr + 200, 100, logfile);
+    // void *fixed_ptr_C = allocate_at_address(global_mem_manager, (char*)base_addr + 400, 100, logfile);
+    // void *fixed_ptr_D = allocate_at_address(global_mem_manager, (char*)base_addr + 600, 100, logfile);
+    // void *fixed_ptr_E = allocate_at_address(global_mem_manager, (char*)base_addr + 800, 100, logfile);
     // print_free_list(global_mem_manager, logfile);
 
     // fprintf(logfile, "\n=== Giải phóng một số khối để tạo thêm phân mảnh và gộp ===\n");
-    // free_mem(global_mem_manager, fixed_ptr_A, 50, logfile);
-    // free_mem(global_mem_manager, fixed_ptr_C, 100, logfile);
+    // free_mem(global_mem_manager, fixed_ptr_A, logfile);
+    // free_mem(global_mem_manager, fixed_ptr_C, logfile);
     // print_free_list(global_mem_manager, logfile);
 
     // fprintf(logfile, "\n=== Test First Fit ===\n");
@@ -47,8 +47,8 @@ int main() {
     // print_free_list(global_mem_manager, logfile);
 
     // fprintf(logfile, "\n--- Giải phóng các khối FF để reset trạng thái cho test tiếp theo ---\n");
-    // free_mem(global_mem_manager, ff_alloc1, 80, logfile);
-    // free_mem(global_mem_manager, ff_alloc2, 150, logfile);
+    // free_mem(global_mem_manager, ff_alloc1, logfile);
+    // free_mem(global_mem_manager, ff_alloc2, logfile);
     // print_free_list(global_mem_manager, logfile);
 
     // fprintf(logfile, "\n=== Test Best Fit ===\n");
@@ -59,8 +59,8 @@ int main() {
     // print_free_list(global_mem_manager, logfile);
 
     // fprintf(logfile, "\n--- Giải phóng các khối BF để reset trạng thái cho test tiếp theo ---\n");
-    // free_mem(global_mem_manager, bf_alloc1, 90, logfile);
-    // free_mem(global_mem_manager, bf_alloc2, 180, logfile);
+    // free_mem(global_mem_manager, bf_alloc1, logfile);
+    // free_mem(global_mem_manager, bf_alloc2, logfile);
     // print_free_list(global_mem_manager, logfile);
 
     // fprintf(logfile, "\n=== Test Worst Fit ===\n");
@@ -71,10 +71,9 @@ int main() {
     // print_free_list(global_mem_manager, logfile);
 
     // fprintf(logfile, "\n--- Giải phóng các khối WF để reset trạng thái cho test tiếp theo ---\n");
-    // free_mem(global_mem_manager, wf_alloc1, 50, logfile);
-    // free_mem(global_mem_manager, wf_alloc2, 80, logfile);
+    // free_mem(global_mem_manager, wf_alloc1, logfile);
+    // free_mem(global_mem_manager, wf_alloc2, logfile);
     // print_free_list(global_mem_manager, logfile);
-    // global_mem_manager->next_fit_last_block = NULL;
 
     // fprintf(logfile, "\n=== Test Next Fit ===\n");
     // void *nf_alloc1 = nextfit_malloc(global_mem_manager, 70, logfile);
@@ -90,14 +89,14 @@ int main() {
     // print_free_list(global_mem_manager, logfile);
 
     // fprintf(logfile, "\n--- Giải phóng tất cả các khối còn lại ---\n");
-    // free_mem(global_mem_manager, fixed_ptr_B, 100, logfile);
-    // free_mem(global_mem_manager, fixed_ptr_D, 100, logfile);
-    // free_mem(global_mem_manager, fixed_ptr_E, 100, logfile);
-
-    // free_mem(global_mem_manager, nf_alloc1, 70, logfile);
-    // free_mem(global_mem_manager, nf_alloc2, 40, logfile);
-    // free_mem(global_mem_manager, nf_alloc3, 150, logfile);
-    // free_mem(global_mem_manager, nf_alloc4, 100, logfile);
+    // free_mem(global_mem_manager, fixed_ptr_B, logfile);
+    // free_mem(global_mem_manager, fixed_ptr_D, logfile);
+    // free_mem(global_mem_manager, fixed_ptr_E, logfile);
+
+    // free_mem(global_mem_manager, nf_alloc1, logfile);
+    // free_mem(global_mem_manager, nf_alloc2, logfile);
+    // free_mem(global_mem_manager, nf_alloc3, logfile);
+    // free_mem(global_mem_manager, nf_alloc4, logfile);
 
     // print_free_list(global_mem_manager, logfile);
 
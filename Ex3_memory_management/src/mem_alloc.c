@@ -2,14 +2,133 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include <limits.h>
+#include <stdint.h>
+#include <string.h>
 #include "mem_alloc.h"
+#include "mem_tree.h"
+#include "mem_stats.h"
+#include "mem_log.h"
+
+// Đọc/ghi boundary tag bằng memcpy (footer của khối có thể nằm ở địa chỉ không thẳng hàng trong vùng nhớ của người dùng)
+static size_t read_tag(const void *addr) {
+    size_t value;
+    memcpy(&value, addr, sizeof(value));
+    return value;
+}
+
+static void write_tag(void *addr, size_t value) {
+    memcpy(addr, &value, sizeof(value));
+}
+
+static size_t block_size_at(const void *block) { return read_tag(block); }
+static size_t block_requested_at(const void *block) { return read_tag((const char*)block + sizeof(size_t)); }
+
+// Descriptor của khối trống nằm ngay sau header, trong vùng dữ liệu của chính khối đó
+static MemoryBlock *block_descriptor_at(const void *block) {
+    return (MemoryBlock*)((char*)block + MEM_BLOCK_HEADER_SIZE);
+}
+
+// Ghi header/footer của khối; requested = 0 nghĩa là khối trống
+static void write_block_tags(void *block, size_t size, size_t requested) {
+    write_tag(block, size);
+    write_tag((char*)block + sizeof(size_t), requested);
+    write_tag((char*)block + size - MEM_BLOCK_FOOTER_SIZE, size);
+}
+
+// Kích thước khối cho size bytes dữ liệu, làm tròn lên bội số MEM_BLOCK_ALIGN;
+// khối nào cũng phải đủ chỗ cho descriptor khi được giải phóng
+static size_t block_size_for(size_t size) {
+    size_t block_size = (MEM_BLOCK_HEADER_SIZE + size + MEM_BLOCK_FOOTER_SIZE + MEM_BLOCK_ALIGN - 1) & ~(size_t)(MEM_BLOCK_ALIGN - 1);
+    return block_size < MEM_BLOCK_MIN_SIZE ? MEM_BLOCK_MIN_SIZE : block_size;
+}
+
+// Cập nhật các bộ đếm vùng trống dùng cho thống kê khi một vùng trống size bytes được thêm (delta = 1) hoặc gỡ (delta = -1)
+static void count_free_block(MemoryManagement *manager, size_t size, int delta) {
+    if (delta > 0) {
+        manager->free_memory_size += size;
+        manager->free_block_count++;
+        manager->free_size_classes[mem_size_class(size)]++;
+    } else {
+        manager->free_memory_size -= size;
+        manager->free_block_count--;
+        manager->free_size_classes[mem_size_class(size)]--;
+    }
+}
+
+// Biến [start_addr, start_addr + size) thành vùng trống: ghi boundary tag, dựng descriptor trong khối,
+// chèn vào đầu danh sách vùng trống và vào hai cây chỉ mục
+static MemoryBlock *push_free_block(MemoryManagement *manager, void *start_addr, size_t size) {
+    write_block_tags(start_addr, size, 0);
+    MemoryBlock *block = block_descriptor_at(start_addr);
+    block->start_addr = start_addr;
+    block->size = size;
+    count_free_block(manager, size, 1);
+    manager->size_tree = mem_tree_insert(manager->size_tree, block, MEM_TREE_BY_SIZE);
+    manager->address_tree = mem_tree_insert(manager->address_tree, block, MEM_TREE_BY_ADDRESS);
+    block->prev = NULL;
+    block->next = manager->free_list;
+    if (manager->free_list != NULL) manager->free_list->prev = block;
+    manager->free_list = block;
+    return block;
+}
+
+// Gỡ descriptor khỏi danh sách và hai cây
+static void remove_free_block(MemoryManagement *manager, MemoryBlock *block) {
+    count_free_block(manager, block->size, -1);
+    manager->size_tree = mem_tree_remove(manager->size_tree, block, MEM_TREE_BY_SIZE);
+    manager->address_tree = mem_tree_remove(manager->address_tree, block, MEM_TREE_BY_ADDRESS);
+    if (block->prev != NULL) {
+        block->prev->next = block->next;
+    } else {
+        manager->free_list = block->next;
+    }
+    if (block->next != NULL) block->next->prev = block->prev;
+}
+
+// Đổi vị trí/kích thước của vùng trống và ghi lại boundary tag, trả về descriptor (có thể đã bị dời chỗ).
+// Vùng mới luôn nằm trong vùng cũ hoặc phủ lên khối liền kề vừa gộp, nên thứ tự địa chỉ giữa các vùng trống không đổi:
+// chỉ cây kích thước phải gỡ ra và chèn lại, cây địa chỉ chỉ cần tính lại subtree_max_size. Khi đầu khối đổi, descriptor được chuyển theo (memmove vì hai vị trí
+// có thể chồng lên nhau) rồi đặt vào đúng chỗ cũ trong danh sách và cây địa chỉ.
+static MemoryBlock *resize_free_block(MemoryManagement *manager, MemoryBlock *block, void *start_addr, size_t size) {
+    count_free_block(manager, block->size, -1);
+    count_free_block(manager, size, 1);
+    manager->size_tree = mem_tree_remove(manager->size_tree, block, MEM_TREE_BY_SIZE);
+    if (start_addr != block->start_addr) {
+        MemoryBlock *moved = block_descriptor_at(start_addr);
+        memmove(moved, block, sizeof(MemoryBlock));
+        moved->start_addr = start_addr;
+        manager->address_tree = mem_tree_replace(manager->address_tree, block, moved, MEM_TREE_BY_ADDRESS);
+        if (moved->prev != NULL) {
+            moved->prev->next = moved;
+        } else {
+            manager->free_list = moved;
+        }
+        if (moved->next != NULL) moved->next->prev = moved;
+        block = moved;
+    }
+    block->size = size;
+    mem_tree_size_changed(manager->address_tree, block);
+    manager->size_tree = mem_tree_insert(manager->size_tree, block, MEM_TREE_BY_SIZE);
+    write_block_tags(start_addr, size, 0);
+    return block;
+}
 
 // Hàm khởi tạo một vùng nhớ trống ban đầu
 MemoryManagement* initialize_memory_manager(void *base_addr, size_t total_size, FILE *out) {
+    if (base_addr == NULL || total_size < MEM_BLOCK_MIN_SIZE) {
+        MEM_LOG(out, "[initialize_memory_manager] Lỗi: Vùng nhớ ban đầu phải có ít nhất %zu bytes.\n", (size_t)MEM_BLOCK_MIN_SIZE);
+        return NULL;
+    }
+    if ((uintptr_t)base_addr % MEM_BLOCK_ALIGN != 0) {
+        MEM_LOG(out, "[initialize_memory_manager] Lỗi: Địa chỉ cơ sở %p phải căn theo %d bytes.\n", base_addr, MEM_BLOCK_ALIGN);
+        return NULL;
+    }
+    total_size &= ~(size_t)(MEM_BLOCK_ALIGN - 1); // Mọi khối có kích thước là bội số MEM_BLOCK_ALIGN
+
     // Cấp phát một instance của MemoryManagement
     MemoryManagement *global_mem_manager = (MemoryManagement*)malloc(sizeof(MemoryManagement));
     if (global_mem_manager == NULL) {
-        fprintf(out, "[main] Lỗi: Không thể cấp phát cấu trúc MemoryManagement.\n");
+        MEM_LOG(out, "[main] Lỗi: Không thể cấp phát cấu trúc MemoryManagement.\n");
         return NULL;
     }
 
@@ -18,23 +137,20 @@ MemoryManagement* initialize_memory_manager(void *base_addr, size_t total_size,
     global_mem_manager->base_memory_address = base_addr;
     global_mem_manager->total_memory_size = total_size;
     global_mem_manager->allocated_memory_size = 0;
-    global_mem_manager->next_fit_last_block = NULL;
+    global_mem_manager->size_tree = NULL;
+    global_mem_manager->address_tree = NULL;
+    global_mem_manager->next_fit_offset = 0;
+    global_mem_manager->free_memory_size = 0;
+    global_mem_manager->free_block_count = 0;
+    memset(global_mem_manager->free_size_classes, 0, sizeof(global_mem_manager->free_size_classes));
+    global_mem_manager->search_count = 0;
+    global_mem_manager->search_steps = 0;
     global_mem_manager->last_memory_address = (char*) base_addr + total_size;
 
-    // Khởi toạ vùng trống ban đầu 
-    MemoryBlock* initial_block = (MemoryBlock*)malloc(sizeof(MemoryBlock));
-    if (initial_block == NULL) {
-        fprintf(out, "[initialize_memory_manager] Lỗi: cấp phát bộ nhớ động cho initial_block.\n");
-        return NULL;
-    }
-    initial_block->start_addr = base_addr;
-    initial_block->size = total_size;
-    initial_block->next = NULL;
-    
-     // Gán cho free_list trỏ vào vùng trống ban đầu
-    global_mem_manager->free_list = initial_block;
+    // Vùng trống ban đầu phủ toàn bộ vùng nhớ, descriptor của nó nằm ngay trong vùng nhớ đó
+    push_free_block(global_mem_manager, base_addr, total_size);
 
-    fprintf(out, "[initialize_memory_manager] Vùng trống ban đầu (initial memory pool) có địa chỉ cơ sở: %p, kích thước: %zu.\n", base_addr, total_size);
+    MEM_LOG(out, "[initialize_memory_manager] Vùng trống ban đầu (initial memory pool) có địa chỉ cơ sở: %p, kích thước: %zu.\n", base_addr, total_size);
 
     return global_mem_manager;
 }
@@ -42,17 +158,14 @@ MemoryManagement* initialize_memory_manager(void *base_addr, size_t total_size,
 // Giải phóng cấu trúc MemoryManagement
 void cleanup_memory_manager(MemoryManagement *manager, FILE *out) {
     if (manager == NULL) {
-        fprintf(out, "[cleanup_memory_manager] Lỗi: Con trỏ manager là NULL.\n");
+        MEM_LOG(out, "[cleanup_memory_manager] Lỗi: Con trỏ manager là NULL.\n");
         return;
     }
 
-    MemoryBlock *current = manager->free_list;
-    while (current != NULL) {
-        MemoryBlock *temp = current;
-        current = current->next;
-        free(temp); // Giải phóng các node MemoryBlock
-    }
+    // Các descriptor nằm trong vùng nhớ được quản lý nên không có gì phải giải phóng riêng
     manager->free_list = NULL;
+    manager->size_tree = NULL;
+    manager->address_tree = NULL;
 
     // Giải phóng vùng bộ nhớ lớn ban đầu nếu nó được cấp phát bởi malloc
     if (manager->base_memory_address != NULL) {
@@ -61,7 +174,7 @@ void cleanup_memory_manager(MemoryManagement *manager, FILE *out) {
         manager->last_memory_address = NULL;
         manager->total_memory_size = 0;
         manager->allocated_memory_size = 0;
-        fprintf(out, "[clean_memory_manager] Đã giải phóng vùng bộ nhớ ban đầu được quản lý.\n");
+        MEM_LOG(out, "[clean_memory_manager] Đã giải phóng vùng bộ nhớ ban đầu được quản lý.\n");
     }
     // Giải phóng chính cấu trúc MemoryManagement nếu nó được cấp phát động
     free(manager);
@@ -69,142 +182,135 @@ void cleanup_memory_manager(MemoryManagement *manager, FILE *out) {
 
 void print_free_list(MemoryManagement *manager, FILE *out) {
     if (manager == NULL) {
-        fprintf(out, "[print_free_list] Lỗi: Con trỏ manager là NULL.\n");
+        MEM_LOG(out, "[print_free_list] Lỗi: Con trỏ manager là NULL.\n");
         return;
     }
-    fprintf(out, "\n================= Danh sách vùng trống dự do =================");
-    fprintf(out, "\nKích thường vùng bộ nhớ quản lý: %zu bytes, Đã cấp phát: %zu bytes\n", manager->total_memory_size, manager->allocated_memory_size);
+    MEM_LOG(out, "\n================= Danh sách vùng trống dự do =================");
+    MEM_LOG(out, "\nKích thường vùng bộ nhớ quản lý: %zu bytes, Đã cấp phát: %zu bytes\n", manager->total_memory_size, manager->allocated_memory_size);
     
     if (manager->free_list == NULL) {
-        fprintf(out, "[print_free_list] Free list is empty.\n");
+        MEM_LOG(out, "[print_free_list] Free list is empty.\n");
         return;
     }
-    MemoryBlock *current = manager->free_list;
+    // Duyệt các khối theo thứ tự địa chỉ nhờ boundary tag (danh sách vùng trống không còn sắp theo địa chỉ)
+    char *current = (char*)manager->base_memory_address;
     int i = 0;
-    while (current != NULL) {
-        fprintf(out, "Block %d: Start Addr: %p, Size: %zu bytes\n", i++, current->start_addr, current->size);
-        current = current->next;
+    while (current < (char*)manager->last_memory_address) {
+        if (block_requested_at(current) == 0) {
+            MEM_LOG(out, "Block %d: Start Addr: %p, Size: %zu bytes\n", i++, (void*)current, block_size_at(current));
+        }
+        current += block_size_at(current);
     }
-    fprintf(out, "==============================================================\n\n");
+    MEM_LOG(out, "==============================================================\n\n");
 }
 
-// Hàm hợp nhất các khối trống liền kề
-void merge_free_blocks(MemoryManagement *manager, FILE *out) {
-    if (manager == NULL || manager->free_list == NULL) {
-        // Không có gì để gộp hoặc manager là NULL
+// Thêm vùng trống tự do, gộp ngay với khối liền trước/liền sau nếu chúng trống (đọc boundary tag, O(1)).
+void add_free_mem_block(MemoryManagement *manager, void *start_addr, size_t size, FILE *out) {
+    if (manager == NULL) {
+        MEM_LOG(out, "[add_free_mem_block] Lỗi: Con trỏ manager là NULL.\n");
+        return;
+    }
+    if (size < MEM_BLOCK_MIN_SIZE || start_addr < manager->base_memory_address ||
+        (char*)start_addr + size > (char*)manager->last_memory_address ||
+        (uintptr_t)start_addr % MEM_BLOCK_ALIGN != 0 || size % MEM_BLOCK_ALIGN != 0) {
+        MEM_LOG(out, "[add_free_mem_block] Lỗi: Khối (%p, %zu bytes) không hợp lệ.\n", start_addr, size);
         return;
     }
 
-    MemoryBlock *current = manager->free_list;
-    int merged_happened; // Biến cờ để kiểm tra xem có sự gộp nào xảy ra trong một lần duyệt không
-
-    do {
-        merged_happened = 0; // Đặt lại cờ cho mỗi lần duyệt
-        current = manager->free_list; // Bắt đầu lại từ đầu danh sách
-        MemoryBlock *prev = NULL;
-
-        while (current != NULL && current->next != NULL) {
-            // Kiểm tra xem vùng trống hiện tại và vùng trống kế tiếp có liền kề nhau không
-            if ((char*)current->start_addr + current->size == (char*)current->next->start_addr) {
-                // Hợp nhất hai khối
-                current->size += current->next->size; // Tăng kích thước của khối hiện tại
-                MemoryBlock *temp = current->next; // Giữ con trỏ đến khối kế tiếp để giải phóng
-                current->next = temp->next; // Bỏ khối kế tiếp ra khỏi danh sách
-                free(temp); // Giải phóng node MemoryBlock của khối đã gộp
-                merged_happened = 1; // Đánh dấu rằng đã có sự gộp
-                fprintf(out, "[merge_free_blocks] Đã gộp khối tại %p (kích thước %zu) với khối tại %p.\n", current->start_addr, current->size, temp->start_addr);
-            } else {
-                // Nếu không liền kề, di chuyển tới khối tiếp theo
-                prev = current;
-                current = current->next;
-            }
+    char *block_start = (char*)start_addr;
+    size_t block_size = size;
+    MemoryBlock *descriptor = NULL;
+
+    // Footer của khối liền trước nằm ngay trước start_addr
+    if (block_start > (char*)manager->base_memory_address) {
+        char *prev = block_start - read_tag(block_start - MEM_BLOCK_FOOTER_SIZE);
+        if (block_requested_at(prev) == 0) {
+            descriptor = block_descriptor_at(prev);
+            block_start = prev;
+            block_size += descriptor->size;
+            MEM_LOG(out, "[add_free_mem_block] Gộp với khối trống liền trước tại %p.\n", (void*)prev);
         }
-    } while (merged_happened); // Lặp lại cho đến khi không có sự gộp nào xảy ra trong một lần duyệt
-}
+    }
 
-// Thêm vùng trống tự do vào danh sách vùng trống, hợp nhất các vùng trống nếu có thể. 
-void add_free_mem_block(MemoryManagement *manager, void *start_addr, size_t size, FILE *out) {
-    if (manager == NULL) {
-        fprintf(out, "[add_free_mem_block] Lỗi: Con trỏ manager là NULL.\n");
-        return;
+    char *next = (char*)start_addr + size;
+    if (next < (char*)manager->last_memory_address && block_requested_at(next) == 0) {
+        MemoryBlock *next_descriptor = block_descriptor_at(next);
+        block_size += next_descriptor->size;
+        if (descriptor == NULL) {
+            descriptor = next_descriptor; // Dùng lại descriptor của khối liền sau
+        } else {
+            remove_free_block(manager, next_descriptor);
+        }
+        MEM_LOG(out, "[add_free_mem_block] Gộp với khối trống liền sau tại %p.\n", (void*)next);
     }
 
-    MemoryBlock *new_block = (MemoryBlock *)malloc(sizeof(MemoryBlock));
-    if (new_block == NULL) {
-        fprintf(out, "[add_free_mem_block] Lỗi cấp phát bộ nhớ động cho new_block.\n");
-        return;
+    if (descriptor == NULL) {
+        push_free_block(manager, block_start, block_size);
+    } else {
+        resize_free_block(manager, descriptor, block_start, block_size);
+    }
+
+    MEM_LOG(out, "[add_free_mem_block] Vùng trống tại địa chỉ %p, kích thước %zu.\n", (void*)block_start, block_size);
+}
+
+// Cắt khối [block_start, block_start + block_size) ra khỏi vùng trống free_block và đánh dấu đã cấp phát.
+// Phần thừa phía sau nhỏ hơn MEM_BLOCK_MIN_SIZE được gộp vào khối cấp phát; trả về NULL nếu phần thừa phía trước quá nhỏ.
+static void *allocate_from_block(MemoryManagement *manager, MemoryBlock *free_block, char *block_start,
+                                 size_t size, FILE *out) {
+    size_t block_size = block_size_for(size);
+    char *free_start = (char*)free_block->start_addr;
+    char *free_end = free_start + free_block->size;
+    size_t lead = block_start - free_start;
+    size_t trail = free_end - (block_start + block_size);
+
+    if (lead != 0 && lead < MEM_BLOCK_MIN_SIZE) {
+        MEM_LOG(out, "[allocate_from_block] Phần trống còn lại phía trước (%zu bytes) quá nhỏ để giữ boundary tag.\n", lead);
+        return NULL;
+    }
+    if (trail < MEM_BLOCK_MIN_SIZE) {
+        block_size += trail;
+        trail = 0;
     }
-    new_block->start_addr = start_addr;
-    new_block->size = size;
-    new_block->next = NULL;
 
-    // Nếu danh sách trống hoặc khối mới nên ở đầu
-    if (manager->free_list == NULL || new_block->start_addr < manager->free_list->start_addr) {
-        new_block->next = manager->free_list;
-        manager->free_list = new_block;
+    // Các trường hợp cắt khối giống allocate_at_address trước đây: khớp, cắt đầu, cắt cuối, cắt giữa
+    if (lead == 0 && trail == 0) {
+        remove_free_block(manager, free_block);
+    } else if (lead == 0) {
+        resize_free_block(manager, free_block, block_start + block_size, trail);
+    } else if (trail == 0) {
+        resize_free_block(manager, free_block, free_start, lead);
     } else {
-        // Duyệt qua danh sách để tìm vị trí thích hợp
-        MemoryBlock* current = manager->free_list;
-        while (current->next != NULL && current->next->start_addr < new_block->start_addr) {
-            current = current->next;
-        }
-        // Chèn new_block vào vị trí
-        new_block->next = current->next;
-        current->next = new_block;
+        resize_free_block(manager, free_block, free_start, lead);
+        push_free_block(manager, block_start + block_size, trail);
     }
-    
-    fprintf(out, "[add_free_mem_block] Đã thêm block mới tại địa chỉ %p, kích thước %zu. Bắt đầu gộp...\n", start_addr, size);
-    merge_free_blocks(manager, out); // Gọi hàm gộp sau khi thêm block mới
+
+    write_block_tags(block_start, block_size, size);
+    manager->allocated_memory_size += size;
+    return block_start + MEM_BLOCK_HEADER_SIZE;
 }
 
 // Chiến lược cấp phát bộ nhớ First Fit
 void *firstfit_malloc(MemoryManagement *manager, size_t size, FILE *out) {
     if (manager == NULL) {
-        fprintf(out, "[firstfit_malloc] Lỗi: Con trỏ manager là NULL.\n");
+        MEM_LOG(out, "[firstfit_malloc] Lỗi: Con trỏ manager là NULL.\n");
         return NULL;
     }
-    if (size == 0) {
-        fprintf(out, "[firstfit_malloc] Kích thước khối nhớ xin cấp phát không hợp lệ.\n");
+    if (size == 0 || size > manager->total_memory_size) {
+        MEM_LOG(out, "[firstfit_malloc] Kích thước khối nhớ xin cấp phát không hợp lệ.\n");
         return NULL;
     }
 
-    MemoryBlock *current = manager->free_list;
-    MemoryBlock *prev = NULL;
-    void *allocated_addr = NULL;
-
-    while (current != NULL) {
-        if (current->size >= size) { // Tìm thấy vùng trống fit
-            allocated_addr = current->start_addr; // Lấy địa chỉ để cấp phát
-
-            // Trường hợp 1: Vùng trống vừa vặn (exact fit)
-            if (current->size == size) {
-                if (prev == NULL) { // Là node đầu tiên
-                    manager->free_list = current->next;
-                } else {
-                    prev->next = current->next;
-                }
-                free(current); // Giải phóng MemoryBlock node
-                manager->allocated_memory_size += size; // Cập nhật bộ nhớ đã cấp phát
-                fprintf(out, "[firstfit_malloc] Cấp phát %zu bytes tại địa chỉ %p (exact fit).\n", size, allocated_addr);
-                return allocated_addr; // Trả về địa chỉ và kết thúc
-            }
-            // Trường hợp 2: Vùng trống lớn hơn (split)
-            else { // current->size > size
-                // Cập nhật lại thông tin của block hiện tại
-                current->start_addr = (char*)current->start_addr + size;
-                current->size -= size;
-                manager->allocated_memory_size += size; // Cập nhật bộ nhớ đã cấp phát
-                fprintf(out, "[firstfit_malloc] Cấp phát %zu bytes tại địa chỉ %p (split, còn lại %zu bytes tại %p).\n", size, allocated_addr, current->size, current->start_addr);
-                return allocated_addr; // Trả về địa chỉ và kết thúc
-            }
-        }
-        // Nếu không fit, chuyển sang khối tiếp theo
-        prev = current;
-        current = current->next;
+    // Vùng trống đủ lớn có địa chỉ thấp nhất; danh sách free_list xếp theo thứ tự giải phóng nên không dùng ở đây
+    manager->search_count++;
+    MemoryBlock *current = mem_tree_first_fit(manager->address_tree, manager->base_memory_address,
+                                              block_size_for(size), &manager->search_steps);
+    if (current != NULL) {
+        void *allocated_addr = allocate_from_block(manager, current, (char*)current->start_addr, size, out);
+        MEM_LOG(out, "[firstfit_malloc] Cấp phát %zu bytes tại địa chỉ %p.\n", size, allocated_addr);
+        return allocated_addr;
     }
 
-    // Duyệt hết danh sách mà không tìm thấy
-    fprintf(out, "Không tồn tại vùng trống tự do đáp ứng yêu cầu (%zu bytes).\n", size);
+    MEM_LOG(out, "Không tồn tại vùng trống tự do đáp ứng yêu cầu (%zu bytes).\n", size);
     return NULL;
 }
 
@@ -212,226 +318,286 @@ void *firstfit_malloc(MemoryManagement *manager, size_t size, FILE *out) {
 // Cấp phát tại địa chỉ cụ thể
 void *allocate_at_address(MemoryManagement *manager, void *start_addr_request, size_t size, FILE *out) {
     if (manager == NULL) {
-        fprintf(out, "[allocate_at_address] Lỗi: Con trỏ manager là NULL.\n");
+        MEM_LOG(out, "[allocate_at_address] Lỗi: Con trỏ manager là NULL.\n");
         return NULL;
     }
-    if (size == 0) {
-        fprintf(out, "[allocate_at_address] Kích thước khối nhớ xin cấp phát không hợp lệ.\n");
+    if (size == 0 || size > manager->total_memory_size) {
+        MEM_LOG(out, "[allocate_at_address] Kích thước khối nhớ xin cấp phát không hợp lệ.\n");
         return NULL;
     }
     if (start_addr_request == NULL) {
-        fprintf(out, "[allocate_at_address] Địa chỉ yêu cầu cấp phát là NULL.\n");
+        MEM_LOG(out, "[allocate_at_address] Địa chỉ yêu cầu cấp phát là NULL.\n");
         return NULL;
     }
 
-    // Kiểm tra xem địa chỉ và kích thước yêu cầu có nằm hoàn toàn trong vùng bộ nhớ quản lý không
-    if (start_addr_request < manager->base_memory_address || (char*)start_addr_request + size > (char*)manager->last_memory_address) {
-        fprintf(out, "[allocate_at_address] Yêu cầu cấp phát (%p, %zu bytes) nằm ngoài vùng bộ nhớ được quản lý (%p, %zu bytes).\n",
-               start_addr_request, size, manager->base_memory_address, manager->total_memory_size);
+    // Đầu khối phải thẳng hàng để vùng trống tách ra phía trước/phía sau còn chứa được descriptor
+    if ((uintptr_t)start_addr_request % MEM_BLOCK_ALIGN != 0) {
+        MEM_LOG(out, "[allocate_at_address] Địa chỉ %p không căn theo %d bytes.\n", start_addr_request, MEM_BLOCK_ALIGN);
         return NULL;
     }
 
-    fprintf(out, "[allocate_at_address] Thực hiện cấp phát bộ nhớ tại địa chỉ %p, kích thước %zu.\n", start_addr_request, size);
+    // Kiểm tra xem cả khối (header + dữ liệu + footer) có nằm hoàn toàn trong vùng bộ nhớ quản lý không
+    char *block_start = (char*)start_addr_request - MEM_BLOCK_HEADER_SIZE;
+    size_t block_size = block_size_for(size);
+    if ((char*)start_addr_request < (char*)manager->base_memory_address + MEM_BLOCK_HEADER_SIZE ||
+        block_size > (size_t)((char*)manager->last_memory_address - block_start)) {
+        MEM_LOG(out, "[allocate_at_address] Yêu cầu cấp phát (%p, %zu bytes) nằm ngoài vùng bộ nhớ được quản lý (%p, %zu bytes).\n",
+               start_addr_request, size, manager->base_memory_address, manager->total_memory_size);
+        return NULL;
+    }
 
-    MemoryBlock *current = manager->free_list;
-    MemoryBlock *prev = NULL;
+    MEM_LOG(out, "[allocate_at_address] Thực hiện cấp phát bộ nhớ tại địa chỉ %p, kích thước %zu.\n", start_addr_request, size);
 
-    while (current != NULL) {
-        // Kiểm tra xem khối trống hiện tại có chứa hoàn toàn vùng nhớ yêu cầu không
-        if (start_addr_request >= current->start_addr &&
-            (char*)start_addr_request + size <= (char*)current->start_addr + current->size) {
-
-            // Đã tìm thấy một khối trống đủ lớn và chứa vùng yêu cầu
-            void *allocated_addr = start_addr_request;
-
-            // Xử lý các trường hợp cắt khối:
-
-            // 1. Vùng yêu cầu khớp chính xác với khối trống
-            if (current->start_addr == start_addr_request && current->size == size) {
-                if (prev == NULL) {
-                    manager->free_list = current->next;
-                } else {
-                    prev->next = current->next;
-                }
-                free(current); // Giải phóng node MemoryBlock
-            }
-            // 2. Vùng yêu cầu nằm ở đầu khối trống (cần cắt phần cuối)
-            else if (current->start_addr == start_addr_request) {
-                current->start_addr = (char*)current->start_addr + size;
-                current->size -= size;
-            }
-            // 3. Vùng yêu cầu nằm ở cuối khối trống (cần cắt phần đầu)
-            else if ((char*)current->start_addr + current->size == (char*)start_addr_request + size) {
-                current->size -= size;
-            }
-            // 4. Vùng yêu cầu nằm ở giữa khối trống (cần cắt cả hai đầu) - trường hợp phức tạp hơn
-            else {
-                // Tạo một khối mới cho phần cuối của khối trống
-                MemoryBlock *new_block_after = (MemoryBlock*)malloc(sizeof(MemoryBlock));
-                if (new_block_after == NULL) {
-                    fprintf(out, "[allocate_at_address] Lỗi: Cấp phát bộ nhớ cho phần còn lại sau khi cắt.\n");
-                    return NULL; // Cấp phát thất bại
-                }
-                new_block_after->start_addr = (char*)start_addr_request + size;
-                new_block_after->size = (char*)current->start_addr + current->size - ((char*)start_addr_request + size);
-                new_block_after->next = current->next; // Chèn vào sau current
-
-                // Cập nhật kích thước của khối trống hiện tại (phần đầu)
-                current->size = (char*)start_addr_request - (char*)current->start_addr;
-                current->next = new_block_after; // Liên kết khối hiện tại với khối mới
-            }
-
-            manager->allocated_memory_size += size;
-            fprintf(out, "[allocate_at_address] Đã thực hiện cấp phát %zu bytes tại địa chỉ %p.\n\n", size, allocated_addr);
-            return allocated_addr;
+    // Vùng trống duy nhất có thể chứa khối yêu cầu là vùng có địa chỉ đầu lớn nhất mà <= block_start
+    MemoryBlock *current = mem_tree_floor_address(manager->address_tree, block_start, NULL);
+    if (current != NULL && block_start + block_size <= (char*)current->start_addr + current->size) {
+        void *allocated_addr = allocate_from_block(manager, current, block_start, size, out);
+        if (allocated_addr != NULL) {
+            MEM_LOG(out, "[allocate_at_address] Đã thực hiện cấp phát %zu bytes tại địa chỉ %p.\n\n", size, allocated_addr);
         }
-
-        prev = current;
-        current = current->next;
+        return allocated_addr;
     }
 
-    fprintf(out, "[allocate_at_address] Không tìm thấy vùng trống tự do chứa yêu cầu cấp phát tại địa chỉ %p với kích thước %zu bytes.\n", start_addr_request, size);
+    MEM_LOG(out, "[allocate_at_address] Không tìm thấy vùng trống tự do chứa yêu cầu cấp phát tại địa chỉ %p với kích thước %zu bytes.\n", start_addr_request, size);
     return NULL;
 }
 
 // Chiến lược cấp phát bộ nhớ Best Fit
 void *bestfit_malloc(MemoryManagement *manager, size_t size, FILE *out) {
     if (manager == NULL) {
-        fprintf(out, "[bestfit_malloc] Lỗi: Con trỏ manager là NULL.\n");
+        MEM_LOG(out, "[bestfit_malloc] Lỗi: Con trỏ manager là NULL.\n");
         return NULL;
     }
-    if (size == 0) {
-        fprintf(out, "[bestfit_malloc] Kích thước khối nhớ xin cấp phát không hợp lệ.\n");
+    if (size == 0 || size > manager->total_memory_size) {
+        MEM_LOG(out, "[bestfit_malloc] Kích thước khối nhớ xin cấp phát không hợp lệ.\n");
         return NULL;
     }
 
-    MemoryBlock *current = manager->free_list;
-    MemoryBlock *best_fit_block = NULL;
-    size_t min_diff = SIZE_MAX; 
-
-    while (current != NULL) {
-        if (current->size >= size) {
-            size_t diff = current->size - size;
-            if (diff < min_diff) {
-                min_diff = diff;
-                best_fit_block = current;
-            }
-        }
-        current = current->next;
-    }
+    // Khối nhỏ nhất có kích thước >= needed (cùng kích thước thì lấy địa chỉ thấp nhất)
+    manager->search_count++;
+    MemoryBlock *best_fit_block = mem_tree_ceiling_size(manager->size_tree, block_size_for(size), &manager->search_steps);
 
     if (best_fit_block != NULL) {
-        fprintf(out, "[bestfit_malloc] Tìm thấy khối phù hợp nhất tại %p (kích thước %zu).\n", best_fit_block->start_addr, best_fit_block->size);
-        return allocate_at_address(manager, best_fit_block->start_addr, size, out);
+        MEM_LOG(out, "[bestfit_malloc] Tìm thấy khối phù hợp nhất tại %p (kích thước %zu).\n", best_fit_block->start_addr, best_fit_block->size);
+        return allocate_from_block(manager, best_fit_block, (char*)best_fit_block->start_addr, size, out);
     }
 
-    fprintf(out, "[bestfit_malloc] Không tồn tại vùng trống tự do đáp ứng yêu cầu (%zu bytes).\n", size);
+    MEM_LOG(out, "[bestfit_malloc] Không tồn tại vùng trống tự do đáp ứng yêu cầu (%zu bytes).\n", size);
     return NULL;
 }
 
 // Chiến lược cấp phát bộ nhớ Worst Fit
 void *worstfit_malloc(MemoryManagement *manager, size_t size, FILE *out) {
     if (manager == NULL) {
-        fprintf(out, "[worstfit_malloc] Lỗi: Con trỏ manager là NULL.\n");
+        MEM_LOG(out, "[worstfit_malloc] Lỗi: Con trỏ manager là NULL.\n");
         return NULL;
     }
-    if (size == 0) {
-        fprintf(out, "[worstfit_malloc] Kích thước khối nhớ xin cấp phát không hợp lệ.\n");
+    if (size == 0 || size > manager->total_memory_size) {
+        MEM_LOG(out, "[worstfit_malloc] Kích thước khối nhớ xin cấp phát không hợp lệ.\n");
         return NULL;
     }
 
-    MemoryBlock *current = manager->free_list;
-    MemoryBlock *worst_fit_block = NULL;
-    size_t max_size = 0; 
-
-    while (current != NULL) {
-        if (current->size >= size) {
-            if (current->size > max_size) {
-                max_size = current->size;
-                worst_fit_block = current;
-            }
-        }
-        current = current->next;
-    }
-
-    if (worst_fit_block != NULL) {
-        fprintf(out, "[worstfit_malloc] Tìm thấy khối tệ nhất tại %p (kích thước %zu).\n", worst_fit_block->start_addr, worst_fit_block->size);
-        return allocate_at_address(manager, worst_fit_block->start_addr, size, out);
+    // Khối lớn nhất, dùng được nếu đủ chỗ
+    manager->search_count++;
+    MemoryBlock *worst_fit_block = mem_tree_max_size(manager->size_tree, &manager->search_steps);
+    if (worst_fit_block != NULL && worst_fit_block->size >= block_size_for(size)) {
+        MEM_LOG(out, "[worstfit_malloc] Tìm thấy khối tệ nhất tại %p (kích thước %zu).\n", worst_fit_block->start_addr, worst_fit_block->size);
+        return allocate_from_block(manager, worst_fit_block, (char*)worst_fit_block->start_addr, size, out);
     }
 
-    fprintf(out, "[worstfit_malloc] Không tồn tại vùng trống tự do đáp ứng yêu cầu (%zu bytes).\n", size);
+    MEM_LOG(out, "[worstfit_malloc] Không tồn tại vùng trống tự do đáp ứng yêu cầu (%zu bytes).\n", size);
     return NULL;
 }
 
 void *nextfit_malloc(MemoryManagement *manager, size_t size, FILE *out) {
     if (manager == NULL) {
-        fprintf(out, "[nextfit_malloc] Lỗi: Con trỏ manager là NULL.\n");
+        MEM_LOG(out, "[nextfit_malloc] Lỗi: Con trỏ manager là NULL.\n");
         return NULL;
     }
-    if (size == 0) {
-        fprintf(out, "[nextfit_malloc] Kích thước khối nhớ xin cấp phát không hợp lệ.\n");
+    if (size == 0 || size > manager->total_memory_size) {
+        MEM_LOG(out, "[nextfit_malloc] Kích thước khối nhớ xin cấp phát không hợp lệ.\n");
         return NULL;
     }
 
-    if (manager->next_fit_last_block == NULL) {
-        manager->next_fit_last_block = manager->free_list;
+    // Con trỏ next fit là một offset nên luôn hợp lệ dù các khối trống bị cấp phát, tách hay gộp.
+    // Lần tìm bắt đầu từ vùng trống chứa offset (khi khối trống được gộp đè lên vị trí đó) hoặc vùng trống
+    // đầu tiên phía sau, rồi đi theo thứ tự địa chỉ và quay vòng về đầu vùng nhớ.
+    size_t needed = block_size_for(size);
+    char *base = (char*)manager->base_memory_address;
+    char *rover = base + manager->next_fit_offset;
+    MemoryBlock *start_search_block = mem_tree_floor_address(manager->address_tree, rover, &manager->search_steps);
+    if (start_search_block == NULL || (char*)start_search_block->start_addr + start_search_block->size <= rover) {
+        start_search_block = mem_tree_ceiling_address(manager->address_tree, rover, &manager->search_steps);
     }
+    if (start_search_block == NULL) start_search_block = mem_tree_ceiling_address(manager->address_tree, base, &manager->search_steps);
+    manager->search_count++;
 
-    MemoryBlock *start_search_block = manager->next_fit_last_block;
+    // search_steps đếm số nút cây đã đi qua (như các chiến lược khác), kể cả các lần tra cây để sang vùng trống kế tiếp
     MemoryBlock *current = start_search_block;
-    void *allocated_addr = NULL;
-    int wrapped_around = 0;
-
-    do {
-        while (current != NULL) {
-            if (current->size >= size) {
-                allocated_addr = current->start_addr;
-                fprintf(out, "[nextfit_malloc] Tìm thấy khối phù hợp từ điểm cuối tại %p (kích thước %zu).\n", current->start_addr, current->size);
-                
-                // Cập nhật next_fit_last_block tới vị trí tiếp theo sau khi cấp phát
-                if (current->size == size) { // Exact fit
-                    manager->next_fit_last_block = current->next;
-                } else { // Split
-                    manager->next_fit_last_block = current; // Vẫn trỏ vào khối hiện tại đã bị cắt
-                }
-                return allocate_at_address(manager, allocated_addr, size, out);
-            }
-            current = current->next;
+    while (current != NULL) {
+        if (current->size >= needed) {
+            MEM_LOG(out, "[nextfit_malloc] Tìm thấy khối phù hợp từ điểm cuối tại %p (kích thước %zu).\n", current->start_addr, current->size);
+
+            // Lần tìm sau bắt đầu ngay sau khối vừa cấp phát
+            char *block_start = (char*)current->start_addr;
+            void *allocated_addr = allocate_from_block(manager, current, block_start, size, out);
+            manager->next_fit_offset = (size_t)(block_start + block_size_at(block_start) - base);
+            return allocated_addr;
         }
+        current = mem_tree_ceiling_address(manager->address_tree, (char*)current->start_addr + current->size, &manager->search_steps);
+        if (current == NULL) current = mem_tree_ceiling_address(manager->address_tree, base, &manager->search_steps);
+        if (current == start_search_block) break;
+    }
 
-        if (!wrapped_around) {
-            current = manager->free_list; 
-            wrapped_around = 1; 
-        } else {
-            break;
+    MEM_LOG(out, "[nextfit_malloc] Không tồn tại vùng trống tự do đáp ứng yêu cầu (%zu bytes).\n", size);
+    return NULL;
+}
+
+// Cấp phát size bytes với địa chỉ dữ liệu là bội số của alignment (luỹ thừa 2), duyệt các vùng trống đủ lớn
+// theo thứ tự địa chỉ như first fit
+void *aligned_malloc(MemoryManagement *manager, size_t size, size_t alignment, FILE *out) {
+    if (manager == NULL) {
+        MEM_LOG(out, "[aligned_malloc] Lỗi: Con trỏ manager là NULL.\n");
+        return NULL;
+    }
+    if (size == 0 || size > manager->total_memory_size || alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        MEM_LOG(out, "[aligned_malloc] Kích thước hoặc alignment không hợp lệ.\n");
+        return NULL;
+    }
+
+    if (alignment < MEM_BLOCK_ALIGN) alignment = MEM_BLOCK_ALIGN;
+    size_t block_size = block_size_for(size);
+    manager->search_count++;
+    for (MemoryBlock *current = mem_tree_first_fit(manager->address_tree, manager->base_memory_address, block_size, &manager->search_steps);
+         current != NULL;
+         current = mem_tree_first_fit(manager->address_tree, (char*)current->start_addr + current->size, block_size, &manager->search_steps)) {
+        char *free_start = (char*)current->start_addr;
+        char *free_end = free_start + current->size;
+        uintptr_t payload = ((uintptr_t)(free_start + MEM_BLOCK_HEADER_SIZE) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        // Phần trống phía trước phải bằng 0 hoặc đủ lớn để tách thành một vùng trống riêng
+        size_t lead = payload - MEM_BLOCK_HEADER_SIZE - (uintptr_t)free_start;
+        if (lead != 0 && lead < MEM_BLOCK_MIN_SIZE) {
+            payload += (MEM_BLOCK_MIN_SIZE - lead + alignment - 1) & ~(uintptr_t)(alignment - 1);
         }
-    } while (current != start_search_block); 
+        char *block_start = (char*)payload - MEM_BLOCK_HEADER_SIZE;
+        if (block_start + block_size <= free_end) {
+            void *allocated_addr = allocate_from_block(manager, current, block_start, size, out);
+            MEM_LOG(out, "[aligned_malloc] Cấp phát %zu bytes tại địa chỉ %p (alignment %zu).\n", size, allocated_addr, alignment);
+            return allocated_addr;
+        }
+    }
 
-    fprintf(out, "[nextfit_malloc] Không tồn tại vùng trống tự do đáp ứng yêu cầu (%zu bytes).\n", size);
-    manager->next_fit_last_block = NULL; 
+    MEM_LOG(out, "[aligned_malloc] Không tồn tại vùng trống tự do đáp ứng yêu cầu (%zu bytes, alignment %zu).\n", size, alignment);
     return NULL;
 }
 
+// Header của khối đang cấp phát chứa ptr, NULL nếu ptr nằm ngoài vùng quản lý hoặc header/footer không khớp
+static char *allocated_block_at(MemoryManagement *manager, void *ptr) {
+    if ((char*)ptr < (char*)manager->base_memory_address + MEM_BLOCK_HEADER_SIZE ||
+        (char*)ptr + MEM_BLOCK_FOOTER_SIZE > (char*)manager->last_memory_address) {
+        return NULL;
+    }
+    char *block = (char*)ptr - MEM_BLOCK_HEADER_SIZE;
+    size_t block_size = block_size_at(block);
+    if (block_requested_at(block) == 0 || block_size < MEM_BLOCK_MIN_SIZE ||
+        block_size > (size_t)((char*)manager->last_memory_address - block) ||
+        read_tag(block + block_size - MEM_BLOCK_FOOTER_SIZE) != block_size) {
+        return NULL;
+    }
+    return block;
+}
+
 // Hàm giải phóng
-void free_mem(MemoryManagement *manager, void *ptr, size_t size, FILE *out) {
+void free_mem(MemoryManagement *manager, void *ptr, FILE *out) {
     if (manager == NULL) {
-        fprintf(out, "[free_mem] Lỗi: Con trỏ manager là NULL.\n");
+        MEM_LOG(out, "[free_mem] Lỗi: Con trỏ manager là NULL.\n");
         return;
     }
-    if (ptr == NULL || size == 0) {
-        fprintf(out, "[free_mem] Không thể giải phóng địa chỉ NULL hoặc kích thước 0.\n");
+    if (ptr == NULL) {
+        MEM_LOG(out, "[free_mem] Không thể giải phóng địa chỉ NULL.\n");
         return;
     }
 
-    if (ptr < manager->base_memory_address || (char*)ptr + size > (char*)manager->base_memory_address + manager->total_memory_size) {
-        fprintf(out, "[free_mem] Địa chỉ %p nằm ngoài vùng bộ nhớ được quản lý.\n", ptr);
+    char *block = allocated_block_at(manager, ptr);
+    if (block == NULL) {
+        MEM_LOG(out, "[free_mem] Địa chỉ %p không phải một khối đang được cấp phát.\n", ptr);
         return;
     }
-    fprintf(out, "\n[free_mem] Thực hiện giải %zu bytes tại địa chỉ %p.\n", size, ptr);
+    size_t block_size = block_size_at(block);
+    size_t size = block_requested_at(block);
+    MEM_LOG(out, "\n[free_mem] Thực hiện giải %zu bytes tại địa chỉ %p.\n", size, ptr);
 
     manager->allocated_memory_size -= size;
     
-    add_free_mem_block(manager, ptr, size, out); 
+    add_free_mem_block(manager, block, block_size, out); 
     
-    fprintf(out, "[free_mem] Đã giải phóng %zu bytes tại địa chỉ %p.\n", size, ptr);
+    MEM_LOG(out, "[free_mem] Đã giải phóng %zu bytes tại địa chỉ %p.\n", size, ptr);
+}
+
+// Đổi kích thước khối tại ptr: thu nhỏ tại chỗ (tách phần đuôi thành vùng trống), mở rộng sang khối trống liền sau,
+// chỉ khi cả hai không được mới cấp phát khối mới (first fit), sao chép dữ liệu và giải phóng khối cũ
+void *realloc_mem(MemoryManagement *manager, void *ptr, size_t size, FILE *out) {
+    if (manager == NULL) {
+        MEM_LOG(out, "[realloc_mem] Lỗi: Con trỏ manager là NULL.\n");
+        return NULL;
+    }
+    if (ptr == NULL) return firstfit_malloc(manager, size, out);
+    if (size == 0) {
+        free_mem(manager, ptr, out);
+        return NULL;
+    }
+    if (size > manager->total_memory_size) {
+        MEM_LOG(out, "[realloc_mem] Kích thước khối nhớ xin cấp phát không hợp lệ.\n");
+        return NULL;
+    }
+
+    char *block = allocated_block_at(manager, ptr);
+    if (block == NULL) {
+        MEM_LOG(out, "[realloc_mem] Địa chỉ %p không phải một khối đang được cấp phát.\n", ptr);
+        return NULL;
+    }
+    size_t block_size = block_size_at(block);
+    size_t old_size = block_requested_at(block);
+    size_t needed = block_size_for(size);
+
+    // Mở rộng: gộp (một phần) khối trống liền sau vào khối hiện tại
+    char *next = block + block_size;
+    if (needed > block_size && next < (char*)manager->last_memory_address && block_requested_at(next) == 0 &&
+        block_size + block_size_at(next) >= needed) {
+        MemoryBlock *next_descriptor = block_descriptor_at(next);
+        size_t trail = block_size + next_descriptor->size - needed;
+        if (trail < MEM_BLOCK_MIN_SIZE) {
+            remove_free_block(manager, next_descriptor);
+            needed += trail;
+        } else {
+            resize_free_block(manager, next_descriptor, block + needed, trail);
+        }
+        write_block_tags(block, needed, size);
+        manager->allocated_memory_size += size - old_size;
+        MEM_LOG(out, "[realloc_mem] Mở rộng tại chỗ khối %p lên %zu bytes.\n", ptr, size);
+        return ptr;
+    }
+
+    // Thu nhỏ (hoặc đủ chỗ sẵn): phần đuôi đủ lớn thì tách ra thành vùng trống và gộp với khối trống liền sau
+    if (needed <= block_size) {
+        if (block_size - needed >= MEM_BLOCK_MIN_SIZE) {
+            write_block_tags(block, needed, size);
+            add_free_mem_block(manager, block + needed, block_size - needed, out);
+        } else {
+            write_block_tags(block, block_size, size);
+        }
+        manager->allocated_memory_size = manager->allocated_memory_size - old_size + size;
+        MEM_LOG(out, "[realloc_mem] Đổi kích thước tại chỗ khối %p thành %zu bytes.\n", ptr, size);
+        return ptr;
+    }
+
+    void *new_ptr = firstfit_malloc(manager, size, out);
+    if (new_ptr == NULL) {
+        MEM_LOG(out, "[realloc_mem] Không đủ vùng trống để mở rộng khối %p lên %zu bytes.\n", ptr, size);
+        return NULL;
+    }
+    memcpy(new_ptr, ptr, old_size < size ? old_size : size);
+    free_mem(manager, ptr, out);
+    MEM_LOG(out, "[realloc_mem] Chuyển khối %p sang %p (%zu bytes).\n", ptr, new_ptr, size);
+    return new_ptr;
 }
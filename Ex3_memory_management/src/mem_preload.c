@@ -0,0 +1,291 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "mem_alloc.h"
+#include "tlsf_alloc.h"
+#include "flat_buddy.h"
+#include "mem_stats.h"
+
+// Thư viện chia sẻ thay thế malloc/free/calloc/realloc/posix_memalign của chương trình bằng một chiến lược của Ex3,
+// dùng để đo các chiến lược trên chương trình thật:
+//   MEM_PRELOAD_STRATEGY=best_fit LD_PRELOAD=./libmempreload.so <chương trình>
+//
+// Biến môi trường:
+//   MEM_PRELOAD_STRATEGY   first_fit (mặc định), best_fit, worst_fit, next_fit, buddy (buddy mảng phẳng), tlsf
+//   MEM_PRELOAD_POOL_MB    kích thước pool, mặc định 1024 MB; pool được mmap với MAP_NORESERVE nên chỉ các trang
+//                          đã chạm tới mới chiếm bộ nhớ thật
+//   MEM_PRELOAD_STATS      khác rỗng: khi chương trình kết thúc, ghi thống kê heap (JSON, mem_stats.h) ra stderr
+//
+// Mọi thao tác được bảo vệ bằng một mutex. Mỗi khối có header PRELOAD_HEADER_SIZE bytes ngay trước địa chỉ trả về,
+// lưu khối gốc của bộ cấp phát và kích thước người dùng xin, nên free/realloc/posix_memalign dùng chung cho mọi chiến lược.
+//
+// Bản thân các bộ cấp phát gọi malloc/calloc/free cho cấu trúc quản lý (MemoryManagement, bitmap của buddy...).
+// Các lời gọi lồng nhau đó (nhận biết bằng cờ theo luồng in_backend) được phục vụ bởi một heap phụ nhỏ
+// nằm ngoài pool: lớp kích thước luỹ thừa 2 đến 4096 bytes, khối lớn hơn thì mmap riêng.
+
+#define PRELOAD_HEADER_SIZE 16
+#define PRELOAD_ALIGN 16
+#define PRELOAD_DEFAULT_POOL_MB 1024
+#define PRELOAD_META_MIN_SHIFT 4
+#define PRELOAD_META_CLASS_COUNT 9                  // Lớp 16, 32, ..., 4096 bytes (tính cả header)
+#define PRELOAD_META_CHUNK_SIZE (1u << 20)
+
+typedef enum PreloadStrategy {
+    PRELOAD_FIRST_FIT,
+    PRELOAD_BEST_FIT,
+    PRELOAD_WORST_FIT,
+    PRELOAD_NEXT_FIT,
+    PRELOAD_BUDDY,
+    PRELOAD_TLSF
+} PreloadStrategy;
+
+static const char* strategy_names[] = {"first_fit", "best_fit", "worst_fit", "next_fit", "buddy", "tlsf"};
+
+// Header trước mỗi khối trả cho người dùng
+typedef struct PreloadHeader {
+    void* block;            // Địa chỉ do bộ cấp phát trả về, truyền lại khi giải phóng
+    size_t size;            // Số byte người dùng xin
+} PreloadHeader;
+
+static pthread_mutex_t preload_lock = PTHREAD_MUTEX_INITIALIZER;
+static int initialized = 0;
+static PreloadStrategy strategy = PRELOAD_FIRST_FIT;
+static MemoryManagement* manager = NULL;
+static FlatBuddySystem* buddy = NULL;
+static TLSFAllocator* tlsf = NULL;
+
+// 1 khi luồng hiện tại đang ở trong bộ cấp phát (giữ preload_lock); initial-exec để truy cập TLS không cần malloc
+static __thread int in_backend __attribute__((tls_model("initial-exec"))) = 0;
+
+// ============================ Heap phụ cho cấu trúc quản lý ============================ //
+
+// Chỉ được dùng khi đang giữ preload_lock, nên không cần khoá riêng
+static void* meta_free_lists[PRELOAD_META_CLASS_COUNT];
+static char* meta_chunk_next = NULL;
+static char* meta_chunk_end = NULL;
+
+static void* meta_malloc(size_t size) {
+    size_t total = size + PRELOAD_HEADER_SIZE;
+    int class_index = 0;
+    while (class_index < PRELOAD_META_CLASS_COUNT && ((size_t)1 << (class_index + PRELOAD_META_MIN_SHIFT)) < total) class_index++;
+
+    char* block;
+    size_t header;
+    if (class_index == PRELOAD_META_CLASS_COUNT) {
+        // Khối lớn: mmap riêng, header lưu độ dài vùng map (luôn >= trang nên không trùng chỉ số lớp)
+        header = (total + (size_t)getpagesize() - 1) & ~((size_t)getpagesize() - 1);
+        block = (char*)mmap(NULL, header, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (block == MAP_FAILED) return NULL;
+    } else if (meta_free_lists[class_index] != NULL) {
+        block = (char*)meta_free_lists[class_index];
+        meta_free_lists[class_index] = *(void**)block;
+        header = (size_t)class_index;
+    } else {
+        size_t class_size = (size_t)1 << (class_index + PRELOAD_META_MIN_SHIFT);
+        if (meta_chunk_next == NULL || (size_t)(meta_chunk_end - meta_chunk_next) < class_size) {
+            char* chunk = (char*)mmap(NULL, PRELOAD_META_CHUNK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (chunk == MAP_FAILED) return NULL;
+            meta_chunk_next = chunk;
+            meta_chunk_end = chunk + PRELOAD_META_CHUNK_SIZE;
+        }
+        block = meta_chunk_next;
+        meta_chunk_next += class_size;
+        header = (size_t)class_index;
+    }
+    memcpy(block, &header, sizeof(header));
+    return block + PRELOAD_HEADER_SIZE;
+}
+
+static void meta_free(void* ptr) {
+    char* block = (char*)ptr - PRELOAD_HEADER_SIZE;
+    size_t header;
+    memcpy(&header, block, sizeof(header));
+    if (header >= PRELOAD_META_CLASS_COUNT) {
+        munmap(block, header);
+        return;
+    }
+    *(void**)block = meta_free_lists[header];
+    meta_free_lists[header] = block;
+}
+
+// ============================ Bộ cấp phát được chọn ============================ //
+
+// Khởi tạo pool và bộ cấp phát theo biến môi trường, gọi khi đang giữ preload_lock và in_backend = 1
+static int initialize_backend(void) {
+    const char* name = getenv("MEM_PRELOAD_STRATEGY");
+    if (name != NULL) {
+        for (int i = 0; i < (int)(sizeof(strategy_names) / sizeof(strategy_names[0])); i++) {
+            if (strcmp(name, strategy_names[i]) == 0) strategy = (PreloadStrategy)i;
+        }
+    }
+    const char* pool_mb = getenv("MEM_PRELOAD_POOL_MB");
+    size_t pool_size = (size_t)(pool_mb != NULL && atol(pool_mb) > 0 ? atol(pool_mb) : PRELOAD_DEFAULT_POOL_MB) << 20;
+
+    void* pool = mmap(NULL, pool_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (pool == MAP_FAILED) return 0;
+
+    switch (strategy) {
+        case PRELOAD_BUDDY: buddy = create_flat_buddy_system(pool, pool_size, NULL); break;
+        case PRELOAD_TLSF:  tlsf = create_tlsf_allocator(pool, pool_size, NULL); break;
+        default:            manager = initialize_memory_manager(pool, pool_size, NULL); break;
+    }
+    if (manager == NULL && buddy == NULL && tlsf == NULL) {
+        munmap(pool, pool_size);
+        return 0;
+    }
+    return 1;
+}
+
+static void* backend_malloc(size_t size) {
+    switch (strategy) {
+        case PRELOAD_FIRST_FIT: return firstfit_malloc(manager, size, NULL);
+        case PRELOAD_BEST_FIT:  return bestfit_malloc(manager, size, NULL);
+        case PRELOAD_WORST_FIT: return worstfit_malloc(manager, size, NULL);
+        case PRELOAD_NEXT_FIT:  return nextfit_malloc(manager, size, NULL);
+        case PRELOAD_BUDDY:     return flat_buddy_malloc(buddy, size, NULL);
+        default:                return tlsf_malloc(tlsf, size, NULL);
+    }
+}
+
+static void backend_free(void* block) {
+    switch (strategy) {
+        case PRELOAD_BUDDY: free_flat_buddy(buddy, block, NULL); break;
+        case PRELOAD_TLSF:  free_tlsf(tlsf, block, NULL); break;
+        default:            free_mem(manager, block, NULL); break;
+    }
+}
+
+// Cấp phát size bytes, địa chỉ trả về là bội số của alignment (luỹ thừa 2, >= PRELOAD_ALIGN)
+static void* preload_allocate(size_t size, size_t alignment) {
+    if (size == 0) size = 1;
+    // Khối gốc có thể không thẳng hàng (boundary tag của MemoryManagement), nên xin thêm alignment - 1 bytes để căn lại
+    if (size > SIZE_MAX - PRELOAD_HEADER_SIZE - alignment) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    size_t request = size + PRELOAD_HEADER_SIZE + alignment - 1;
+
+    pthread_mutex_lock(&preload_lock);
+    in_backend = 1;
+    void* block = NULL;
+    if (initialized || (initialized = initialize_backend())) block = backend_malloc(request);
+    in_backend = 0;
+    pthread_mutex_unlock(&preload_lock);
+    if (block == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    uintptr_t user = ((uintptr_t)block + PRELOAD_HEADER_SIZE + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    PreloadHeader header = {block, size};
+    memcpy((char*)user - PRELOAD_HEADER_SIZE, &header, sizeof(header));
+    return (void*)user;
+}
+
+static PreloadHeader read_header(const void* ptr) {
+    PreloadHeader header;
+    memcpy(&header, (const char*)ptr - PRELOAD_HEADER_SIZE, sizeof(header));
+    return header;
+}
+
+// ============================ Các hàm thay thế ============================ //
+
+void* malloc(size_t size) {
+    if (in_backend) return meta_malloc(size);
+    return preload_allocate(size, PRELOAD_ALIGN);
+}
+
+void free(void* ptr) {
+    if (ptr == NULL) return;
+    if (in_backend) {
+        meta_free(ptr);
+        return;
+    }
+    PreloadHeader header = read_header(ptr);
+    pthread_mutex_lock(&preload_lock);
+    in_backend = 1;
+    backend_free(header.block);
+    in_backend = 0;
+    pthread_mutex_unlock(&preload_lock);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    size_t total = count * size;
+    void* ptr = malloc(total);
+    // Khối lớn của heap phụ vừa được mmap nên đã là 0, không cần chạm vào các trang của nó
+    int fresh_mapping = in_backend && total + PRELOAD_HEADER_SIZE > ((size_t)1 << (PRELOAD_META_CLASS_COUNT - 1 + PRELOAD_META_MIN_SHIFT));
+    if (ptr != NULL && !fresh_mapping) memset(ptr, 0, total);
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (ptr == NULL) return malloc(size);
+    if (size == 0) {
+        free(ptr);
+        return NULL;
+    }
+    PreloadHeader header = read_header(ptr);
+    if (size <= header.size) return ptr;
+
+    void* new_ptr = malloc(size);
+    if (new_ptr == NULL) return NULL;
+    memcpy(new_ptr, ptr, header.size);
+    free(ptr);
+    return new_ptr;
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) return EINVAL;
+    void* ptr = preload_allocate(size, alignment < PRELOAD_ALIGN ? PRELOAD_ALIGN : alignment);
+    if (ptr == NULL) return ENOMEM;
+    *result = ptr;
+    return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return preload_allocate(size, alignment < PRELOAD_ALIGN ? PRELOAD_ALIGN : alignment);
+}
+
+void* memalign(size_t alignment, size_t size) { return aligned_alloc(alignment, size); }
+
+void* valloc(size_t size) { return aligned_alloc((size_t)getpagesize(), size); }
+
+size_t malloc_usable_size(void* ptr) { return ptr != NULL ? read_header(ptr).size : 0; }
+
+// Ghi thống kê heap khi chương trình kết thúc (MEM_PRELOAD_STATS)
+__attribute__((destructor)) static void report_stats(void) {
+    if (!initialized || getenv("MEM_PRELOAD_STATS") == NULL) return;
+    pthread_mutex_lock(&preload_lock);
+    MemoryStats stats;
+    if (manager != NULL) {
+        mem_stats_from_manager(manager, &stats);
+    } else if (buddy != NULL) {
+        mem_stats_from_flat_buddy(buddy, &stats);
+    } else {
+        TLSFStats tlsf_stats;
+        tlsf_get_stats(tlsf, &tlsf_stats);
+        memset(&stats, 0, sizeof(stats));
+        stats.total_bytes = tlsf->total_memory_size;
+        stats.allocated_bytes = tlsf->allocated_memory_size;
+        stats.used_bytes = tlsf->allocated_memory_size;
+        stats.free_bytes = tlsf_stats.free_bytes;
+        stats.free_blocks = tlsf_stats.free_blocks;
+        stats.largest_free_block = tlsf_stats.largest_free_block;
+        stats.fragmentation = tlsf_stats.fragmentation;
+    }
+    pthread_mutex_unlock(&preload_lock);
+    mem_stats_write_json(&stats, strategy_names[strategy], stderr);
+}
@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "mem_alloc.h"
+#include "mem_log.h"
+
+#define REGION_HEADER_SIZE ((sizeof(RegionChunk) + MEM_REGION_ALIGN - 1) & ~(size_t)(MEM_REGION_ALIGN - 1))
+
+static char *chunk_data(RegionChunk *chunk) { return (char*)chunk + REGION_HEADER_SIZE; }
+
+// Lấy chunk mới chứa được ít nhất size bytes từ manager và chèn ngay sau chunk hiện tại (đầu chuỗi nếu chưa cấp phát gì),
+// các chunk chưa dùng phía sau vẫn được giữ trong chuỗi
+static RegionChunk *new_region_chunk(Region *region, size_t size, FILE *out) {
+    size_t data_size = size > region->chunk_size ? size : region->chunk_size;
+    RegionChunk *chunk = (RegionChunk*)aligned_malloc(region->manager, REGION_HEADER_SIZE + data_size, MEM_REGION_ALIGN, out);
+    if (chunk == NULL) return NULL;
+    chunk->limit = chunk_data(chunk) + data_size;
+    if (region->current == NULL) {
+        chunk->next = region->first;
+        region->first = chunk;
+    } else {
+        chunk->next = region->current->next;
+        region->current->next = chunk;
+    }
+    region->chunk_count++;
+    return chunk;
+}
+
+Region *create_region(MemoryManagement *manager, size_t chunk_size, FILE *out) {
+    if (manager == NULL) {
+        MEM_LOG(out, "[create_region] Lỗi: Con trỏ manager là NULL.\n");
+        return NULL;
+    }
+    Region *region = (Region*)calloc(1, sizeof(Region));
+    if (region == NULL) {
+        MEM_LOG(out, "[create_region] Lỗi: Không thể cấp phát cấu trúc Region.\n");
+        return NULL;
+    }
+    region->manager = manager;
+    region->chunk_size = chunk_size == 0 ? MEM_REGION_CHUNK_SIZE : chunk_size;
+    region->chunk_size = (region->chunk_size + MEM_REGION_ALIGN - 1) & ~(size_t)(MEM_REGION_ALIGN - 1);
+
+    MEM_LOG(out, "[create_region] Region với chunk %zu bytes.\n", region->chunk_size);
+    return region;
+}
+
+void *region_malloc(Region *region, size_t size, FILE *out) {
+    if (region == NULL || size == 0 || size > SIZE_MAX - MEM_REGION_ALIGN) {
+        MEM_LOG(out, "[region_malloc] Lỗi: Tham số không hợp lệ.\n");
+        return NULL;
+    }
+    size = (size + MEM_REGION_ALIGN - 1) & ~(size_t)(MEM_REGION_ALIGN - 1);
+
+    if (region->current == NULL || (size_t)(region->current->limit - region->cursor) < size) {
+        // Dùng lại chunk kế tiếp nếu đủ chỗ (sau reset/rollback), nếu không thì lấy chunk mới từ manager
+        RegionChunk *next = region->current != NULL ? region->current->next : region->first;
+        if (next == NULL || (size_t)(next->limit - chunk_data(next)) < size) {
+            next = new_region_chunk(region, size, out);
+            if (next == NULL) {
+                MEM_LOG(out, "[region_malloc] Không thể lấy chunk mới cho %zu bytes từ vùng nhớ quản lý.\n", size);
+                return NULL;
+            }
+        }
+        region->current = next;
+        region->cursor = chunk_data(next);
+    }
+
+    void *allocated_addr = region->cursor;
+    region->cursor += size;
+    region->allocated_bytes += size;
+    return allocated_addr;
+}
+
+RegionSavepoint region_save(const Region *region) {
+    RegionSavepoint savepoint = {NULL, NULL, 0};
+    if (region != NULL) {
+        savepoint.chunk = region->current;
+        savepoint.cursor = region->cursor;
+        savepoint.allocated_bytes = region->allocated_bytes;
+    }
+    return savepoint;
+}
+
+void region_rollback(Region *region, RegionSavepoint savepoint, FILE *out) {
+    if (region == NULL || savepoint.allocated_bytes > region->allocated_bytes) {
+        MEM_LOG(out, "[region_rollback] Lỗi: Savepoint không hợp lệ.\n");
+        return;
+    }
+    // Savepoint lưu trước khi có chunk nào: quay về đầu chuỗi như reset
+    region->current = savepoint.chunk;
+    region->cursor = savepoint.cursor;
+    region->allocated_bytes = savepoint.allocated_bytes;
+}
+
+void region_reset(Region *region, FILE *out) {
+    if (region == NULL) {
+        MEM_LOG(out, "[region_reset] Lỗi: Con trỏ region là NULL.\n");
+        return;
+    }
+    // current = NULL nghĩa là chưa cấp phát gì: lần cấp phát sau bắt đầu lại từ chunk đầu tiên
+    region->current = NULL;
+    region->cursor = NULL;
+    region->allocated_bytes = 0;
+}
+
+void destroy_region(Region *region, FILE *out) {
+    if (region == NULL) {
+        MEM_LOG(out, "[destroy_region] Con trỏ region trỏ tới NULL.\n");
+        return;
+    }
+    RegionChunk *chunk = region->first;
+    while (chunk != NULL) {
+        RegionChunk *next = chunk->next;
+        free_mem(region->manager, chunk, out);
+        chunk = next;
+    }
+    MEM_LOG(out, "[destroy_region] Đã trả %zu chunk về vùng nhớ quản lý.\n", region->chunk_count);
+    free(region);
+}
@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "mem_alloc.h"
+#include "mem_log.h"
+
+#define SLAB_SLOT_ALIGN 16
+#define SLAB_MIN_SLOTS 8
+#define SLAB_HEADER_SIZE ((sizeof(SlabPage) + SLAB_SLOT_ALIGN - 1) & ~(size_t)(SLAB_SLOT_ALIGN - 1))
+// Phần dữ liệu xin cho một trang: cả khối (header + dữ liệu + footer) dài đúng page_size, nên header của khối kế tiếp
+// nằm ngay trước ranh giới page_size tiếp theo và các trang slab nằm sát nhau, không để lại lỗ trống giữa hai trang
+#define SLAB_PAGE_PAYLOAD(page_size) ((page_size) - MEM_BLOCK_HEADER_SIZE - MEM_BLOCK_FOOTER_SIZE)
+
+static void push_page(SlabPage **list, SlabPage *page) {
+    page->prev = NULL;
+    page->next = *list;
+    if (*list != NULL) (*list)->prev = page;
+    *list = page;
+}
+
+static void unlink_page(SlabPage **list, SlabPage *page) {
+    if (page->prev != NULL) {
+        page->prev->next = page->next;
+    } else {
+        *list = page->next;
+    }
+    if (page->next != NULL) page->next->prev = page->prev;
+}
+
+// Lấy một trang mới từ manager và nối mọi slot vào danh sách slot trống
+static SlabPage *new_slab_page(SlabCache *cache, FILE *out) {
+    SlabPage *page = (SlabPage*)aligned_malloc(cache->manager, SLAB_PAGE_PAYLOAD(cache->page_size), cache->page_size, out);
+    if (page == NULL) return NULL;
+    page->cache = cache;
+    page->used_slots = 0;
+    page->free_slots = NULL;
+    char *first_slot = (char*)page + SLAB_HEADER_SIZE;
+    for (size_t i = cache->slots_per_page; i > 0; i--) {
+        void **slot = (void**)(first_slot + (i - 1) * cache->slot_size);
+        *slot = page->free_slots;
+        page->free_slots = slot;
+    }
+    cache->page_count++;
+    return page;
+}
+
+SlabCache *create_slab_cache(MemoryManagement *manager, size_t object_size, FILE *out) {
+    if (manager == NULL || object_size == 0) {
+        MEM_LOG(out, "[create_slab_cache] Lỗi: Tham số không hợp lệ.\n");
+        return NULL;
+    }
+    SlabCache *cache = (SlabCache*)calloc(1, sizeof(SlabCache));
+    if (cache == NULL) {
+        MEM_LOG(out, "[create_slab_cache] Lỗi: Không thể cấp phát cấu trúc SlabCache.\n");
+        return NULL;
+    }
+    cache->manager = manager;
+    cache->object_size = object_size;
+    cache->slot_size = (object_size + SLAB_SLOT_ALIGN - 1) & ~(size_t)(SLAB_SLOT_ALIGN - 1);
+    // Trang là luỹ thừa 2 (để tìm trang bằng phép AND) và chứa ít nhất SLAB_MIN_SLOTS slot
+    cache->page_size = MEM_SLAB_PAGE_SIZE;
+    while (SLAB_PAGE_PAYLOAD(cache->page_size) < SLAB_HEADER_SIZE + SLAB_MIN_SLOTS * cache->slot_size) cache->page_size <<= 1;
+    cache->slots_per_page = (SLAB_PAGE_PAYLOAD(cache->page_size) - SLAB_HEADER_SIZE) / cache->slot_size;
+
+    MEM_LOG(out, "[create_slab_cache] Slab cache cho đối tượng %zu bytes: trang %zu bytes, %zu slot mỗi trang.\n",
+            object_size, cache->page_size, cache->slots_per_page);
+    return cache;
+}
+
+void *slab_malloc(SlabCache *cache, FILE *out) {
+    if (cache == NULL) {
+        MEM_LOG(out, "[slab_malloc] Lỗi: Con trỏ cache là NULL.\n");
+        return NULL;
+    }
+
+    SlabPage *page = cache->partial_pages;
+    if (page == NULL) {
+        page = cache->empty_page;
+        if (page != NULL) {
+            cache->empty_page = NULL;
+        } else {
+            page = new_slab_page(cache, out);
+            if (page == NULL) {
+                MEM_LOG(out, "[slab_malloc] Không thể lấy trang slab mới từ vùng nhớ quản lý.\n");
+                return NULL;
+            }
+        }
+        push_page(&cache->partial_pages, page);
+    }
+
+    void **slot = (void**)page->free_slots;
+    page->free_slots = *slot;
+    page->used_slots++;
+    if (page->used_slots == cache->slots_per_page) {
+        unlink_page(&cache->partial_pages, page);
+        push_page(&cache->full_pages, page);
+    }
+    cache->allocated_objects++;
+    return slot;
+}
+
+void slab_free(SlabCache *cache, void *ptr, FILE *out) {
+    if (cache == NULL || ptr == NULL) {
+        MEM_LOG(out, "[slab_free] Lỗi: Cache hoặc địa chỉ là NULL.\n");
+        return;
+    }
+    SlabPage *page = (SlabPage*)((uintptr_t)ptr & ~(uintptr_t)(cache->page_size - 1));
+    size_t offset = (size_t)((char*)ptr - (char*)page);
+    if (page->cache != cache || offset < SLAB_HEADER_SIZE || (offset - SLAB_HEADER_SIZE) % cache->slot_size != 0 ||
+        page->used_slots == 0) {
+        MEM_LOG(out, "[slab_free] Địa chỉ %p không phải một đối tượng của slab cache này.\n", ptr);
+        return;
+    }
+
+    if (page->used_slots == cache->slots_per_page) {
+        unlink_page(&cache->full_pages, page);
+        push_page(&cache->partial_pages, page);
+    }
+    *(void**)ptr = page->free_slots;
+    page->free_slots = ptr;
+    page->used_slots--;
+    cache->allocated_objects--;
+
+    // Trang trống: giữ lại một trang, trả các trang trống khác về manager
+    if (page->used_slots == 0) {
+        unlink_page(&cache->partial_pages, page);
+        if (cache->empty_page == NULL) {
+            cache->empty_page = page;
+        } else {
+            page->cache = NULL;
+            free_mem(cache->manager, page, out);
+            cache->page_count--;
+        }
+    }
+}
+
+static void release_pages(SlabCache *cache, SlabPage *page, FILE *out) {
+    while (page != NULL) {
+        SlabPage *next = page->next;
+        page->cache = NULL;
+        free_mem(cache->manager, page, out);
+        page = next;
+    }
+}
+
+void destroy_slab_cache(SlabCache *cache, FILE *out) {
+    if (cache == NULL) {
+        MEM_LOG(out, "[destroy_slab_cache] Con trỏ cache trỏ tới NULL.\n");
+        return;
+    }
+    release_pages(cache, cache->partial_pages, out);
+    release_pages(cache, cache->full_pages, out);
+    if (cache->empty_page != NULL) {
+        cache->empty_page->next = NULL;
+        release_pages(cache, cache->empty_page, out);
+    }
+    MEM_LOG(out, "[destroy_slab_cache] Đã trả %zu trang slab (đối tượng %zu bytes) về vùng nhớ quản lý.\n",
+            cache->page_count, cache->object_size);
+    free(cache);
+}
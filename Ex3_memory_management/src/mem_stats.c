@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <string.h>
+#include "mem_stats.h"
+#include "mem_tree.h"
+
+#define MEM_SIZE_CLASS_MIN_SHIFT 4 // Lớp 1 bắt đầu từ 32 bytes
+
+size_t mem_size_class(size_t size) {
+    if (size < ((size_t)2 << MEM_SIZE_CLASS_MIN_SHIFT)) return 0;
+    size_t size_class = (size_t)(63 - __builtin_clzll((unsigned long long)size)) - MEM_SIZE_CLASS_MIN_SHIFT;
+    return size_class < MEM_SIZE_CLASS_COUNT ? size_class : MEM_SIZE_CLASS_COUNT - 1;
+}
+
+size_t mem_size_class_min(size_t size_class) {
+    return size_class == 0 ? 0 : (size_t)1 << (size_class + MEM_SIZE_CLASS_MIN_SHIFT);
+}
+
+static void finish_stats(MemoryStats *stats) {
+    stats->used_bytes = stats->total_bytes - stats->free_bytes;
+    stats->internal_waste = stats->used_bytes > stats->allocated_bytes ? stats->used_bytes - stats->allocated_bytes : 0;
+    stats->fragmentation = stats->free_bytes == 0 ? 0.0 : 1.0 - (double)stats->largest_free_block / stats->free_bytes;
+}
+
+void mem_stats_from_manager(const MemoryManagement *manager, MemoryStats *stats) {
+    if (manager == NULL || stats == NULL) return;
+    memset(stats, 0, sizeof(*stats));
+    stats->total_bytes = manager->total_memory_size;
+    stats->allocated_bytes = manager->allocated_memory_size;
+    stats->free_bytes = manager->free_memory_size;
+    stats->free_blocks = manager->free_block_count;
+    MemoryBlock *largest = mem_tree_max_size(manager->size_tree, NULL);
+    stats->largest_free_block = largest != NULL ? largest->size : 0;
+    memcpy(stats->free_histogram, manager->free_size_classes, sizeof(stats->free_histogram));
+    finish_stats(stats);
+}
+
+static void collect_buddy_leaves(const BuddyBlock *node, MemoryStats *stats) {
+    if (node == NULL) return;
+    if (node->leftChild != NULL || node->rightChild != NULL) {
+        collect_buddy_leaves(node->leftChild, stats);
+        collect_buddy_leaves(node->rightChild, stats);
+        return;
+    }
+    if (!node->is_free) return;
+    stats->free_bytes += node->size;
+    stats->free_blocks++;
+    stats->free_histogram[mem_size_class(node->size)]++;
+    if (node->size > stats->largest_free_block) stats->largest_free_block = node->size;
+}
+
+void mem_stats_from_buddy(const BuddySystem *system, MemoryStats *stats) {
+    if (system == NULL || stats == NULL) return;
+    memset(stats, 0, sizeof(*stats));
+    stats->total_bytes = system->total_memory_size;
+    stats->allocated_bytes = system->allocated_memory_size;
+    collect_buddy_leaves(system->root, stats);
+    finish_stats(stats);
+}
+
+void mem_stats_from_flat_buddy(const FlatBuddySystem *system, MemoryStats *stats) {
+    if (system == NULL || stats == NULL) return;
+    memset(stats, 0, sizeof(*stats));
+    stats->total_bytes = system->managed_memory_size;
+    stats->allocated_bytes = system->allocated_memory_size;
+    for (int order = 0; order <= system->top_order; order++) {
+        size_t block_size = (size_t)1 << (order + FLAT_BUDDY_MIN_ORDER);
+        size_t count = system->free_counts[order];
+        if (count == 0) continue;
+        stats->free_bytes += count * block_size;
+        stats->free_blocks += count;
+        stats->free_histogram[mem_size_class(block_size)] += count;
+        stats->largest_free_block = block_size;
+    }
+    finish_stats(stats);
+}
+
+// Ghi chuỗi JSON trong dấu nháy: escape '"', '\\' và ký tự điều khiển, các byte UTF-8 giữ nguyên
+static void write_json_string(const char *text, FILE *out) {
+    fputc('"', out);
+    for (const unsigned char *p = (const unsigned char*)text; *p != '\0'; p++) {
+        switch (*p) {
+            case '"':  fputs("\\\"", out); break;
+            case '\\': fputs("\\\\", out); break;
+            case '\n': fputs("\\n", out); break;
+            case '\r': fputs("\\r", out); break;
+            case '\t': fputs("\\t", out); break;
+            default:
+                if (*p < 0x20) {
+                    fprintf(out, "\\u%04x", *p);
+                } else {
+                    fputc(*p, out);
+                }
+        }
+    }
+    fputc('"', out);
+}
+
+void mem_stats_write_csv_field(const char *field, FILE *out) {
+    if (out == NULL) return;
+    if (field == NULL) field = "";
+    // Trường chứa dấu phẩy, dấu nháy hoặc xuống dòng được đặt trong nháy kép, nháy bên trong được nhân đôi (RFC 4180)
+    if (strpbrk(field, ",\"\r\n") == NULL) {
+        fputs(field, out);
+        return;
+    }
+    fputc('"', out);
+    for (const char *p = field; *p != '\0'; p++) {
+        if (*p == '"') fputc('"', out);
+        fputc(*p, out);
+    }
+    fputc('"', out);
+}
+
+void mem_stats_write_json(const MemoryStats *stats, const char *label, FILE *out) {
+    if (stats == NULL || out == NULL) return;
+    fputs("{\"label\":", out);
+    write_json_string(label != NULL ? label : "", out);
+    fprintf(out, ",\"total_bytes\":%zu,\"allocated_bytes\":%zu,\"used_bytes\":%zu,"
+                 "\"free_bytes\":%zu,\"free_blocks\":%zu,\"largest_free_block\":%zu,\"fragmentation\":%.6f,"
+                 "\"internal_waste\":%zu,\"free_histogram\":{",
+            stats->total_bytes, stats->allocated_bytes, stats->used_bytes,
+            stats->free_bytes, stats->free_blocks, stats->largest_free_block, stats->fragmentation,
+            stats->internal_waste);
+    // Chỉ ghi các lớp khác rỗng, khoá là kích thước nhỏ nhất của lớp
+    int first = 1;
+    for (size_t size_class = 0; size_class < MEM_SIZE_CLASS_COUNT; size_class++) {
+        if (stats->free_histogram[size_class] == 0) continue;
+        fprintf(out, "%s\"%zu\":%zu", first ? "" : ",", mem_size_class_min(size_class), stats->free_histogram[size_class]);
+        first = 0;
+    }
+    fprintf(out, "}}\n");
+}
+
+void mem_stats_write_csv_header(FILE *out) {
+    if (out == NULL) return;
+    fprintf(out, "label,total_bytes,allocated_bytes,used_bytes,free_bytes,free_blocks,largest_free_block,"
+                 "fragmentation,internal_waste");
+    for (size_t size_class = 0; size_class < MEM_SIZE_CLASS_COUNT; size_class++) {
+        fprintf(out, ",free_%zu", mem_size_class_min(size_class));
+    }
+    fprintf(out, "\n");
+}
+
+void mem_stats_write_csv(const MemoryStats *stats, const char *label, FILE *out) {
+    if (stats == NULL || out == NULL) return;
+    mem_stats_write_csv_field(label, out);
+    fprintf(out, ",%zu,%zu,%zu,%zu,%zu,%zu,%.6f,%zu", stats->total_bytes,
+            stats->allocated_bytes, stats->used_bytes, stats->free_bytes, stats->free_blocks,
+            stats->largest_free_block, stats->fragmentation, stats->internal_waste);
+    for (size_t size_class = 0; size_class < MEM_SIZE_CLASS_COUNT; size_class++) {
+        fprintf(out, ",%zu", stats->free_histogram[size_class]);
+    }
+    fprintf(out, "\n");
+}
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "mem_tree.h"
+
+static MemoryTreeLink* link_of(MemoryBlock* block, MemoryTreeKind kind) {
+    return kind == MEM_TREE_BY_SIZE ? &block->size_link : &block->address_link;
+}
+
+static int height(MemoryBlock* block, MemoryTreeKind kind) {
+    return block == NULL ? 0 : link_of(block, kind)->height;
+}
+
+static size_t subtree_max_size(MemoryBlock* block) {
+    return block == NULL ? 0 : block->subtree_max_size;
+}
+
+// Tính lại chiều cao (và subtree_max_size với cây theo địa chỉ) từ hai con
+static void update_height(MemoryBlock* block, MemoryTreeKind kind) {
+    MemoryTreeLink* link = link_of(block, kind);
+    int left = height(link->left, kind);
+    int right = height(link->right, kind);
+    link->height = 1 + (left > right ? left : right);
+    if (kind == MEM_TREE_BY_ADDRESS) {
+        size_t max = block->size;
+        if (subtree_max_size(link->left) > max) max = subtree_max_size(link->left);
+        if (subtree_max_size(link->right) > max) max = subtree_max_size(link->right);
+        block->subtree_max_size = max;
+    }
+}
+
+// So sánh khoá của hai khối: < 0, 0, > 0
+static int compare(MemoryBlock* a, MemoryBlock* b, MemoryTreeKind kind) {
+    if (kind == MEM_TREE_BY_SIZE && a->size != b->size) return a->size < b->size ? -1 : 1;
+    if (a->start_addr == b->start_addr) return 0;
+    return (char*)a->start_addr < (char*)b->start_addr ? -1 : 1;
+}
+
+static MemoryBlock* rotate_right(MemoryBlock* node, MemoryTreeKind kind) {
+    MemoryBlock* left = link_of(node, kind)->left;
+    link_of(node, kind)->left = link_of(left, kind)->right;
+    link_of(left, kind)->right = node;
+    update_height(node, kind);
+    update_height(left, kind);
+    return left;
+}
+
+static MemoryBlock* rotate_left(MemoryBlock* node, MemoryTreeKind kind) {
+    MemoryBlock* right = link_of(node, kind)->right;
+    link_of(node, kind)->right = link_of(right, kind)->left;
+    link_of(right, kind)->left = node;
+    update_height(node, kind);
+    update_height(right, kind);
+    return right;
+}
+
+// Cân bằng lại node sau khi một cây con thay đổi chiều cao tối đa 1
+static MemoryBlock* rebalance(MemoryBlock* node, MemoryTreeKind kind) {
+    MemoryTreeLink* link = link_of(node, kind);
+    update_height(node, kind);
+    int balance = height(link->left, kind) - height(link->right, kind);
+    if (balance > 1) {
+        MemoryTreeLink* left = link_of(link->left, kind);
+        if (height(left->left, kind) < height(left->right, kind)) link->left = rotate_left(link->left, kind);
+        return rotate_right(node, kind);
+    }
+    if (balance < -1) {
+        MemoryTreeLink* right = link_of(link->right, kind);
+        if (height(right->right, kind) < height(right->left, kind)) link->right = rotate_right(link->right, kind);
+        return rotate_left(node, kind);
+    }
+    return node;
+}
+
+MemoryBlock* mem_tree_insert(MemoryBlock* root, MemoryBlock* block, MemoryTreeKind kind) {
+    if (root == NULL) {
+        MemoryTreeLink* link = link_of(block, kind);
+        link->left = NULL;
+        link->right = NULL;
+        update_height(block, kind);
+        return block;
+    }
+    MemoryTreeLink* link = link_of(root, kind);
+    if (compare(block, root, kind) < 0) {
+        link->left = mem_tree_insert(link->left, block, kind);
+    } else {
+        link->right = mem_tree_insert(link->right, block, kind);
+    }
+    return rebalance(root, kind);
+}
+
+// Gỡ khối nhỏ nhất của cây con, trả về gốc mới của cây con và lưu khối đó vào *min
+static MemoryBlock* remove_min(MemoryBlock* root, MemoryBlock** min, MemoryTreeKind kind) {
+    MemoryTreeLink* link = link_of(root, kind);
+    if (link->left == NULL) {
+        *min = root;
+        return link->right;
+    }
+    link->left = remove_min(link->left, min, kind);
+    return rebalance(root, kind);
+}
+
+MemoryBlock* mem_tree_remove(MemoryBlock* root, MemoryBlock* block, MemoryTreeKind kind) {
+    if (root == NULL) return NULL;
+    MemoryTreeLink* link = link_of(root, kind);
+    int cmp = compare(block, root, kind);
+    if (cmp < 0) {
+        link->left = mem_tree_remove(link->left, block, kind);
+    } else if (cmp > 0) {
+        link->right = mem_tree_remove(link->right, block, kind);
+    } else {
+        // Thay node bằng khối nhỏ nhất của cây con phải
+        if (link->left == NULL) return link->right;
+        if (link->right == NULL) return link->left;
+        MemoryBlock* successor = NULL;
+        MemoryBlock* right = remove_min(link->right, &successor, kind);
+        link_of(successor, kind)->left = link->left;
+        link_of(successor, kind)->right = right;
+        return rebalance(successor, kind);
+    }
+    return rebalance(root, kind);
+}
+
+MemoryBlock* mem_tree_replace(MemoryBlock* root, MemoryBlock* old_block, MemoryBlock* new_block, MemoryTreeKind kind) {
+    if (root == old_block) return new_block;
+    MemoryBlock* parent = root;
+    for (;;) {
+        MemoryTreeLink* link = link_of(parent, kind);
+        MemoryBlock** child = compare(new_block, parent, kind) < 0 ? &link->left : &link->right;
+        if (*child == old_block) {
+            *child = new_block;
+            return root;
+        }
+        parent = *child;
+    }
+}
+
+void mem_tree_size_changed(MemoryBlock* root, MemoryBlock* block) {
+    if (root == NULL) return;
+    if (root != block) {
+        MemoryTreeLink* link = &root->address_link;
+        mem_tree_size_changed(compare(block, root, MEM_TREE_BY_ADDRESS) < 0 ? link->left : link->right, block);
+    }
+    update_height(root, MEM_TREE_BY_ADDRESS);
+}
+
+MemoryBlock* mem_tree_first_fit(MemoryBlock* root, const void* addr, size_t size, size_t* visited) {
+    // Bỏ qua cả cây con khi khối lớn nhất trong đó không đủ, nên chỉ đi dọc một vài nhánh
+    if (root == NULL || root->subtree_max_size < size) return NULL;
+    if (visited != NULL) (*visited)++;
+    if ((const char*)root->start_addr >= (const char*)addr) {
+        MemoryBlock* found = mem_tree_first_fit(root->address_link.left, addr, size, visited);
+        if (found != NULL) return found;
+        if (root->size >= size) return root;
+    }
+    return mem_tree_first_fit(root->address_link.right, addr, size, visited);
+}
+
+MemoryBlock* mem_tree_ceiling_size(MemoryBlock* root, size_t size, size_t* visited) {
+    MemoryBlock* best = NULL;
+    size_t steps = 0;
+    while (root != NULL) {
+        steps++;
+        if (root->size >= size) {
+            best = root;
+            root = root->size_link.left;
+        } else {
+            root = root->size_link.right;
+        }
+    }
+    if (visited != NULL) *visited += steps;
+    return best;
+}
+
+MemoryBlock* mem_tree_max_size(MemoryBlock* root, size_t* visited) {
+    size_t steps = root != NULL;
+    while (root != NULL && root->size_link.right != NULL) {
+        root = root->size_link.right;
+        steps++;
+    }
+    if (visited != NULL) *visited += steps;
+    return root;
+}
+
+MemoryBlock* mem_tree_floor_address(MemoryBlock* root, const void* addr, size_t* visited) {
+    MemoryBlock* best = NULL;
+    size_t steps = 0;
+    while (root != NULL) {
+        steps++;
+        if ((const char*)root->start_addr <= (const char*)addr) {
+            best = root;
+            root = root->address_link.right;
+        } else {
+            root = root->address_link.left;
+        }
+    }
+    if (visited != NULL) *visited += steps;
+    return best;
+}
+
+MemoryBlock* mem_tree_ceiling_address(MemoryBlock* root, const void* addr, size_t* visited) {
+    MemoryBlock* best = NULL;
+    size_t steps = 0;
+    while (root != NULL) {
+        steps++;
+        if ((const char*)root->start_addr >= (const char*)addr) {
+            best = root;
+            root = root->address_link.left;
+        } else {
+            root = root->address_link.right;
+        }
+    }
+    if (visited != NULL) *visited += steps;
+    return best;
+}
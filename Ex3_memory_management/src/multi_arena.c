@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "multi_arena.h"
+#include "mem_log.h"
+
+// Cấp phát/giải phóng trên bộ cấp phát của arena, gọi khi đang giữ arena->lock
+static void* arena_backend_malloc(MultiArenaAllocator* allocator, MemoryArena* arena, size_t size) {
+    switch (allocator->backend) {
+        case CONCURRENT_BACKEND_FIRST_FIT: return firstfit_malloc(arena->manager, size, NULL);
+        case CONCURRENT_BACKEND_TLSF:      return tlsf_malloc(arena->tlsf, size, NULL);
+        default:                           return flat_buddy_malloc(arena->buddy, size, NULL);
+    }
+}
+
+static void arena_backend_free(MultiArenaAllocator* allocator, MemoryArena* arena, void* ptr) {
+    switch (allocator->backend) {
+        case CONCURRENT_BACKEND_FIRST_FIT: free_mem(arena->manager, ptr, NULL); break;
+        case CONCURRENT_BACKEND_TLSF:      free_tlsf(arena->tlsf, ptr, NULL); break;
+        default:                           free_flat_buddy(arena->buddy, ptr, NULL); break;
+    }
+}
+
+static void lock_arena(MemoryArena* arena) {
+    pthread_mutex_lock(&arena->lock);
+    arena->lock_acquisitions++;
+}
+
+// Lấy toàn bộ hàng đợi remote một lần và trả từng khối về bộ cấp phát, gọi khi đang giữ arena->lock
+static void drain_remote_frees(MultiArenaAllocator* allocator, MemoryArena* arena) {
+    if (atomic_load_explicit(&arena->remote_frees, memory_order_relaxed) == NULL) return;
+    void* block = atomic_exchange_explicit(&arena->remote_frees, NULL, memory_order_acquire);
+    while (block != NULL) {
+        void* next = *(void**)block;
+        arena_backend_free(allocator, arena, block);
+        arena->remote_frees_drained++;
+        block = next;
+    }
+}
+
+// Arena chứa ptr, NULL nếu ptr nằm ngoài vùng nhớ được quản lý
+static MemoryArena* arena_of(MultiArenaAllocator* allocator, void* ptr) {
+    if ((char*)ptr < allocator->base_memory_address) return NULL;
+    size_t index = (size_t)((char*)ptr - allocator->base_memory_address) / allocator->arena_size;
+    return index < (size_t)allocator->arena_count ? &allocator->arenas[index] : NULL;
+}
+
+// Hàm huỷ của pthread key: luồng kết thúc thì bỏ khỏi arena đang gán
+static void release_thread_arena(void* value) {
+    MemoryArena* arena = (MemoryArena*)value;
+    pthread_mutex_lock(&arena->lock);
+    arena->thread_count--;
+    pthread_mutex_unlock(&arena->lock);
+}
+
+static void assign_thread(MultiArenaAllocator* allocator, MemoryArena* arena) {
+    MemoryArena* previous = (MemoryArena*)pthread_getspecific(allocator->arena_key);
+    if (previous != NULL) release_thread_arena(previous);
+    pthread_mutex_lock(&arena->lock);
+    arena->thread_count++;
+    pthread_mutex_unlock(&arena->lock);
+    pthread_setspecific(allocator->arena_key, arena);
+}
+
+static MemoryArena* thread_arena(MultiArenaAllocator* allocator) {
+    MemoryArena* arena = (MemoryArena*)pthread_getspecific(allocator->arena_key);
+    if (arena != NULL) return arena;
+    unsigned int index = atomic_fetch_add_explicit(&allocator->next_arena, 1, memory_order_relaxed);
+    arena = &allocator->arenas[index % (unsigned int)allocator->arena_count];
+    assign_thread(allocator, arena);
+    return arena;
+}
+
+static void cleanup_arenas(MultiArenaAllocator* allocator, int count) {
+    for (int i = 0; i < count; i++) {
+        MemoryArena* arena = &allocator->arenas[i];
+        if (arena->manager != NULL) {
+            arena->manager->base_memory_address = NULL; // Để cleanup_memory_manager không giải phóng vùng nhớ của người gọi
+            cleanup_memory_manager(arena->manager, NULL);
+        }
+        if (arena->tlsf != NULL) cleanup_tlsf_allocator(arena->tlsf, NULL);
+        if (arena->buddy != NULL) cleanup_flat_buddy_system(arena->buddy, NULL);
+        pthread_mutex_destroy(&arena->lock);
+    }
+}
+
+MultiArenaAllocator* create_multi_arena_allocator(void* base_addr, size_t total_size, int arena_count,
+                                                  ConcurrentBackend backend, FILE* out) {
+    if (base_addr == NULL || arena_count <= 0 || (uintptr_t)base_addr % MULTI_ARENA_ALIGN != 0 ||
+        total_size / (size_t)arena_count < MULTI_ARENA_ALIGN) {
+        MEM_LOG(out, "[create_multi_arena_allocator] Lỗi: Tham số không hợp lệ.\n");
+        return NULL;
+    }
+    MultiArenaAllocator* allocator = (MultiArenaAllocator*)calloc(1, sizeof(MultiArenaAllocator));
+    MemoryArena* arenas = (MemoryArena*)aligned_alloc(_Alignof(MemoryArena), arena_count * sizeof(MemoryArena));
+    if (allocator == NULL || arenas == NULL) {
+        MEM_LOG(out, "[create_multi_arena_allocator] Lỗi: Không thể cấp phát cấu trúc quản lý.\n");
+        free(allocator);
+        free(arenas);
+        return NULL;
+    }
+    allocator->backend = backend;
+    allocator->arena_count = arena_count;
+    allocator->base_memory_address = (char*)base_addr;
+    allocator->arena_size = (total_size / (size_t)arena_count) & ~(size_t)(MULTI_ARENA_ALIGN - 1);
+    allocator->arenas = arenas;
+    atomic_init(&allocator->next_arena, 0);
+
+    for (int i = 0; i < arena_count; i++) {
+        MemoryArena* arena = &arenas[i];
+        char* arena_base = allocator->base_memory_address + (size_t)i * allocator->arena_size;
+        arena->manager = NULL;
+        arena->tlsf = NULL;
+        arena->buddy = NULL;
+        switch (backend) {
+            case CONCURRENT_BACKEND_FIRST_FIT: arena->manager = initialize_memory_manager(arena_base, allocator->arena_size, out); break;
+            case CONCURRENT_BACKEND_TLSF:      arena->tlsf = create_tlsf_allocator(arena_base, allocator->arena_size, out); break;
+            default:                           arena->buddy = create_flat_buddy_system(arena_base, allocator->arena_size, out); break;
+        }
+        pthread_mutex_init(&arena->lock, NULL);
+        atomic_init(&arena->remote_frees, NULL);
+        arena->lock_acquisitions = 0;
+        arena->remote_frees_drained = 0;
+        arena->thread_count = 0;
+        if (arena->manager == NULL && arena->tlsf == NULL && arena->buddy == NULL) {
+            MEM_LOG(out, "[create_multi_arena_allocator] Lỗi: Không thể khởi tạo arena %d.\n", i);
+            cleanup_arenas(allocator, i + 1);
+            free(arenas);
+            free(allocator);
+            return NULL;
+        }
+    }
+    if (pthread_key_create(&allocator->arena_key, release_thread_arena) != 0) {
+        MEM_LOG(out, "[create_multi_arena_allocator] Lỗi: Không thể tạo thread key.\n");
+        cleanup_arenas(allocator, arena_count);
+        free(arenas);
+        free(allocator);
+        return NULL;
+    }
+
+    MEM_LOG(out, "[create_multi_arena_allocator] Đã chia %zu bytes thành %d arena, mỗi arena %zu bytes.\n",
+            total_size, arena_count, allocator->arena_size);
+    return allocator;
+}
+
+int multi_arena_bind_thread(MultiArenaAllocator* allocator, int arena_index) {
+    if (allocator == NULL || arena_index < 0 || arena_index >= allocator->arena_count) return -1;
+    MemoryArena* arena = &allocator->arenas[arena_index];
+    if (pthread_getspecific(allocator->arena_key) != arena) assign_thread(allocator, arena);
+    return 0;
+}
+
+void* multi_arena_malloc(MultiArenaAllocator* allocator, size_t size) {
+    if (allocator == NULL || size == 0) return NULL;
+
+    MemoryArena* home = thread_arena(allocator);
+    lock_arena(home);
+    drain_remote_frees(allocator, home);
+    void* ptr = arena_backend_malloc(allocator, home, size);
+    pthread_mutex_unlock(&home->lock);
+    if (ptr != NULL) return ptr;
+
+    // Arena của luồng hết chỗ: thử các arena khác (khối vẫn thuộc arena cấp ra nó)
+    int home_index = (int)(home - allocator->arenas);
+    for (int step = 1; step < allocator->arena_count && ptr == NULL; step++) {
+        MemoryArena* arena = &allocator->arenas[(home_index + step) % allocator->arena_count];
+        lock_arena(arena);
+        drain_remote_frees(allocator, arena);
+        ptr = arena_backend_malloc(allocator, arena, size);
+        pthread_mutex_unlock(&arena->lock);
+    }
+    return ptr;
+}
+
+void multi_arena_free(MultiArenaAllocator* allocator, void* ptr) {
+    if (allocator == NULL || ptr == NULL) return;
+    MemoryArena* owner = arena_of(allocator, ptr);
+    if (owner == NULL) return;
+
+    if (owner == (MemoryArena*)pthread_getspecific(allocator->arena_key)) {
+        lock_arena(owner);
+        arena_backend_free(allocator, owner, ptr);
+        pthread_mutex_unlock(&owner->lock);
+        return;
+    }
+
+    // Remote free: đẩy vào hàng đợi của arena chủ, không khoá
+    void* head = atomic_load_explicit(&owner->remote_frees, memory_order_relaxed);
+    do {
+        *(void**)ptr = head;
+    } while (!atomic_compare_exchange_weak_explicit(&owner->remote_frees, &head, ptr,
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+void multi_arena_drain(MultiArenaAllocator* allocator) {
+    if (allocator == NULL) return;
+    for (int i = 0; i < allocator->arena_count; i++) {
+        MemoryArena* arena = &allocator->arenas[i];
+        lock_arena(arena);
+        drain_remote_frees(allocator, arena);
+        pthread_mutex_unlock(&arena->lock);
+    }
+}
+
+void cleanup_multi_arena_allocator(MultiArenaAllocator* allocator, FILE* out) {
+    if (allocator == NULL) {
+        MEM_LOG(out, "[cleanup_multi_arena_allocator] Con trỏ allocator trỏ tới NULL.\n");
+        return;
+    }
+    pthread_setspecific(allocator->arena_key, NULL);
+    pthread_key_delete(allocator->arena_key);
+    cleanup_arenas(allocator, allocator->arena_count);
+    free(allocator->arenas);
+    free(allocator);
+    MEM_LOG(out, "[cleanup_multi_arena_allocator] Đã giải phóng bộ cấp phát nhiều arena.\n");
+}
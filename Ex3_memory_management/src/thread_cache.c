@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "thread_cache.h"
+#include "mem_log.h"
+
+#define TC_LARGE_CLASS ((size_t)-1)
+
+// Cấp phát/giải phóng trên bộ cấp phát trung tâm, gọi khi đang giữ allocator->lock
+static void* central_malloc(ConcurrentAllocator* allocator, size_t size) {
+    switch (allocator->backend) {
+        case CONCURRENT_BACKEND_FIRST_FIT: return firstfit_malloc(allocator->manager, size, NULL);
+        case CONCURRENT_BACKEND_TLSF:      return tlsf_malloc(allocator->tlsf, size, NULL);
+        default:                           return flat_buddy_malloc(allocator->buddy, size, NULL);
+    }
+}
+
+static void central_free(ConcurrentAllocator* allocator, void* block) {
+    switch (allocator->backend) {
+        case CONCURRENT_BACKEND_FIRST_FIT: free_mem(allocator->manager, block, NULL); break;
+        case CONCURRENT_BACKEND_TLSF:      free_tlsf(allocator->tlsf, block, NULL); break;
+        default:                           free_flat_buddy(allocator->buddy, block, NULL); break;
+    }
+}
+
+static void lock_central(ConcurrentAllocator* allocator) {
+    pthread_mutex_lock(&allocator->lock);
+    allocator->lock_acquisitions++;
+}
+
+// Lớp kích thước nhỏ nhất chứa được size bytes cộng header, TC_CLASS_COUNT nếu quá lớn
+static int size_class(size_t size) {
+    size_t total = size + TC_HEADER_SIZE;
+    int class_index = 0;
+    while (class_index < TC_CLASS_COUNT && ((size_t)1 << (class_index + TC_MIN_CLASS_SHIFT)) < total) class_index++;
+    return class_index;
+}
+
+static size_t class_size(int class_index) { return (size_t)1 << (class_index + TC_MIN_CLASS_SHIFT); }
+
+// Trả count khối cuối của magazine về bộ cấp phát trung tâm (một lần khoá)
+static void release_blocks(ThreadCache* cache, int class_index, int count) {
+    ConcurrentAllocator* allocator = cache->owner;
+    lock_central(allocator);
+    for (int i = 0; i < count; i++) central_free(allocator, cache->magazines[class_index][--cache->counts[class_index]]);
+    pthread_mutex_unlock(&allocator->lock);
+}
+
+static void release_cache(ThreadCache* cache) {
+    for (int class_index = 0; class_index < TC_CLASS_COUNT; class_index++) {
+        if (cache->counts[class_index] > 0) release_blocks(cache, class_index, cache->counts[class_index]);
+    }
+}
+
+// Gỡ cache khỏi danh sách của bộ cấp phát, gọi khi đang giữ allocator->lock
+static void unlink_cache(ConcurrentAllocator* allocator, ThreadCache* cache) {
+    if (cache->prev != NULL) {
+        cache->prev->next = cache->next;
+    } else {
+        allocator->caches = cache->next;
+    }
+    if (cache->next != NULL) cache->next->prev = cache->prev;
+}
+
+// Hàm huỷ của pthread key: chạy khi luồng kết thúc, trả mọi khối trong cache về bộ cấp phát trung tâm
+static void destroy_thread_cache(void* value) {
+    ThreadCache* cache = (ThreadCache*)value;
+    ConcurrentAllocator* allocator = cache->owner;
+    release_cache(cache);
+    pthread_mutex_lock(&allocator->lock);
+    unlink_cache(allocator, cache);
+    pthread_mutex_unlock(&allocator->lock);
+    free(cache);
+}
+
+static ThreadCache* get_thread_cache(ConcurrentAllocator* allocator) {
+    ThreadCache* cache = (ThreadCache*)pthread_getspecific(allocator->cache_key);
+    if (cache != NULL) return cache;
+
+    cache = (ThreadCache*)calloc(1, sizeof(ThreadCache));
+    if (cache == NULL) return NULL;
+    cache->owner = allocator;
+    pthread_mutex_lock(&allocator->lock);
+    cache->next = allocator->caches;
+    if (allocator->caches != NULL) allocator->caches->prev = cache;
+    allocator->caches = cache;
+    pthread_mutex_unlock(&allocator->lock);
+    pthread_setspecific(allocator->cache_key, cache);
+    return cache;
+}
+
+static void cleanup_backend(ConcurrentAllocator* allocator) {
+    if (allocator->manager != NULL) {
+        allocator->manager->base_memory_address = NULL; // Để cleanup_memory_manager không giải phóng vùng nhớ của người gọi
+        cleanup_memory_manager(allocator->manager, NULL);
+    }
+    if (allocator->tlsf != NULL) cleanup_tlsf_allocator(allocator->tlsf, NULL);
+    if (allocator->buddy != NULL) cleanup_flat_buddy_system(allocator->buddy, NULL);
+}
+
+ConcurrentAllocator* create_concurrent_allocator(void* base_addr, size_t total_size, ConcurrentBackend backend,
+                                                 int cache_enabled, FILE* out) {
+    ConcurrentAllocator* allocator = (ConcurrentAllocator*)calloc(1, sizeof(ConcurrentAllocator));
+    if (allocator == NULL) {
+        MEM_LOG(out, "[create_concurrent_allocator] Lỗi: Không thể cấp phát cấu trúc ConcurrentAllocator.\n");
+        return NULL;
+    }
+    allocator->backend = backend;
+    allocator->cache_enabled = cache_enabled;
+
+    switch (backend) {
+        case CONCURRENT_BACKEND_FIRST_FIT: allocator->manager = initialize_memory_manager(base_addr, total_size, out); break;
+        case CONCURRENT_BACKEND_TLSF:      allocator->tlsf = create_tlsf_allocator(base_addr, total_size, out); break;
+        default:                           allocator->buddy = create_flat_buddy_system(base_addr, total_size, out); break;
+    }
+    if (allocator->manager == NULL && allocator->tlsf == NULL && allocator->buddy == NULL) {
+        MEM_LOG(out, "[create_concurrent_allocator] Lỗi: Không thể khởi tạo bộ cấp phát trung tâm.\n");
+        free(allocator);
+        return NULL;
+    }
+    if (pthread_key_create(&allocator->cache_key, destroy_thread_cache) != 0) {
+        MEM_LOG(out, "[create_concurrent_allocator] Lỗi: Không thể tạo thread key.\n");
+        cleanup_backend(allocator);
+        free(allocator);
+        return NULL;
+    }
+    pthread_mutex_init(&allocator->lock, NULL);
+
+    MEM_LOG(out, "[create_concurrent_allocator] Đã khởi tạo bộ cấp phát đa luồng, cache %s.\n", cache_enabled ? "bật" : "tắt");
+    return allocator;
+}
+
+void* concurrent_malloc(ConcurrentAllocator* allocator, size_t size) {
+    if (allocator == NULL || size == 0) return NULL;
+
+    int class_index = size_class(size);
+    ThreadCache* cache = NULL;
+    if (allocator->cache_enabled && class_index < TC_CLASS_COUNT) {
+        cache = get_thread_cache(allocator);
+    }
+
+    char* block = NULL;
+    if (cache != NULL) {
+        // Magazine rỗng: lấy nửa magazine từ bộ cấp phát trung tâm trong một lần khoá
+        if (cache->counts[class_index] == 0) {
+            lock_central(allocator);
+            for (int i = 0; i < TC_MAGAZINE_SIZE / 2; i++) {
+                void* refill = central_malloc(allocator, class_size(class_index));
+                if (refill == NULL) break;
+                cache->magazines[class_index][cache->counts[class_index]++] = refill;
+            }
+            pthread_mutex_unlock(&allocator->lock);
+        }
+        if (cache->counts[class_index] > 0) block = (char*)cache->magazines[class_index][--cache->counts[class_index]];
+    } else {
+        lock_central(allocator);
+        block = (char*)central_malloc(allocator, class_index < TC_CLASS_COUNT ? class_size(class_index) : size + TC_HEADER_SIZE);
+        pthread_mutex_unlock(&allocator->lock);
+    }
+    if (block == NULL) return NULL;
+
+    size_t header = class_index < TC_CLASS_COUNT ? (size_t)class_index : TC_LARGE_CLASS;
+    memcpy(block, &header, sizeof(header));
+    return block + TC_HEADER_SIZE;
+}
+
+void concurrent_free(ConcurrentAllocator* allocator, void* ptr) {
+    if (allocator == NULL || ptr == NULL) return;
+
+    char* block = (char*)ptr - TC_HEADER_SIZE;
+    size_t header;
+    memcpy(&header, block, sizeof(header));
+
+    ThreadCache* cache = NULL;
+    if (allocator->cache_enabled && header != TC_LARGE_CLASS) cache = get_thread_cache(allocator);
+    if (cache == NULL) {
+        lock_central(allocator);
+        central_free(allocator, block);
+        pthread_mutex_unlock(&allocator->lock);
+        return;
+    }
+
+    // Magazine đầy: trả nửa magazine về bộ cấp phát trung tâm
+    int class_index = (int)header;
+    if (cache->counts[class_index] == TC_MAGAZINE_SIZE) release_blocks(cache, class_index, TC_MAGAZINE_SIZE / 2);
+    cache->magazines[class_index][cache->counts[class_index]++] = block;
+}
+
+void flush_thread_cache(ConcurrentAllocator* allocator) {
+    if (allocator == NULL || !allocator->cache_enabled) return;
+    ThreadCache* cache = (ThreadCache*)pthread_getspecific(allocator->cache_key);
+    if (cache != NULL) release_cache(cache);
+}
+
+void cleanup_concurrent_allocator(ConcurrentAllocator* allocator, FILE* out) {
+    if (allocator == NULL) {
+        MEM_LOG(out, "[cleanup_concurrent_allocator] Con trỏ allocator trỏ tới NULL.\n");
+        return;
+    }
+
+    // Các luồng khác đã kết thúc nên chỉ còn cache của luồng hiện tại (hoặc cache chưa được huỷ)
+    pthread_setspecific(allocator->cache_key, NULL);
+    while (allocator->caches != NULL) {
+        ThreadCache* cache = allocator->caches;
+        allocator->caches = cache->next;
+        free(cache);
+    }
+    pthread_key_delete(allocator->cache_key);
+    pthread_mutex_destroy(&allocator->lock);
+
+    cleanup_backend(allocator);
+    free(allocator);
+    MEM_LOG(out, "[cleanup_concurrent_allocator] Đã giải phóng bộ cấp phát đa luồng.\n");
+}
@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "tlsf_alloc.h"
+#include "mem_log.h"
+
+#define BLOCK_HEADER_SIZE offsetof(TLSFBlock, next_free)   // prev_phys + size
+#define BLOCK_MIN_SIZE (sizeof(TLSFBlock) - BLOCK_HEADER_SIZE) // Đủ chỗ cho next_free/prev_free
+#define BLOCK_MAX_SIZE (((size_t)1 << TLSF_FL_MAX) - 1)
+#define SMALL_BLOCK_SIZE ((size_t)1 << TLSF_FL_SHIFT)
+
+#define BLOCK_FREE_BIT ((size_t)1)
+#define BLOCK_PREV_FREE_BIT ((size_t)2)
+#define BLOCK_FLAG_MASK (BLOCK_FREE_BIT | BLOCK_PREV_FREE_BIT)
+
+static int msb64(size_t x) { return 63 - __builtin_clzll(x); }
+
+static size_t block_size(const TLSFBlock* block) { return block->size & ~BLOCK_FLAG_MASK; }
+static void set_block_size(TLSFBlock* block, size_t size) { block->size = size | (block->size & BLOCK_FLAG_MASK); }
+static int block_is_free(const TLSFBlock* block) { return (block->size & BLOCK_FREE_BIT) != 0; }
+static int block_prev_is_free(const TLSFBlock* block) { return (block->size & BLOCK_PREV_FREE_BIT) != 0; }
+
+static void* block_to_ptr(TLSFBlock* block) { return (char*)block + BLOCK_HEADER_SIZE; }
+static TLSFBlock* ptr_to_block(void* ptr) { return (TLSFBlock*)((char*)ptr - BLOCK_HEADER_SIZE); }
+static TLSFBlock* next_phys(TLSFBlock* block) {
+    return (TLSFBlock*)((char*)block_to_ptr(block) + block_size(block));
+}
+
+// Đánh dấu khối trống/bận và cập nhật cờ "khối liền trước trống" của khối liền sau
+static void mark_block(TLSFBlock* block, int free) {
+    TLSFBlock* next = next_phys(block);
+    if (free) {
+        block->size |= BLOCK_FREE_BIT;
+        next->size |= BLOCK_PREV_FREE_BIT;
+    } else {
+        block->size &= ~BLOCK_FREE_BIT;
+        next->size &= ~BLOCK_PREV_FREE_BIT;
+    }
+    next->prev_phys = block;
+}
+
+// Lớp (fl, sl) chứa khối có kích thước size
+static void mapping_insert(size_t size, int* fl, int* sl) {
+    if (size < SMALL_BLOCK_SIZE) {
+        *fl = 0;
+        *sl = (int)(size / (SMALL_BLOCK_SIZE / TLSF_SL_COUNT));
+    } else {
+        int f = msb64(size);
+        *sl = (int)((size >> (f - TLSF_SL_COUNT_LOG2)) ^ TLSF_SL_COUNT);
+        *fl = f - (TLSF_FL_SHIFT - 1);
+    }
+}
+
+// Lớp nhỏ nhất mà mọi khối trong đó đều >= size: làm tròn size lên cận trên của lớp chứa nó
+static void mapping_search(size_t size, int* fl, int* sl) {
+    if (size >= SMALL_BLOCK_SIZE) {
+        size += ((size_t)1 << (msb64(size) - TLSF_SL_COUNT_LOG2)) - 1;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+static void insert_free_block(TLSFAllocator* allocator, TLSFBlock* block) {
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    TLSFBlock* head = allocator->blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = NULL;
+    if (head != NULL) head->prev_free = block;
+    allocator->blocks[fl][sl] = block;
+    allocator->fl_bitmap |= 1u << fl;
+    allocator->sl_bitmap[fl] |= 1u << sl;
+    allocator->free_memory_size += block_size(block);
+    allocator->free_block_count++;
+}
+
+static void remove_free_block(TLSFAllocator* allocator, TLSFBlock* block) {
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    if (block->prev_free != NULL) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        allocator->blocks[fl][sl] = block->next_free;
+        if (block->next_free == NULL) {
+            allocator->sl_bitmap[fl] &= ~(1u << sl);
+            if (allocator->sl_bitmap[fl] == 0) allocator->fl_bitmap &= ~(1u << fl);
+        }
+    }
+    if (block->next_free != NULL) block->next_free->prev_free = block->prev_free;
+    allocator->free_memory_size -= block_size(block);
+    allocator->free_block_count--;
+}
+
+// Khối trống đầu tiên thuộc lớp (fl, sl) hoặc lớp lớn hơn gần nhất
+static TLSFBlock* find_suitable_block(TLSFAllocator* allocator, int fl, int sl) {
+    uint32_t sl_map = allocator->sl_bitmap[fl] & (~0u << sl);
+    if (sl_map == 0) {
+        uint32_t fl_map = (uint32_t)(allocator->fl_bitmap & (~0ULL << (fl + 1)));
+        if (fl_map == 0) return NULL;
+        fl = __builtin_ctz(fl_map);
+        sl_map = allocator->sl_bitmap[fl];
+    }
+    return allocator->blocks[fl][__builtin_ctz(sl_map)];
+}
+
+TLSFAllocator* create_tlsf_allocator(void* base_addr, size_t total_size, FILE* out) {
+    if (base_addr == NULL) {
+        MEM_LOG(out, "[create_tlsf_allocator] Lỗi: Tham số khởi tạo không hợp lệ.\n");
+        return NULL;
+    }
+
+    // Căn địa chỉ đầu/cuối theo TLSF_ALIGN_SIZE; cần chỗ cho một khối đầu tiên và header của khối canh cuối
+    uintptr_t start = ((uintptr_t)base_addr + TLSF_ALIGN_SIZE - 1) & ~(uintptr_t)(TLSF_ALIGN_SIZE - 1);
+    uintptr_t end = ((uintptr_t)base_addr + total_size) & ~(uintptr_t)(TLSF_ALIGN_SIZE - 1);
+    if (end <= start || end - start < 2 * BLOCK_HEADER_SIZE + BLOCK_MIN_SIZE ||
+        end - start - 2 * BLOCK_HEADER_SIZE > BLOCK_MAX_SIZE) {
+        MEM_LOG(out, "[create_tlsf_allocator] Lỗi: Kích thước vùng nhớ %zu bytes không hợp lệ.\n", total_size);
+        return NULL;
+    }
+
+    TLSFAllocator* allocator = (TLSFAllocator*)calloc(1, sizeof(TLSFAllocator));
+    if (allocator == NULL) {
+        MEM_LOG(out, "[create_tlsf_allocator] Lỗi: Không thể cấp phát cấu trúc TLSFAllocator.\n");
+        return NULL;
+    }
+    allocator->base_memory_address = base_addr;
+    allocator->total_memory_size = total_size;
+    allocator->last_memory_address = (char*)base_addr + total_size;
+
+    // Khối canh cuối có kích thước 0 và luôn bận, nên next_phys của khối cuối cùng luôn hợp lệ
+    TLSFBlock* block = (TLSFBlock*)start;
+    block->prev_phys = NULL;
+    block->size = end - start - 2 * BLOCK_HEADER_SIZE;
+    TLSFBlock* sentinel = next_phys(block);
+    sentinel->size = 0;
+    mark_block(block, 1);
+    insert_free_block(allocator, block);
+
+    MEM_LOG(out, "[create_tlsf_allocator] Vùng nhớ %p, kích thước %zu bytes, khối trống ban đầu %zu bytes.\n",
+            base_addr, total_size, block_size(block));
+    return allocator;
+}
+
+void* tlsf_malloc(TLSFAllocator* allocator, size_t size, FILE* out) {
+    if (allocator == NULL) {
+        MEM_LOG(out, "[tlsf_malloc] Lỗi: Con trỏ allocator là NULL.\n");
+        return NULL;
+    }
+    if (size == 0 || size > BLOCK_MAX_SIZE / 2) {
+        MEM_LOG(out, "[tlsf_malloc] Kích thước khối nhớ xin cấp phát không hợp lệ.\n");
+        return NULL;
+    }
+
+    size_t adjusted = (size + TLSF_ALIGN_SIZE - 1) & ~(size_t)(TLSF_ALIGN_SIZE - 1);
+    if (adjusted < BLOCK_MIN_SIZE) adjusted = BLOCK_MIN_SIZE;
+
+    int fl, sl;
+    mapping_search(adjusted, &fl, &sl);
+    TLSFBlock* block = fl < TLSF_FL_COUNT ? find_suitable_block(allocator, fl, sl) : NULL;
+    if (block == NULL) {
+        MEM_LOG(out, "[tlsf_malloc] Không tồn tại vùng trống tự do đáp ứng yêu cầu (%zu bytes).\n", size);
+        return NULL;
+    }
+    remove_free_block(allocator, block);
+
+    // Phần dư đủ chứa một khối trống thì tách ra và trả lại vào lớp tương ứng
+    size_t remaining = block_size(block) - adjusted;
+    if (remaining >= BLOCK_HEADER_SIZE + BLOCK_MIN_SIZE) {
+        set_block_size(block, adjusted);
+        TLSFBlock* rest = next_phys(block);
+        rest->size = remaining - BLOCK_HEADER_SIZE;
+        mark_block(rest, 1);
+        insert_free_block(allocator, rest);
+    }
+    mark_block(block, 0);
+    allocator->allocated_memory_size += block_size(block);
+
+    void* allocated_addr = block_to_ptr(block);
+    MEM_LOG(out, "[tlsf_malloc] Cấp phát %zu bytes (khối %zu bytes) tại địa chỉ %p.\n", size, block_size(block), allocated_addr);
+    return allocated_addr;
+}
+
+void free_tlsf(TLSFAllocator* allocator, void* ptr, FILE* out) {
+    if (allocator == NULL) {
+        MEM_LOG(out, "[free_tlsf] Lỗi: Con trỏ allocator là NULL.\n");
+        return;
+    }
+    if (ptr == NULL) {
+        MEM_LOG(out, "[free_tlsf] Không thể giải phóng địa chỉ NULL.\n");
+        return;
+    }
+    if ((char*)ptr < (char*)allocator->base_memory_address + BLOCK_HEADER_SIZE || ptr >= allocator->last_memory_address ||
+        (uintptr_t)ptr % TLSF_ALIGN_SIZE != 0) {
+        MEM_LOG(out, "[free_tlsf] Địa chỉ %p nằm ngoài vùng bộ nhớ được quản lý hoặc không thẳng hàng.\n", ptr);
+        return;
+    }
+
+    TLSFBlock* block = ptr_to_block(ptr);
+    if (block_is_free(block) || block_size(block) == 0) {
+        MEM_LOG(out, "[free_tlsf] Địa chỉ %p không phải một khối đang được cấp phát.\n", ptr);
+        return;
+    }
+    size_t freed = block_size(block);
+    allocator->allocated_memory_size -= freed;
+
+    // Gộp với khối liền trước và liền sau nếu chúng trống
+    if (block_prev_is_free(block)) {
+        TLSFBlock* prev = block->prev_phys;
+        remove_free_block(allocator, prev);
+        set_block_size(prev, block_size(prev) + BLOCK_HEADER_SIZE + block_size(block));
+        block = prev;
+    }
+    TLSFBlock* next = next_phys(block);
+    if (block_is_free(next)) {
+        remove_free_block(allocator, next);
+        set_block_size(block, block_size(block) + BLOCK_HEADER_SIZE + block_size(next));
+    }
+    mark_block(block, 1);
+    insert_free_block(allocator, block);
+
+    MEM_LOG(out, "[free_tlsf] Đã giải phóng %zu bytes tại địa chỉ %p, khối trống sau khi gộp: %zu bytes.\n",
+            freed, ptr, block_size(block));
+}
+
+// Khối đầu tiên trong vùng nhớ (ngay sau địa chỉ đầu đã căn)
+static TLSFBlock* first_block(TLSFAllocator* allocator) {
+    uintptr_t start = ((uintptr_t)allocator->base_memory_address + TLSF_ALIGN_SIZE - 1) & ~(uintptr_t)(TLSF_ALIGN_SIZE - 1);
+    return (TLSFBlock*)start;
+}
+
+void tlsf_get_stats(TLSFAllocator* allocator, TLSFStats* stats) {
+    if (allocator == NULL || stats == NULL) return;
+    stats->free_bytes = allocator->free_memory_size;
+    stats->free_blocks = allocator->free_block_count;
+    stats->largest_free_block = 0;
+
+    // Khối trống lớn nhất nằm trong lớp khác rỗng cao nhất; duyệt danh sách của lớp đó
+    if (allocator->fl_bitmap != 0) {
+        int fl = msb64(allocator->fl_bitmap);
+        int sl = msb64(allocator->sl_bitmap[fl]);
+        for (TLSFBlock* block = allocator->blocks[fl][sl]; block != NULL; block = block->next_free) {
+            if (block_size(block) > stats->largest_free_block) stats->largest_free_block = block_size(block);
+        }
+    }
+    stats->fragmentation = stats->free_bytes == 0 ? 0.0 : 1.0 - (double)stats->largest_free_block / stats->free_bytes;
+}
+
+void print_tlsf_allocator(TLSFAllocator* allocator, FILE* out) {
+    if (allocator == NULL) {
+        MEM_LOG(out, "[print_tlsf_allocator] Lỗi: Con trỏ allocator là NULL.\n");
+        return;
+    }
+    MEM_LOG(out, "\n================= TLSF Allocator =================\n");
+    MEM_LOG(out, "Kích thước vùng bộ nhớ quản lý: %zu bytes, Đã cấp phát: %zu bytes\n",
+            allocator->total_memory_size, allocator->allocated_memory_size);
+
+    int i = 0;
+    for (TLSFBlock* block = first_block(allocator); block_size(block) != 0; block = next_phys(block)) {
+        if (!block_is_free(block)) continue;
+        MEM_LOG(out, "Block %d: Start Addr: %p, Size: %zu bytes\n", i++, block_to_ptr(block), block_size(block));
+    }
+
+    TLSFStats stats;
+    tlsf_get_stats(allocator, &stats);
+    MEM_LOG(out, "Vùng trống: %zu bytes trong %zu khối, khối lớn nhất: %zu bytes, phân mảnh: %.1f%%\n",
+            stats.free_bytes, stats.free_blocks, stats.largest_free_block, stats.fragmentation * 100.0);
+    MEM_LOG(out, "==================================================\n\n");
+}
+
+void cleanup_tlsf_allocator(TLSFAllocator* allocator, FILE* out) {
+    if (allocator == NULL) {
+        MEM_LOG(out, "[cleanup_tlsf_allocator] Con trỏ allocator trỏ tới NULL.\n");
+        return;
+    }
+    free(allocator);
+    MEM_LOG(out, "[cleanup_tlsf_allocator] Đã giải phóng cấu trúc quản lý TLSF.\n");
+}
@@ -0,0 +1,106 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "cache.hpp"
+
+// Compares the runtime Cache (strategy passed to every put, switch on eviction) with the compile-time
+// cache::Cache<Key, Value, Policy> on the same operation stream: 80% get / 20% put over a key space
+// four times the capacity, skewed so that a quarter of the keys receive most accesses.
+// Usage: ./cache_bench [operations] [capacity]
+
+namespace {
+
+struct Operation {
+    bool is_put;
+    int key;
+};
+
+std::vector<Operation> makeOperations(int count, int capacity) {
+    std::vector<Operation> operations(static_cast<std::size_t>(count));
+    unsigned int seed = 12345;
+    int key_space = capacity * 4;
+    for (auto& operation : operations) {
+        seed = seed * 1103515245u + 12345u;
+        operation.is_put = (seed >> 8) % 5 == 0;
+        seed = seed * 1103515245u + 12345u;
+        int hot = (seed >> 4) % 4 != 0; // 3 of 4 accesses go to the hot quarter of the keys
+        seed = seed * 1103515245u + 12345u;
+        operation.key = static_cast<int>((seed >> 8) % static_cast<unsigned int>(hot ? key_space / 4 : key_space));
+    }
+    return operations;
+}
+
+// Values are short strings (inside the small-string buffer), as in main.cpp
+std::vector<std::string> makeValues(int capacity) {
+    std::vector<std::string> values;
+    for (int key = 0; key < capacity * 4; key++) values.push_back("value" + std::to_string(key));
+    return values;
+}
+
+double nowMs() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void report(const char* implementation, const char* policy, int operations, long hits, double elapsed) {
+    std::printf("%-14s %-6s %12.1f %14.0f %10.4f\n", implementation, policy, elapsed * 1e6 / operations,
+                operations / elapsed * 1e3, static_cast<double>(hits) / operations);
+}
+
+void runRuntime(CacheStrategy strategy, const char* name, const std::vector<Operation>& operations,
+                const std::vector<std::string>& values, int capacity) {
+    Cache cache(capacity);
+    long hits = 0;
+    double start = nowMs();
+    for (const auto& operation : operations) {
+        if (operation.is_put) {
+            cache.put(operation.key, values[static_cast<std::size_t>(operation.key)], strategy);
+        } else if (!cache.get(operation.key).empty()) {
+            hits++;
+        }
+    }
+    report("runtime switch", name, static_cast<int>(operations.size()), hits, nowMs() - start);
+}
+
+template <typename Policy>
+void runTemplate(const char* name, const std::vector<Operation>& operations, const std::vector<std::string>& values,
+                 int capacity) {
+    cache::Cache<int, std::string, Policy> cache(capacity);
+    long hits = 0;
+    double start = nowMs();
+    for (const auto& operation : operations) {
+        if (operation.is_put) {
+            cache.put(operation.key, values[static_cast<std::size_t>(operation.key)]);
+        } else if (cache.get(operation.key) != nullptr) {
+            hits++;
+        }
+    }
+    report("template", name, static_cast<int>(operations.size()), hits, nowMs() - start);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int operation_count = argc > 1 ? std::atoi(argv[1]) : 2000000;
+    int capacity = argc > 2 ? std::atoi(argv[2]) : 1024;
+    if (operation_count <= 0 || capacity <= 0) {
+        std::printf("Usage: %s [operations] [capacity]\n", argv[0]);
+        return 1;
+    }
+
+    auto operations = makeOperations(operation_count, capacity);
+    auto values = makeValues(capacity);
+    // MFU scans every entry on each eviction in both implementations, so it runs on a tenth of the stream
+    std::vector<Operation> mfu_operations(operations.begin(), operations.begin() + operation_count / 10 + 1);
+
+    std::printf("Operations: %d | Capacity: %d | Keys: %d | 80%% get / 20%% put\n\n", operation_count, capacity, capacity * 4);
+    std::printf("%-14s %-6s %12s %14s %10s\n", "Cache", "Policy", "ns/op", "ops/sec", "hit rate");
+    runRuntime(CacheStrategy::LRU, "LRU", operations, values, capacity);
+    runTemplate<cache::LRUPolicy>("LRU", operations, values, capacity);
+    runRuntime(CacheStrategy::MRU, "MRU", operations, values, capacity);
+    runTemplate<cache::MRUPolicy>("MRU", operations, values, capacity);
+    runRuntime(CacheStrategy::MFU, "MFU", mfu_operations, values, capacity);
+    runTemplate<cache::MFUPolicy>("MFU", mfu_operations, values, capacity);
+    return 0;
+}
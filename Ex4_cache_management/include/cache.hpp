@@ -8,6 +8,10 @@
 #include <string>
 #include <chrono>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
 
 constexpr size_t MAX_LEN = 256;
 
@@ -80,6 +84,164 @@ public:
     void printCache() const;
 };
 
+// Compile-time configurable cache: the eviction policy and hash are template parameters, so get/put
+// carry no strategy argument and no switch, and the policy's victim selection inlines into put.
+// Entries live in one contiguous vector (slots are reused on eviction) and are linked by index in
+// recency order (head = most recently used), so there is no per-node allocation or shared_ptr refcounting.
+// Frequencies and the MFU tie-break follow the runtime Cache; timestamps are a per-cache access counter.
+namespace cache {
+
+// Evicts the least recently used entry
+struct LRUPolicy {
+    template <typename CacheType>
+    static std::size_t victim(const CacheType& cache) { return cache.tail_; }
+};
+
+// Evicts the most recently used entry
+struct MRUPolicy {
+    template <typename CacheType>
+    static std::size_t victim(const CacheType& cache) { return cache.head_; }
+};
+
+// Evicts the most frequently used entry, the one accessed longest ago on ties
+struct MFUPolicy {
+    template <typename CacheType>
+    static std::size_t victim(const CacheType& cache) {
+        std::size_t chosen = CacheType::npos;
+        for (std::size_t i = 0; i < cache.entries_.size(); i++) {
+            const auto& entry = cache.entries_[i];
+            if (chosen == CacheType::npos || entry.frequency > cache.entries_[chosen].frequency ||
+                (entry.frequency == cache.entries_[chosen].frequency &&
+                 entry.timestamp < cache.entries_[chosen].timestamp)) {
+                chosen = i;
+            }
+        }
+        return chosen;
+    }
+};
+
+template <typename Key, typename Value, typename EvictionPolicy = LRUPolicy, typename Hash = std::hash<Key>>
+class Cache {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    explicit Cache(int capacity) : capacity_(capacity) {
+        if (capacity <= 0) {
+            throw std::invalid_argument("Cache capacity must be positive");
+        }
+        entries_.reserve(static_cast<std::size_t>(capacity));
+        index_.reserve(static_cast<std::size_t>(capacity));
+    }
+
+    Cache(const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
+    Cache(Cache&&) = default;
+    Cache& operator=(Cache&&) = default;
+
+    // Returns the cached value, or nullptr if key is absent. The pointer is valid until the next put or clear.
+    Value* get(const Key& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) return nullptr;
+        Entry& entry = entries_[it->second];
+        entry.frequency++;
+        entry.timestamp = ++clock_;
+        moveToHead(it->second);
+        return &entry.value;
+    }
+
+    void put(const Key& key, const Value& value) {
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            Entry& entry = entries_[it->second];
+            entry.value = value;
+            entry.frequency++;
+            entry.timestamp = ++clock_;
+            moveToHead(it->second);
+            return;
+        }
+
+        std::size_t slot;
+        if (entries_.size() < static_cast<std::size_t>(capacity_)) {
+            slot = entries_.size();
+            entries_.push_back(Entry{key, value, npos, npos, 1, ++clock_});
+        } else {
+            // Full: the new entry takes over the victim's slot
+            slot = EvictionPolicy::victim(*this);
+            index_.erase(entries_[slot].key);
+            unlink(slot);
+            Entry& entry = entries_[slot];
+            entry.key = key;
+            entry.value = value;
+            entry.frequency = 1;
+            entry.timestamp = ++clock_;
+        }
+        linkAtHead(slot);
+        index_.emplace(key, slot);
+    }
+
+    void clear() {
+        entries_.clear();
+        index_.clear();
+        head_ = npos;
+        tail_ = npos;
+    }
+
+    int getSize() const { return static_cast<int>(entries_.size()); }
+    int getCapacity() const { return capacity_; }
+    bool isEmpty() const { return entries_.empty(); }
+    bool isFull() const { return getSize() == capacity_; }
+
+private:
+    friend EvictionPolicy;
+
+    struct Entry {
+        Key key;
+        Value value;
+        std::size_t prev;
+        std::size_t next;
+        std::uint64_t frequency;
+        std::uint64_t timestamp;
+    };
+
+    void linkAtHead(std::size_t slot) {
+        Entry& entry = entries_[slot];
+        entry.prev = npos;
+        entry.next = head_;
+        if (head_ != npos) entries_[head_].prev = slot;
+        head_ = slot;
+        if (tail_ == npos) tail_ = slot;
+    }
+
+    void unlink(std::size_t slot) {
+        Entry& entry = entries_[slot];
+        if (entry.prev != npos) {
+            entries_[entry.prev].next = entry.next;
+        } else {
+            head_ = entry.next;
+        }
+        if (entry.next != npos) {
+            entries_[entry.next].prev = entry.prev;
+        } else {
+            tail_ = entry.prev;
+        }
+    }
+
+    void moveToHead(std::size_t slot) {
+        if (slot == head_) return;
+        unlink(slot);
+        linkAtHead(slot);
+    }
+
+    int capacity_;
+    std::vector<Entry> entries_;
+    std::unordered_map<Key, std::size_t, Hash> index_;
+    std::size_t head_ = npos;
+    std::size_t tail_ = npos;
+    std::uint64_t clock_ = 0;
+};
+
+} // namespace cache
+
 // // Legacy C-style interface for backward compatibility
 // extern "C" {
 //     struct LRUCache;